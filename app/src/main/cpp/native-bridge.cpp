@@ -1,13 +1,181 @@
 #include <jni.h>
+#include <algorithm>
 #include <string>
+#include <vector>
+#include <mutex>
 #include <android/log.h>
+#include <dlfcn.h>
 #include <unistd.h>
+#include <sys/auxv.h>
 #include <sys/sysconf.h>
 
+#include "xmrig_bridge.h"
+
 #define LOG_TAG "XMRigBridge"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+// CPU features, from the kernel's HWCAP words (bits in <asm/hwcap.h>)
+enum CpuFeature : uint32_t {
+    kCpuAes     = 1u << 0,
+    kCpuPmull   = 1u << 1,
+    kCpuSha1    = 1u << 2,
+    kCpuSha2    = 1u << 3,
+    kCpuLse     = 1u << 4, // ARMv8.1 atomics
+    kCpuRdm     = 1u << 5, // ARMv8.1 rounding doubling multiply
+    kCpuDotProd = 1u << 6,
+    kCpuSve     = 1u << 7,
+    kCpuSve2    = 1u << 8
+};
+
+static const struct {
+    uint32_t feature;
+    const char* name;
+} kCpuFeatureNames[] = {
+    { kCpuAes, "aes" }, { kCpuPmull, "pmull" }, { kCpuSha1, "sha1" }, { kCpuSha2, "sha2" },
+    { kCpuLse, "lse" }, { kCpuRdm, "rdm" }, { kCpuDotProd, "dotprod" }, { kCpuSve, "sve" },
+    { kCpuSve2, "sve2" }
+};
+
+static uint32_t detectCpuFeatures() {
+    uint32_t features = 0;
+
+#ifdef __aarch64__
+    // Values from the arm64 uapi; spelled out for older NDK headers
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+
+    if (hwcap & (1UL << 3)) features |= kCpuAes;      // HWCAP_AES
+    if (hwcap & (1UL << 4)) features |= kCpuPmull;    // HWCAP_PMULL
+    if (hwcap & (1UL << 5)) features |= kCpuSha1;     // HWCAP_SHA1
+    if (hwcap & (1UL << 6)) features |= kCpuSha2;     // HWCAP_SHA2
+    if (hwcap & (1UL << 8)) features |= kCpuLse;      // HWCAP_ATOMICS
+    if (hwcap & (1UL << 12)) features |= kCpuRdm;     // HWCAP_ASIMDRDM
+    if (hwcap & (1UL << 20)) features |= kCpuDotProd; // HWCAP_ASIMDDP
+    if (hwcap & (1UL << 22)) features |= kCpuSve;     // HWCAP_SVE
+    if (hwcap2 & (1UL << 1)) features |= kCpuSve2;    // HWCAP2_SVE2
+#endif
+
+    return features;
+}
+
+static uint32_t cpuFeatures() {
+    static const uint32_t features = detectCpuFeatures();
+    return features;
+}
+
+// libxmrig builds from scripts/build_xmrig.sh, fastest first. A variant is
+// only loaded when the CPU has every feature its -march may emit.
+static const struct {
+    const char* library;
+    uint32_t required;
+} kCoreVariants[] = {
+    { "libxmrig-armv82.so", kCpuAes | kCpuPmull | kCpuSha1 | kCpuSha2 | kCpuLse | kCpuRdm }, // armv8.2-a+crypto
+    { "libxmrig-crypto.so", kCpuAes | kCpuPmull | kCpuSha1 | kCpuSha2 },                     // armv8-a+crypto
+    { "libxmrig.so", 0 }                                                                     // armv8-a
+};
+
+// xmrig_bridge C API, resolved from libxmrig.so at runtime so the app still
+// builds and starts when the core library is missing for an ABI
+struct XMRigApi {
+    decltype(&xmrig_set_storage_path_v8) setStoragePath;
+    decltype(&xmrig_set_rx_cache_v8) setRxCache;
+    decltype(&xmrig_init_v8) init;
+    decltype(&xmrig_start_v8) start;
+    decltype(&xmrig_stop_v8) stop;
+    decltype(&xmrig_is_running_v8) isRunning;
+    decltype(&xmrig_pause_v8) pause;
+    decltype(&xmrig_resume_v8) resume;
+    decltype(&xmrig_set_threads_v8) setThreads;
+    decltype(&xmrig_get_stats_v8) getStats;
+    decltype(&xmrig_get_stats_page_v8) getStatsPage;
+    decltype(&xmrig_version_v8) version;
+    decltype(&xmrig_benchmark_v8) benchmark;
+    decltype(&xmrig_set_governor_v8) setGovernor;
+    decltype(&xmrig_report_sensors_v8) reportSensors;
+    decltype(&xmrig_get_governor_state_v8) getGovernorState;
+    decltype(&xmrig_get_thread_stats_v8) getThreadStats;
+    decltype(&xmrig_get_history_v8) getHistory;
+    decltype(&xmrig_clear_history_v8) clearHistory;
+    decltype(&xmrig_get_startup_report_v8) getStartupReport;
+};
+
+static std::mutex g_api_mutex;
+static void* g_core = nullptr;
+static const char* g_core_variant = nullptr;
+static XMRigApi g_api = {};
+
+template<typename T>
+static bool resolve(void* handle, const char* name, T& fn) {
+    fn = reinterpret_cast<T>(dlsym(handle, name));
+    if (!fn) {
+        LOGE("libxmrig does not export %s", name);
+    }
+    return fn != nullptr;
+}
+
+static bool openCore(const char* library) {
+    void* handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        LOGI("Cannot load %s: %s", library, dlerror());
+        return false;
+    }
+
+    XMRigApi api = {};
+    const bool ok = resolve(handle, "xmrig_set_storage_path_v8", api.setStoragePath) &&
+                    resolve(handle, "xmrig_set_rx_cache_v8", api.setRxCache) &&
+                    resolve(handle, "xmrig_init_v8", api.init) &&
+                    resolve(handle, "xmrig_start_v8", api.start) &&
+                    resolve(handle, "xmrig_stop_v8", api.stop) &&
+                    resolve(handle, "xmrig_is_running_v8", api.isRunning) &&
+                    resolve(handle, "xmrig_pause_v8", api.pause) &&
+                    resolve(handle, "xmrig_resume_v8", api.resume) &&
+                    resolve(handle, "xmrig_set_threads_v8", api.setThreads) &&
+                    resolve(handle, "xmrig_get_stats_v8", api.getStats) &&
+                    resolve(handle, "xmrig_get_stats_page_v8", api.getStatsPage) &&
+                    resolve(handle, "xmrig_version_v8", api.version) &&
+                    resolve(handle, "xmrig_benchmark_v8", api.benchmark) &&
+                    resolve(handle, "xmrig_set_governor_v8", api.setGovernor) &&
+                    resolve(handle, "xmrig_report_sensors_v8", api.reportSensors) &&
+                    resolve(handle, "xmrig_get_governor_state_v8", api.getGovernorState) &&
+                    resolve(handle, "xmrig_get_thread_stats_v8", api.getThreadStats) &&
+                    resolve(handle, "xmrig_get_history_v8", api.getHistory) &&
+                    resolve(handle, "xmrig_clear_history_v8", api.clearHistory) &&
+                    resolve(handle, "xmrig_get_startup_report_v8", api.getStartupReport);
+
+    if (!ok) {
+        dlclose(handle);
+        return false;
+    }
+
+    // Never unloaded: worker threads may outlive a stop request
+    g_api = api;
+    g_core = handle;
+    g_core_variant = library;
+    LOGI("Loaded XMRig core %s from %s", g_api.version(), library);
+    return true;
+}
+
+static bool loadCore() {
+    std::lock_guard<std::mutex> lock(g_api_mutex);
+    if (g_core) return true;
+
+    const uint32_t features = cpuFeatures();
+    for (const auto& variant : kCoreVariants) {
+        if ((features & variant.required) == variant.required && openCore(variant.library)) {
+            return true;
+        }
+    }
+
+    LOGE("No usable libxmrig variant (cpu features 0x%x)", features);
+    return false;
+}
+
+static bool isLoaded() {
+    std::lock_guard<std::mutex> lock(g_api_mutex);
+    return g_core != nullptr;
+}
+
 extern "C" {
 
 JNIEXPORT jstring JNICALL
@@ -15,6 +183,9 @@ Java_com_iml1s_xmrigminer_native_XMRigBridge_getVersion(
     JNIEnv* env,
     jobject /* this */) {
     LOGI("Getting XMRig version");
+    if (isLoaded()) {
+        return env->NewStringUTF((std::string("XMRig ") + g_api.version() + " (Android Custom Build)").c_str());
+    }
     return env->NewStringUTF("XMRig 6.21.0 (Android Custom Build)");
 }
 
@@ -42,6 +213,14 @@ Java_com_iml1s_xmrigminer_native_XMRigBridge_getCpuInfo(
     #else
         info += ", Arch: Unknown";
     #endif
+
+    std::string features;
+    for (const auto& entry : kCpuFeatureNames) {
+        if (cpuFeatures() & entry.feature) {
+            features += features.empty() ? entry.name : std::string(" ") + entry.name;
+        }
+    }
+    info += ", Features: " + (features.empty() ? std::string("none") : features);
     
     LOGI("CPU Info: %s", info.c_str());
     return env->NewStringUTF(info.c_str());
@@ -51,12 +230,424 @@ JNIEXPORT jboolean JNICALL
 Java_com_iml1s_xmrigminer_native_XMRigBridge_hasCryptoExtensions(
     JNIEnv* env,
     jobject /* this */) {
-    #ifdef __aarch64__
-        // ARM64 通常支持加密擴展
-        return JNI_TRUE;
-    #else
-        return JNI_FALSE;
-    #endif
+    // AES + PMULL is what the +crypto builds of XMRig rely on
+    const uint32_t crypto = kCpuAes | kCpuPmull;
+    return (cpuFeatures() & crypto) == crypto ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getCpuFeatures(
+    JNIEnv* env,
+    jobject /* this */) {
+    return static_cast<jint>(cpuFeatures());
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_loadCore(
+    JNIEnv* env,
+    jobject /* this */) {
+    return loadCore() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getCoreVariant(
+    JNIEnv* env,
+    jobject /* this */) {
+    std::lock_guard<std::mutex> lock(g_api_mutex);
+    return g_core_variant ? env->NewStringUTF(g_core_variant) : nullptr;
+}
+
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_setStoragePath(
+    JNIEnv* env,
+    jobject /* this */,
+    jstring path) {
+    if (!isLoaded() || !path) return;
+
+    const char* cPath = env->GetStringUTFChars(path, nullptr);
+    g_api.setStoragePath(cPath);
+    env->ReleaseStringUTFChars(path, cPath);
+}
+
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_setRxCache(
+    JNIEnv* env,
+    jobject /* this */,
+    jlong budgetBytes) {
+    if (!isLoaded()) return;
+    g_api.setRxCache(budgetBytes > 0 ? static_cast<uint64_t>(budgetBytes) : 0);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_init(
+    JNIEnv* env,
+    jobject /* this */,
+    jstring configJson) {
+    if (!isLoaded() || !configJson) return -1;
+
+    const char* config = env->GetStringUTFChars(configJson, nullptr);
+    const int result = g_api.init(config);
+    env->ReleaseStringUTFChars(configJson, config);
+
+    LOGI("xmrig_init_v8 returned %d", result);
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_start(
+    JNIEnv* env,
+    jobject /* this */) {
+    if (!isLoaded()) return -1;
+
+    const int result = g_api.start();
+    LOGI("xmrig_start_v8 returned %d", result);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_stop(
+    JNIEnv* env,
+    jobject /* this */) {
+    if (isLoaded()) g_api.stop();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_isRunning(
+    JNIEnv* env,
+    jobject /* this */) {
+    return isLoaded() && g_api.isRunning() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_pause(
+    JNIEnv* env,
+    jobject /* this */) {
+    return isLoaded() ? g_api.pause() : -1;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_resume(
+    JNIEnv* env,
+    jobject /* this */) {
+    return isLoaded() ? g_api.resume() : -1;
+}
+
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_setThreads(
+    JNIEnv* env,
+    jobject /* this */,
+    jint threads) {
+    if (isLoaded()) g_api.setThreads(threads);
+}
+
+// Fills a caller-owned array so polling does not allocate; arrays of 8 get
+// the original slots, 12 or more the energy slots too
+JNIEXPORT jboolean JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getStats(
+    JNIEnv* env,
+    jobject /* this */,
+    jdoubleArray out) {
+    if (!isLoaded() || !out || env->GetArrayLength(out) < 8) return JNI_FALSE;
+
+    XMRigStats stats;
+    g_api.getStats(&stats);
+
+    const jdouble values[12] = {
+        stats.hashrate_10s,
+        stats.hashrate_60s,
+        stats.hashrate_15m,
+        static_cast<jdouble>(stats.total_hashes),
+        static_cast<jdouble>(stats.accepted_shares),
+        static_cast<jdouble>(stats.rejected_shares),
+        static_cast<jdouble>(stats.threads),
+        stats.is_mining ? 1.0 : 0.0,
+        stats.power_w,
+        stats.hashes_per_joule_10s,
+        stats.hashes_per_joule_60s,
+        stats.hashes_per_joule_15m
+    };
+    env->SetDoubleArrayRegion(out, 0, env->GetArrayLength(out) >= 12 ? 12 : 8, values);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_setGovernor(
+    JNIEnv* env,
+    jobject /* this */,
+    jdouble targetTempC,
+    jdouble maxBatteryTempC,
+    jdouble hysteresisC,
+    jint maxCpuUsage,
+    jint minBattery,
+    jint intervalMs) {
+    if (!isLoaded()) return -1;
+
+    XMRigGovernorOptions options = {};
+    options.target_temp_c = targetTempC;
+    options.max_battery_temp_c = maxBatteryTempC;
+    options.hysteresis_c = hysteresisC;
+    options.max_cpu_usage = maxCpuUsage;
+    options.min_battery = minBattery;
+    options.interval_ms = static_cast<uint32_t>(intervalMs);
+    return g_api.setGovernor(&options);
+}
+
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_disableGovernor(
+    JNIEnv* env,
+    jobject /* this */) {
+    if (isLoaded()) g_api.setGovernor(nullptr);
+}
+
+// Readings from BatteryManager, for devices whose sysfs the app cannot read
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_reportSensors(
+    JNIEnv* env,
+    jobject /* this */,
+    jdouble socTempC,
+    jdouble batteryTempC,
+    jint batteryLevel,
+    jboolean charging) {
+    if (!isLoaded()) return;
+
+    XMRigSensors sensors = {};
+    sensors.soc_temp_c = socTempC;
+    sensors.battery_temp_c = batteryTempC;
+    sensors.battery_level = batteryLevel;
+    sensors.charging = charging == JNI_TRUE;
+    g_api.reportSensors(&sensors);
+}
+
+// Same caller-owned array scheme as getStats
+JNIEXPORT jboolean JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getGovernorState(
+    JNIEnv* env,
+    jobject /* this */,
+    jdoubleArray out) {
+    if (!isLoaded() || !out || env->GetArrayLength(out) < 9) return JNI_FALSE;
+
+    XMRigGovernorState state;
+    g_api.getGovernorState(&state);
+
+    const jdouble values[9] = {
+        state.enabled ? 1.0 : 0.0,
+        state.sensors.soc_temp_c,
+        state.sensors.battery_temp_c,
+        static_cast<jdouble>(state.sensors.battery_level),
+        state.sensors.charging ? 1.0 : 0.0,
+        state.budget,
+        static_cast<jdouble>(state.running),
+        static_cast<jdouble>(state.duty_percent),
+        static_cast<jdouble>(state.limits)
+    };
+    env->SetDoubleArrayRegion(out, 0, 9, values);
+    return JNI_TRUE;
+}
+
+// Per-thread accounting, kThreadFields doubles per worker in the order of
+// XMRigThreadStats; returns the number of workers written
+static constexpr jsize kThreadFields = 16;
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getThreadStats(
+    JNIEnv* env,
+    jobject /* this */,
+    jdoubleArray out) {
+    if (!isLoaded() || !out) return 0;
+
+    XMRigThreadStats threads[XMRIG_THREAD_STATS_MAX];
+    const int sampled = g_api.getThreadStats(threads, XMRIG_THREAD_STATS_MAX);
+    const jsize count = std::min<jsize>({ sampled, XMRIG_THREAD_STATS_MAX, env->GetArrayLength(out) / kThreadFields });
+
+    for (jsize i = 0; i < count; ++i) {
+        const XMRigThreadStats& thread = threads[i];
+        const jdouble values[kThreadFields] = {
+            static_cast<jdouble>(thread.worker),
+            static_cast<jdouble>(thread.tid),
+            static_cast<jdouble>(thread.cpu),
+            thread.parked ? 1.0 : 0.0,
+            thread.usage,
+            static_cast<jdouble>(thread.cpu_time_ms),
+            static_cast<jdouble>(thread.runqueue_wait_ms),
+            static_cast<jdouble>(thread.voluntary_switches),
+            static_cast<jdouble>(thread.involuntary_switches),
+            static_cast<jdouble>(thread.migrations),
+            static_cast<jdouble>(thread.hashes),
+            thread.hashrate_10s,
+            thread.hashrate_60s,
+            static_cast<jdouble>(thread.freq_khz),
+            static_cast<jdouble>(thread.max_freq_khz),
+            static_cast<jdouble>(thread.flags)
+        };
+        env->SetDoubleArrayRegion(out, i * kThreadFields, kThreadFields, values);
+    }
+    return count;
+}
+
+// Mining history between two wall-clock times, kHistoryFields doubles per
+// sample in the order of XMRigHistorySample, oldest first; returns the
+// number of samples written
+static constexpr jsize kHistoryFields = 14;
+
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getHistory(
+    JNIEnv* env,
+    jobject /* this */,
+    jint tier,
+    jlong fromMs,
+    jlong toMs,
+    jdoubleArray out) {
+    if (!isLoaded() || !out || fromMs < 0 || toMs < fromMs) return 0;
+
+    std::vector<XMRigHistorySample> samples(env->GetArrayLength(out) / kHistoryFields);
+    if (samples.empty()) return 0;
+
+    const int count = g_api.getHistory(tier, static_cast<uint64_t>(fromMs), static_cast<uint64_t>(toMs),
+                                       samples.data(), static_cast<int>(samples.size()));
+    std::vector<jdouble> values;
+    values.reserve(static_cast<size_t>(count) * kHistoryFields);
+
+    for (int i = 0; i < count; ++i) {
+        const XMRigHistorySample& sample = samples[i];
+        values.insert(values.end(), {
+            static_cast<jdouble>(sample.timestamp_ms),
+            static_cast<jdouble>(sample.hashes),
+            static_cast<jdouble>(sample.diff),
+            sample.hashrate_10s,
+            sample.hashrate_60s,
+            sample.hashrate_15m,
+            static_cast<jdouble>(sample.accepted),
+            static_cast<jdouble>(sample.rejected),
+            sample.soc_temp_c,
+            sample.battery_temp_c,
+            sample.cpu_usage,
+            sample.power_w,
+            static_cast<jdouble>(sample.samples),
+            static_cast<jdouble>(sample.flags)
+        });
+    }
+    env->SetDoubleArrayRegion(out, 0, static_cast<jsize>(values.size()), values.data());
+    return count;
+}
+
+JNIEXPORT void JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_clearHistory(
+    JNIEnv* env,
+    jobject /* this */) {
+    if (!isLoaded()) return;
+    g_api.clearHistory();
+}
+
+// Startup timeline: XMRIG_STARTUP_PHASES marks in ms since start (0 = not
+// reached), then connect attempts, threads, TLS and cache-from-disk
+static constexpr jsize kStartupFields = XMRIG_STARTUP_PHASES + 4;
+
+JNIEXPORT jboolean JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getStartupReport(
+    JNIEnv* env,
+    jobject /* this */,
+    jdoubleArray out) {
+    if (!isLoaded() || !out || env->GetArrayLength(out) < kStartupFields) return JNI_FALSE;
+
+    XMRigStartupReport report;
+    g_api.getStartupReport(&report);
+
+    jdouble values[kStartupFields];
+    for (int phase = 0; phase < XMRIG_STARTUP_PHASES; ++phase) {
+        values[phase] = report.phase_us[phase] / 1000.0;
+    }
+    values[XMRIG_STARTUP_PHASES] = report.connect_attempts;
+    values[XMRIG_STARTUP_PHASES + 1] = report.threads;
+    values[XMRIG_STARTUP_PHASES + 2] = report.tls ? 1.0 : 0.0;
+    values[XMRIG_STARTUP_PHASES + 3] = report.rx_cache_from_disk ? 1.0 : 0.0;
+    env->SetDoubleArrayRegion(out, 0, kStartupFields, values);
+    return JNI_TRUE;
+}
+
+// Direct ByteBuffer over the core's stats page (XMRigStatsPage); Kotlin reads
+// it in place, so polling needs no further JNI calls
+JNIEXPORT jobject JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_getStatsPage(
+    JNIEnv* env,
+    jobject /* this */) {
+    if (!isLoaded()) return nullptr;
+
+    const XMRigStatsPage* page = g_api.getStatsPage();
+    return env->NewDirectByteBuffer(const_cast<XMRigStatsPage*>(page), page->size);
+}
+
+// Stats page sequence with the ordering StatsPage needs before API 33 has
+// VarHandle fences: the fence keeps earlier payload loads ahead of it, the
+// acquire load keeps later ones behind it
+JNIEXPORT jint JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_loadPageSequence(
+    JNIEnv* env,
+    jobject /* this */,
+    jobject page) {
+    auto* stats = static_cast<XMRigStatsPage*>(env->GetDirectBufferAddress(page));
+    if (!stats) return 1; // odd: the reader retries
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return static_cast<jint>(__atomic_load_n(&stats->sequence, __ATOMIC_ACQUIRE));
+}
+
+// Blocks until the offline benchmark finishes; call from a background thread
+JNIEXPORT jobject JNICALL
+Java_com_iml1s_xmrigminer_native_XMRigBridge_benchmark(
+    JNIEnv* env,
+    jobject /* this */,
+    jint size,
+    jint threads,
+    jlong affinity,
+    jint mode,
+    jboolean hugePages,
+    jint priority,
+    jint timeoutMs,
+    jint trialMs) {
+    if (!isLoaded()) return nullptr;
+
+    XMRigBenchmarkOptions options = {};
+    options.size = static_cast<uint32_t>(size);
+    options.threads = threads;
+    options.affinity = affinity;
+    options.mode = mode;
+    options.huge_pages = hugePages == JNI_TRUE;
+    options.priority = priority;
+    options.timeout_ms = static_cast<uint32_t>(timeoutMs);
+    options.trial_ms = static_cast<uint32_t>(trialMs);
+
+    XMRigBenchmarkResult result;
+    const int rc = g_api.benchmark(&options, &result);
+    if (rc != 0) {
+        LOGE("xmrig_benchmark_v8 failed: %d", rc);
+        return nullptr;
+    }
+
+    LOGI("Benchmark: %.1f H/s, %u threads, %.2f H/J, hash %016llx (%s)", result.hashrate, result.threads,
+         result.hashes_per_joule, static_cast<unsigned long long>(result.hash), result.verified ? "verified" : "unverified");
+
+    const jsize count = static_cast<jsize>(std::min<uint32_t>(result.threads, XMRIG_BENCHMARK_THREADS));
+    jdoubleArray perThread = env->NewDoubleArray(count);
+    if (!perThread) return nullptr;
+    env->SetDoubleArrayRegion(perThread, 0, count, result.thread_hashrate);
+
+    jclass cls = env->FindClass("com/iml1s/xmrigminer/native/BenchmarkResult");
+    if (!cls) return nullptr;
+    jmethodID ctor = env->GetMethodID(cls, "<init>", "(D[DIJJJJJZDD)V");
+    if (!ctor) return nullptr;
+
+    return env->NewObject(cls, ctor,
+                          result.hashrate,
+                          perThread,
+                          static_cast<jint>(result.size),
+                          static_cast<jlong>(result.init_ms),
+                          static_cast<jlong>(result.first_hash_ms),
+                          static_cast<jlong>(result.duration_ms),
+                          static_cast<jlong>(result.hash),
+                          static_cast<jlong>(result.reference),
+                          result.verified ? JNI_TRUE : JNI_FALSE,
+                          result.power_w,
+                          result.hashes_per_joule);
 }
 
 } // extern "C"
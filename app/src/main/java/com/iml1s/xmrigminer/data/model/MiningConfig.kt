@@ -17,11 +17,17 @@ data class MiningConfig(
     val retries: Int = 5,
     val retryPause: Int = 5,
     val printTime: Int = 60,
-    val coinType: String = "MONERO"  // 新增：幣種類型
+    val coinType: String = "MONERO",  // 新增：幣種類型
+    val autotune: Boolean = false,  // 首次啟動時自動調校
+    val keepRxCache: Boolean = false  // RandomX cache 存檔，重啟免重算
 ) {
     fun getCoin(): CoinType = CoinType.fromString(coinType)
 
-    fun toJson(): String {
+    /**
+     * @param profile autotune result for this device; replaces [threads]
+     *        and the RandomX mode
+     */
+    fun toJson(profile: TuningProfile? = null): String {
         val coin = getCoin()
         val coinConfig = when (coin) {
             CoinType.MONERO -> ""  // Monero 不需要額外配置
@@ -45,7 +51,7 @@ data class MiningConfig(
             """.trimIndent()
             else -> """
             "randomx": {
-                "mode": "auto",
+                "mode": "${profile?.randomxMode ?: "auto"}",
                 "1gb-pages": false,
                 "rdmsr": false,
                 "wrmsr": false
@@ -53,15 +59,20 @@ data class MiningConfig(
             """.trimIndent()
         }
 
+        // 線程數寫進 "*" profile；核心啟動後 setThreads 只能暫停已有的線程
+        val cpuConfig = profile?.cpuJson() ?: """
+                "priority": 1,
+                "*": { "intensity": 1, "threads": $threads, "affinity": -1 }
+        """.trimIndent()
+
         return """
         {
             "autosave": false,
             "cpu": {
                 "enabled": true,
-                "max-threads-hint": $maxCpuUsage,
-                "priority": 1,
                 "asm": true,
-                "argon2-impl": "auto"
+                "argon2-impl": "auto",
+                $cpuConfig
             },
             "pools": [
                 {
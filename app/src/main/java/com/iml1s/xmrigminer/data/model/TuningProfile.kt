@@ -0,0 +1,25 @@
+package com.iml1s.xmrigminer.data.model
+
+import kotlinx.serialization.Serializable
+
+/**
+ * Winning autotune settings for one CPU, keyed by [fingerprint]
+ * (see util/CpuFingerprint.kt)
+ */
+@Serializable
+data class TuningProfile(
+    val fingerprint: String,
+    val threads: Int,
+    val affinity: Long = -1,       // CPU mask, -1 = no pinning
+    val randomxMode: String = "auto",
+    val hugePages: Boolean = false,
+    val priority: Int = 1,
+    val hashrate: Double = 0.0,    // best trial, H/s
+    val hashesPerJoule: Double = 0.0, // best trial, 0 without an energy meter
+    val coreVariant: String? = null,
+    val tunedAt: Long = 0L
+) {
+    /** XMRig "cpu" entries: applied through the "*" profile, which matches every algorithm */
+    fun cpuJson(): String =
+        """"huge-pages": $hugePages, "priority": $priority, "*": { "intensity": 1, "threads": $threads, "affinity": $affinity }"""
+}
@@ -26,6 +26,8 @@ class ConfigRepository @Inject constructor(
         val USE_TLS = booleanPreferencesKey("use_tls")
         val AUTO_RECONNECT = booleanPreferencesKey("auto_reconnect")
         val MINE_WHEN_SCREEN_OFF = booleanPreferencesKey("mine_when_screen_off")
+        val AUTOTUNE = booleanPreferencesKey("autotune")
+        val KEEP_RX_CACHE = booleanPreferencesKey("keep_rx_cache")
     }
 
     fun getConfig(): Flow<MiningConfig> = context.dataStore.data.map { prefs ->
@@ -37,7 +39,9 @@ class ConfigRepository @Inject constructor(
             maxCpuUsage = prefs[Keys.MAX_CPU_USAGE] ?: 75,
             useTls = prefs[Keys.USE_TLS] ?: true,
             autoReconnect = prefs[Keys.AUTO_RECONNECT] ?: true,
-            mineWhenScreenOff = prefs[Keys.MINE_WHEN_SCREEN_OFF] ?: false
+            mineWhenScreenOff = prefs[Keys.MINE_WHEN_SCREEN_OFF] ?: false,
+            autotune = prefs[Keys.AUTOTUNE] ?: false,
+            keepRxCache = prefs[Keys.KEEP_RX_CACHE] ?: false
         )
     }
 
@@ -51,6 +55,8 @@ class ConfigRepository @Inject constructor(
             prefs[Keys.USE_TLS] = config.useTls
             prefs[Keys.AUTO_RECONNECT] = config.autoReconnect
             prefs[Keys.MINE_WHEN_SCREEN_OFF] = config.mineWhenScreenOff
+            prefs[Keys.AUTOTUNE] = config.autotune
+            prefs[Keys.KEEP_RX_CACHE] = config.keepRxCache
         }
     }
 
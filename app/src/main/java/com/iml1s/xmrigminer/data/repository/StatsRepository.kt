@@ -37,6 +37,10 @@ class StatsRepository @Inject constructor() {
         _stats.update { it.copy(rejectedShares = it.rejectedShares + 1) }
     }
 
+    fun updateShares(accepted: Int, rejected: Int) {
+        _stats.update { it.copy(acceptedShares = accepted, rejectedShares = rejected) }
+    }
+
     fun updateCpuUsage(usage: Float) {
         // 只在有效值時更新（避免閃爍）
         if (usage > 0f) {
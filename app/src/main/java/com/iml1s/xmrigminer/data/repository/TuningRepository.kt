@@ -0,0 +1,48 @@
+package com.iml1s.xmrigminer.data.repository
+
+import android.content.Context
+import androidx.datastore.core.DataStore
+import androidx.datastore.preferences.core.*
+import androidx.datastore.preferences.preferencesDataStore
+import com.iml1s.xmrigminer.data.model.TuningProfile
+import dagger.hilt.android.qualifiers.ApplicationContext
+import kotlinx.coroutines.flow.first
+import kotlinx.serialization.encodeToString
+import kotlinx.serialization.json.Json
+import timber.log.Timber
+import javax.inject.Inject
+import javax.inject.Singleton
+
+private val Context.tuningDataStore: DataStore<Preferences> by preferencesDataStore(name = "tuning_profiles")
+
+/**
+ * Autotune results, one JSON profile per CPU fingerprint
+ */
+@Singleton
+class TuningRepository @Inject constructor(
+    @ApplicationContext private val context: Context
+) {
+    private val json = Json { ignoreUnknownKeys = true }
+
+    private fun key(fingerprint: String) = stringPreferencesKey("profile_$fingerprint")
+
+    suspend fun getProfile(fingerprint: String): TuningProfile? {
+        val value = context.tuningDataStore.data.first()[key(fingerprint)] ?: return null
+        return try {
+            json.decodeFromString<TuningProfile>(value)
+        } catch (e: Exception) {
+            Timber.w(e, "Discarding unreadable tuning profile")
+            null
+        }
+    }
+
+    suspend fun saveProfile(profile: TuningProfile) {
+        context.tuningDataStore.edit { prefs ->
+            prefs[key(profile.fingerprint)] = json.encodeToString(profile)
+        }
+    }
+
+    suspend fun clear() {
+        context.tuningDataStore.edit { it.clear() }
+    }
+}
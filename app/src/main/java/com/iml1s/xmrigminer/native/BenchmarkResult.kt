@@ -0,0 +1,32 @@
+package com.iml1s.xmrigminer.native
+
+/**
+ * Result of [XMRigBridge.benchmark] (XMRigBenchmarkResult in xmrig_bridge.h)
+ *
+ * Built by native-bridge.cpp; keep the constructor in sync with its JNI
+ * signature "(D[DIJJJJJZDD)V".
+ */
+class BenchmarkResult(
+    val hashrate: Double,
+    val threadHashrate: DoubleArray,
+    val size: Int,
+    val initMs: Long,
+    val firstHashMs: Long,
+    val durationMs: Long,
+    val hash: Long,
+    val reference: Long,
+    val verified: Boolean,
+    /** Average device draw while hashing, 0 without an energy meter */
+    val powerW: Double = 0.0,
+    val hashesPerJoule: Double = 0.0
+) {
+    val threads: Int get() = threadHashrate.size
+
+    /** Hash sum as XMRig prints it */
+    val hashHex: String get() = "%016X".format(hash)
+
+    override fun toString(): String =
+        "BenchmarkResult(%.1f H/s, %.2f H/J, %d threads, %d hashes, init %d ms, first hash %d ms, hash %s%s)".format(
+            hashrate, hashesPerJoule, threads, size, initMs, firstHashMs, hashHex, if (verified) " OK" else ""
+        )
+}
@@ -0,0 +1,81 @@
+package com.iml1s.xmrigminer.native
+
+/**
+ * One point of the core's mining history (XMRigHistorySample in xmrig_bridge.h)
+ *
+ * Covers the interval ending at [timestampMs]: rates, CPU usage and power are
+ * means over it, counters are sums, temperatures the highest reading.
+ */
+data class HistorySample(
+    val timestampMs: Long,
+    val hashes: Long,
+    val difficulty: Long,
+    val hashrate10s: Double,
+    val hashrate60s: Double,
+    val hashrate15m: Double,
+    val accepted: Int,
+    val rejected: Int,
+    /** null when unreadable */
+    val socTempC: Double?,
+    val batteryTempC: Double?,
+    val cpuUsage: Double,
+    val powerW: Double,
+    /** 10 s samples merged into this one */
+    val samples: Int,
+    val flags: Int
+) {
+    val isPaused: Boolean get() = flags and StatsPage.FLAG_PAUSED != 0
+    val isDonating: Boolean get() = flags and StatsPage.FLAG_DONATE != 0
+}
+
+/**
+ * Range queries over the history the core keeps in history.bin, for charts
+ *
+ * Needs the core loaded and [XMRigBridge.setStoragePath] called; the history
+ * can be read while the miner is stopped.
+ */
+object MiningHistory {
+
+    /** Most points returned by one query */
+    const val DEFAULT_LIMIT = 2000
+
+    /**
+     * Samples with fromMs <= timestamp <= toMs, oldest first
+     * @param tier XMRigBridge.HISTORY_*; AUTO picks the finest tier covering the range
+     */
+    fun query(
+        fromMs: Long,
+        toMs: Long = System.currentTimeMillis(),
+        tier: Int = XMRigBridge.HISTORY_AUTO,
+        limit: Int = DEFAULT_LIMIT
+    ): List<HistorySample> {
+        if (limit <= 0 || toMs < fromMs) return emptyList()
+
+        val out = DoubleArray(limit * XMRigBridge.HISTORY_FIELDS)
+        val count = XMRigBridge.getHistory(tier, fromMs, toMs, out)
+
+        return List(count) { i -> decode(out, i * XMRigBridge.HISTORY_FIELDS) }
+    }
+
+    fun clear() = XMRigBridge.clearHistory()
+
+    private fun temperature(value: Double): Double? =
+        if (value > XMRigBridge.TEMP_UNKNOWN) value else null
+
+    private fun decode(out: DoubleArray, base: Int) = HistorySample(
+        timestampMs = out[base + XMRigBridge.HISTORY_TIMESTAMP_MS].toLong(),
+        hashes = out[base + XMRigBridge.HISTORY_HASHES].toLong(),
+        difficulty = out[base + XMRigBridge.HISTORY_DIFF].toLong(),
+        hashrate10s = out[base + XMRigBridge.HISTORY_HASHRATE_10S],
+        hashrate60s = out[base + XMRigBridge.HISTORY_HASHRATE_60S],
+        hashrate15m = out[base + XMRigBridge.HISTORY_HASHRATE_15M],
+        accepted = out[base + XMRigBridge.HISTORY_ACCEPTED].toInt(),
+        rejected = out[base + XMRigBridge.HISTORY_REJECTED].toInt(),
+        socTempC = temperature(out[base + XMRigBridge.HISTORY_SOC_TEMP]),
+        batteryTempC = temperature(out[base + XMRigBridge.HISTORY_BATTERY_TEMP]),
+        cpuUsage = out[base + XMRigBridge.HISTORY_CPU_USAGE],
+        powerW = out[base + XMRigBridge.HISTORY_POWER_W],
+        samples = out[base + XMRigBridge.HISTORY_SAMPLES].toInt(),
+        flags = out[base + XMRigBridge.HISTORY_FLAGS].toInt()
+    )
+}
@@ -0,0 +1,165 @@
+package com.iml1s.xmrigminer.native
+
+import android.os.Build
+import androidx.annotation.RequiresApi
+import java.lang.invoke.VarHandle
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Reader for the core's shared stats page (XMRigStatsPage in xmrig_bridge.h)
+ *
+ * The buffer points straight at native memory the miner updates in place,
+ * so [read] costs no JNI call and no allocation: it copies one consistent
+ * snapshot into this object's fields, following the page's seqlock.
+ * Not thread-safe; give each polling loop its own reader.
+ *
+ * @param sequenceLoad reads the sequence word with the ordering the
+ *        seqlock needs; see [platformSequenceLoad]
+ */
+class StatsPage(
+    buffer: ByteBuffer,
+    private val sequenceLoad: SequenceLoad = platformSequenceLoad()
+) {
+    /**
+     * Loads the sequence word so that payload loads issued before it stay
+     * before it, and payload loads issued after it stay after it
+     */
+    fun interface SequenceLoad {
+        fun load(page: ByteBuffer): Int
+    }
+
+    private val page: ByteBuffer = buffer.duplicate().order(ByteOrder.nativeOrder())
+
+    var sequence = 0; private set
+    var updatedMs = 0L; private set
+    var hashrate10s = 0.0; private set
+    var hashrate60s = 0.0; private set
+    var hashrate15m = 0.0; private set
+    var totalHashes = 0L; private set
+    var acceptedShares = 0L; private set
+    var rejectedShares = 0L; private set
+    var difficulty = 0L; private set
+    var height = 0L; private set
+    var cpuTimeUs = 0L; private set
+    var flags = 0; private set
+    var threads = 0; private set
+    val threadHashrate = DoubleArray(MAX_THREADS)
+    private val scratchHashrate = DoubleArray(MAX_THREADS)
+
+    val isMining: Boolean get() = flags and FLAG_MINING != 0
+    val isPaused: Boolean get() = flags and FLAG_PAUSED != 0
+    val isDonating: Boolean get() = flags and FLAG_DONATE != 0
+
+    init {
+        require(page.capacity() >= SIZE_V1) { "Stats page too small: ${page.capacity()}" }
+        require(page.getInt(OFFSET_MAGIC) == MAGIC) { "Not an XMRig stats page" }
+        require(page.getInt(OFFSET_VERSION) >= VERSION) { "Unsupported stats page version" }
+    }
+
+    /**
+     * Copies the current snapshot into this reader. The fields only change
+     * once a whole snapshot passed the sequence check.
+     * @return true if the page changed since the last successful read
+     */
+    fun read(): Boolean {
+        repeat(MAX_RETRIES) {
+            val before = sequenceLoad.load(page)
+            if (before and 1 != 0) return@repeat
+            if (before == sequence && updatedMs != 0L) return false
+
+            val updatedMs = page.getLong(OFFSET_UPDATED_MS)
+            val hashrate10s = page.getDouble(OFFSET_HASHRATE_10S)
+            val hashrate60s = page.getDouble(OFFSET_HASHRATE_60S)
+            val hashrate15m = page.getDouble(OFFSET_HASHRATE_15M)
+            val totalHashes = page.getLong(OFFSET_TOTAL_HASHES)
+            val acceptedShares = page.getLong(OFFSET_ACCEPTED)
+            val rejectedShares = page.getLong(OFFSET_REJECTED)
+            val difficulty = page.getLong(OFFSET_DIFF)
+            val height = page.getLong(OFFSET_HEIGHT)
+            val cpuTimeUs = page.getLong(OFFSET_CPU_TIME_US)
+            val flags = page.getInt(OFFSET_FLAGS)
+            val threads = page.getInt(OFFSET_THREADS)
+            for (i in 0 until MAX_THREADS) {
+                scratchHashrate[i] = page.getDouble(OFFSET_THREAD_HASHRATE + i * 8)
+            }
+
+            if (sequenceLoad.load(page) == before) {
+                sequence = before
+                this.updatedMs = updatedMs
+                this.hashrate10s = hashrate10s
+                this.hashrate60s = hashrate60s
+                this.hashrate15m = hashrate15m
+                this.totalHashes = totalHashes
+                this.acceptedShares = acceptedShares
+                this.rejectedShares = rejectedShares
+                this.difficulty = difficulty
+                this.height = height
+                this.cpuTimeUs = cpuTimeUs
+                this.flags = flags
+                this.threads = threads
+                scratchHashrate.copyInto(threadHashrate)
+                return true
+            }
+        }
+        return false
+    }
+
+    @RequiresApi(Build.VERSION_CODES.TIRAMISU)
+    private object Fences {
+        fun load(page: ByteBuffer): Int {
+            VarHandle.loadLoadFence()
+            val sequence = page.getInt(OFFSET_SEQUENCE)
+            VarHandle.acquireFence()
+            return sequence
+        }
+    }
+
+    companion object {
+        const val MAGIC = 0x50534D58 // "XMSP"
+        const val VERSION = 1
+        const val MAX_THREADS = 64
+        const val SIZE_V1 = 616
+
+        const val FLAG_MINING = 1 shl 0
+        const val FLAG_PAUSED = 1 shl 1
+        const val FLAG_DONATE = 1 shl 2
+
+        const val OFFSET_MAGIC = 0
+        const val OFFSET_VERSION = 4
+        const val OFFSET_SIZE = 8
+        const val OFFSET_SEQUENCE = 12
+        const val OFFSET_UPDATED_MS = 16
+        const val OFFSET_HASHRATE_10S = 24
+        const val OFFSET_HASHRATE_60S = 32
+        const val OFFSET_HASHRATE_15M = 40
+        const val OFFSET_TOTAL_HASHES = 48
+        const val OFFSET_ACCEPTED = 56
+        const val OFFSET_REJECTED = 64
+        const val OFFSET_DIFF = 72
+        const val OFFSET_HEIGHT = 80
+        const val OFFSET_CPU_TIME_US = 88
+        const val OFFSET_FLAGS = 96
+        const val OFFSET_THREADS = 100
+        const val OFFSET_THREAD_HASHRATE = 104
+
+        private const val MAX_RETRIES = 4
+
+        /** Unordered load, for heap buffers no other thread writes (tests) */
+        val PLAIN_SEQUENCE = SequenceLoad { it.getInt(OFFSET_SEQUENCE) }
+
+        /**
+         * VarHandle fences from API 33; before that ART has no public fences,
+         * so the sequence goes through native-bridge's acquire load instead
+         */
+        fun platformSequenceLoad(): SequenceLoad =
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+                SequenceLoad { Fences.load(it) }
+            } else {
+                SequenceLoad { XMRigBridge.loadPageSequence(it) }
+            }
+
+        /** Attaches to the loaded core's page, or null if libxmrig.so is not loaded */
+        fun attach(): StatsPage? = XMRigBridge.getStatsPage()?.let { StatsPage(it) }
+    }
+}
@@ -1,12 +1,222 @@
 package com.iml1s.xmrigminer.native
 
+import java.nio.ByteBuffer
+
 object XMRigBridge {
     init {
         System.loadLibrary("native-bridge")
     }
 
+    /** Slots of the array filled by [getStats] */
+    const val STAT_HASHRATE_10S = 0
+    const val STAT_HASHRATE_60S = 1
+    const val STAT_HASHRATE_15M = 2
+    const val STAT_TOTAL_HASHES = 3
+    const val STAT_ACCEPTED = 4
+    const val STAT_REJECTED = 5
+    const val STAT_THREADS = 6
+    const val STAT_MINING = 7
+    /** Device draw and efficiency; 0 without an energy meter or while charging */
+    const val STAT_POWER_W = 8
+    const val STAT_HASHES_PER_JOULE_10S = 9
+    const val STAT_HASHES_PER_JOULE_60S = 10
+    const val STAT_HASHES_PER_JOULE_15M = 11
+    const val STAT_COUNT = 12
+
+    /** Bits of [getCpuFeatures] */
+    const val CPU_AES = 1 shl 0
+    const val CPU_PMULL = 1 shl 1
+    const val CPU_SHA1 = 1 shl 2
+    const val CPU_SHA2 = 1 shl 3
+    const val CPU_LSE = 1 shl 4
+    const val CPU_RDM = 1 shl 5
+    const val CPU_DOTPROD = 1 shl 6
+    const val CPU_SVE = 1 shl 7
+    const val CPU_SVE2 = 1 shl 8
+
     external fun getVersion(): String
     external fun getCpuCores(): Int
     external fun getCpuInfo(): String
     external fun hasCryptoExtensions(): Boolean
+    external fun getCpuFeatures(): Int
+
+    // In-process XMRig core (libxmrig.so, see xmrig_bridge.h)
+    /** Loads the fastest libxmrig build this CPU supports */
+    external fun loadCore(): Boolean
+    /** File name of the loaded libxmrig build, null before [loadCore] */
+    external fun getCoreVariant(): String?
+    external fun setStoragePath(path: String)
+    /** Disk budget for saved RandomX caches under the storage path, 0 = off and delete them */
+    external fun setRxCache(budgetBytes: Long)
+    external fun init(configJson: String): Int
+    external fun start(): Int
+    external fun stop()
+    external fun isRunning(): Boolean
+    external fun pause(): Int
+    external fun resume(): Int
+    external fun setThreads(threads: Int)
+    external fun getStats(out: DoubleArray): Boolean
+
+    /** Direct buffer over the core's stats page, read it through [StatsPage] */
+    external fun getStatsPage(): ByteBuffer?
+    /** Sequence word of a stats page buffer, fenced for [StatsPage] below API 33 */
+    external fun loadPageSequence(page: ByteBuffer): Int
+
+    /** Memory modes for [benchmark] */
+    const val BENCHMARK_MODE_AUTO = 0
+    const val BENCHMARK_MODE_FAST = 1
+    const val BENCHMARK_MODE_LIGHT = 2
+
+    /**
+     * XMRig's offline fixed-seed benchmark; blocks until it finishes.
+     * @param size hashes: 250000, 500000 or 1..10 million in whole millions
+     * @param threads 0 = XMRig's auto configuration
+     * @param affinity CPU mask, -1 = no pinning
+     * @param priority XMRig CPU priority 0-5, -1 = XMRig's default
+     * @param trialMs > 0: stop this long after the workers are ready and
+     *        report 10s average rates instead of a verified hash sum
+     * @return null if the core is not loaded, busy, or the run failed
+     */
+    external fun benchmark(
+        size: Int,
+        threads: Int = 0,
+        affinity: Long = -1,
+        mode: Int = BENCHMARK_MODE_AUTO,
+        hugePages: Boolean = false,
+        priority: Int = -1,
+        timeoutMs: Int = 0,
+        trialMs: Int = 0
+    ): BenchmarkResult?
+
+    /** Slots of the array filled by [getGovernorState] */
+    const val GOVERNOR_ENABLED = 0
+    const val GOVERNOR_SOC_TEMP = 1
+    const val GOVERNOR_BATTERY_TEMP = 2
+    const val GOVERNOR_BATTERY_LEVEL = 3
+    const val GOVERNOR_CHARGING = 4
+    const val GOVERNOR_BUDGET = 5
+    const val GOVERNOR_RUNNING = 6
+    const val GOVERNOR_DUTY_PERCENT = 7
+    const val GOVERNOR_LIMITS = 8
+    const val GOVERNOR_COUNT = 9
+
+    /** Bits of the [GOVERNOR_LIMITS] slot */
+    const val LIMIT_SOC_TEMP = 1 shl 0
+    const val LIMIT_BATTERY_TEMP = 1 shl 1
+    const val LIMIT_CPU_USAGE = 1 shl 2
+    const val LIMIT_LOW_BATTERY = 1 shl 3
+
+    /** Marks an unknown temperature in [reportSensors] and [getGovernorState] */
+    const val TEMP_UNKNOWN = -1000.0
+
+    /**
+     * Thermal and battery governor: parks and duty-cycles workers to stay
+     * under the limits, without restarting the core. 0 disables a limit.
+     * @param maxCpuUsage percent of all CPUs the workers may use
+     * @param minBattery park every worker below this level unless charging
+     * @return 0 on success, -1 on invalid limits or when the core is not loaded
+     */
+    external fun setGovernor(
+        targetTempC: Double,
+        maxBatteryTempC: Double = 0.0,
+        hysteresisC: Double = 0.0,
+        maxCpuUsage: Int = 0,
+        minBattery: Int = 0,
+        intervalMs: Int = 0
+    ): Int
+    external fun disableGovernor()
+    /** Readings the core cannot take from sysfs itself; unknown values keep earlier reports */
+    external fun reportSensors(socTempC: Double, batteryTempC: Double, batteryLevel: Int, charging: Boolean)
+    external fun getGovernorState(out: DoubleArray): Boolean
+
+    /** Fields per worker in the array filled by [getThreadStats] */
+    const val THREAD_WORKER = 0
+    const val THREAD_TID = 1
+    const val THREAD_CPU = 2
+    const val THREAD_PARKED = 3
+    const val THREAD_USAGE = 4
+    const val THREAD_CPU_TIME_MS = 5
+    const val THREAD_RUNQUEUE_WAIT_MS = 6
+    const val THREAD_VOLUNTARY_SWITCHES = 7
+    const val THREAD_INVOLUNTARY_SWITCHES = 8
+    const val THREAD_MIGRATIONS = 9
+    const val THREAD_HASHES = 10
+    const val THREAD_HASHRATE_10S = 11
+    const val THREAD_HASHRATE_60S = 12
+    const val THREAD_FREQ_KHZ = 13
+    const val THREAD_MAX_FREQ_KHZ = 14
+    const val THREAD_FLAGS = 15
+    const val THREAD_FIELDS = 16
+    const val THREAD_STATS_MAX = 64
+
+    /** Bits of the [THREAD_FLAGS] field; SLOW plus another bit names the likely cause */
+    const val THREAD_SLOW = 1 shl 0
+    const val THREAD_THROTTLED = 1 shl 1
+    const val THREAD_MIGRATED = 1 shl 2
+    const val THREAD_LITTLE_CORE = 1 shl 3
+
+    /**
+     * Latest per-thread scheduler sample, [THREAD_FIELDS] values per worker;
+     * counters are cumulative since the worker started
+     * @return number of workers written
+     */
+    external fun getThreadStats(out: DoubleArray): Int
+
+    /** Tiers for [getHistory]: 10 s for a day, 1 min for a week, 1 h for a year */
+    const val HISTORY_AUTO = -1
+    const val HISTORY_10S = 0
+    const val HISTORY_1M = 1
+    const val HISTORY_1H = 2
+
+    /** Fields per sample in the array filled by [getHistory] */
+    const val HISTORY_TIMESTAMP_MS = 0
+    const val HISTORY_HASHES = 1
+    const val HISTORY_DIFF = 2
+    const val HISTORY_HASHRATE_10S = 3
+    const val HISTORY_HASHRATE_60S = 4
+    const val HISTORY_HASHRATE_15M = 5
+    const val HISTORY_ACCEPTED = 6
+    const val HISTORY_REJECTED = 7
+    const val HISTORY_SOC_TEMP = 8
+    const val HISTORY_BATTERY_TEMP = 9
+    const val HISTORY_CPU_USAGE = 10
+    const val HISTORY_POWER_W = 11
+    const val HISTORY_SAMPLES = 12
+    const val HISTORY_FLAGS = 13
+    const val HISTORY_FIELDS = 14
+
+    /**
+     * Mining history recorded under the storage path, [HISTORY_FIELDS]
+     * values per sample, oldest first; survives restarts of the core.
+     * @param tier HISTORY_* tier; [HISTORY_AUTO] picks the finest one reaching back to fromMs
+     * @return number of samples written
+     */
+    external fun getHistory(tier: Int, fromMs: Long, toMs: Long, out: DoubleArray): Int
+    external fun clearHistory()
+
+    /** Slots of the array filled by [getStartupReport]: ms since start, 0 = not reached */
+    const val STARTUP_CONFIG = 0
+    const val STARTUP_INIT = 1
+    const val STARTUP_DNS = 2
+    const val STARTUP_CONNECT = 3
+    const val STARTUP_TLS = 4
+    const val STARTUP_LOGIN = 5
+    const val STARTUP_JOB = 6
+    const val STARTUP_RX_CACHE = 7
+    const val STARTUP_RX_DATASET = 8
+    const val STARTUP_THREADS = 9
+    const val STARTUP_FIRST_HASH = 10
+    const val STARTUP_FIRST_SHARE = 11
+    const val STARTUP_PHASES = 12
+    const val STARTUP_CONNECT_ATTEMPTS = 12
+    const val STARTUP_THREAD_COUNT = 13
+    const val STARTUP_IS_TLS = 14
+    const val STARTUP_RX_CACHE_FROM_DISK = 15
+    const val STARTUP_COUNT = 16
+
+    /**
+     * Cold start timeline of the current or last run, from start() to the
+     * first accepted share; phases overlap, so compare marks, not gaps
+     */
+    external fun getStartupReport(out: DoubleArray): Boolean
 }
@@ -26,6 +26,8 @@ sealed interface ConfigUiEvent {
     data class ThreadsChanged(val threads: Int) : ConfigUiEvent
     data class MaxCpuUsageChanged(val usage: Int) : ConfigUiEvent
     data class TlsToggled(val enabled: Boolean) : ConfigUiEvent
+    data class AutotuneToggled(val enabled: Boolean) : ConfigUiEvent
+    data class KeepRxCacheToggled(val enabled: Boolean) : ConfigUiEvent
     data class CustomPoolUrlChanged(val url: String) : ConfigUiEvent
     data object SaveConfig : ConfigUiEvent
     data object ResetToDefaults : ConfigUiEvent
@@ -137,7 +137,11 @@ private fun ConfigContent(
         MiningSettingsCard(
             threads = state.config.threads,
             maxCpuUsage = state.config.maxCpuUsage,
+            autotune = state.config.autotune,
+            keepRxCache = state.config.keepRxCache,
             onThreadsChanged = { onEvent(ConfigUiEvent.ThreadsChanged(it)) },
+            onAutotuneToggled = { onEvent(ConfigUiEvent.AutotuneToggled(it)) },
+            onKeepRxCacheToggled = { onEvent(ConfigUiEvent.KeepRxCacheToggled(it)) },
             onMaxCpuUsageChanged = { onEvent(ConfigUiEvent.MaxCpuUsageChanged(it)) }
         )
 
@@ -453,7 +457,11 @@ private fun WalletConfigCard(
 private fun MiningSettingsCard(
     threads: Int,
     maxCpuUsage: Int,
+    autotune: Boolean,
+    keepRxCache: Boolean,
     onThreadsChanged: (Int) -> Unit,
+    onAutotuneToggled: (Boolean) -> Unit,
+    onKeepRxCacheToggled: (Boolean) -> Unit,
     onMaxCpuUsageChanged: (Int) -> Unit
 ) {
     val maxThreads = Runtime.getRuntime().availableProcessors()
@@ -525,6 +533,48 @@ private fun MiningSettingsCard(
                 )
             }
 
+            Divider()
+
+            // Autotune
+            Row(
+                modifier = Modifier.fillMaxWidth(),
+                horizontalArrangement = Arrangement.SpaceBetween,
+                verticalAlignment = Alignment.CenterVertically
+            ) {
+                Column(modifier = Modifier.weight(1f)) {
+                    Text("Autotune")
+                    Text(
+                        text = "Benchmark this device once and use its fastest settings",
+                        style = MaterialTheme.typography.bodySmall,
+                        color = MaterialTheme.colorScheme.onSurfaceVariant
+                    )
+                }
+                Switch(
+                    checked = autotune,
+                    onCheckedChange = onAutotuneToggled
+                )
+            }
+
+            // RandomX cache on disk
+            Row(
+                modifier = Modifier.fillMaxWidth(),
+                horizontalArrangement = Arrangement.SpaceBetween,
+                verticalAlignment = Alignment.CenterVertically
+            ) {
+                Column(modifier = Modifier.weight(1f)) {
+                    Text("Keep RandomX cache")
+                    Text(
+                        text = "Faster restarts, uses about 512 MB of storage",
+                        style = MaterialTheme.typography.bodySmall,
+                        color = MaterialTheme.colorScheme.onSurfaceVariant
+                    )
+                }
+                Switch(
+                    checked = keepRxCache,
+                    onCheckedChange = onKeepRxCacheToggled
+                )
+            }
+
             Surface(
                 modifier = Modifier.fillMaxWidth(),
                 color = MaterialTheme.colorScheme.tertiaryContainer,
@@ -68,6 +68,8 @@ class ConfigViewModel @Inject constructor(
             is ConfigUiEvent.ThreadsChanged -> handleThreadsChanged(event.threads)
             is ConfigUiEvent.MaxCpuUsageChanged -> handleMaxCpuUsageChanged(event.usage)
             is ConfigUiEvent.TlsToggled -> handleTlsToggled(event.enabled)
+            is ConfigUiEvent.AutotuneToggled -> handleAutotuneToggled(event.enabled)
+            is ConfigUiEvent.KeepRxCacheToggled -> handleKeepRxCacheToggled(event.enabled)
             is ConfigUiEvent.CustomPoolUrlChanged -> handleCustomPoolUrlChanged(event.url)
             is ConfigUiEvent.SaveConfig -> handleSaveConfig()
             is ConfigUiEvent.ResetToDefaults -> handleResetToDefaults()
@@ -140,6 +142,16 @@ class ConfigViewModel @Inject constructor(
         } ?: updateConfig(newConfig, state)
     }
 
+    private fun handleAutotuneToggled(enabled: Boolean) {
+        val state = _uiState.value as? ConfigUiState.Success ?: return
+        updateConfig(currentConfig.copy(autotune = enabled), state)
+    }
+
+    private fun handleKeepRxCacheToggled(enabled: Boolean) {
+        val state = _uiState.value as? ConfigUiState.Success ?: return
+        updateConfig(currentConfig.copy(keepRxCache = enabled), state)
+    }
+
     private fun handleCustomPoolUrlChanged(url: String) {
         val state = _uiState.value as? ConfigUiState.Success ?: return
         val newConfig = currentConfig.copy(poolUrl = url)
@@ -0,0 +1,167 @@
+package com.iml1s.xmrigminer.service
+
+import com.iml1s.xmrigminer.data.model.TuningProfile
+import com.iml1s.xmrigminer.data.repository.TuningRepository
+import com.iml1s.xmrigminer.native.XMRigBridge
+import com.iml1s.xmrigminer.util.CpuFingerprint
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.withContext
+import timber.log.Timber
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Finds the fastest XMRig CPU settings for this device with short offline
+ * benchmark trials, then stores them as a [TuningProfile].
+ *
+ * Coordinate search, one setting at a time: RandomX mode and huge pages,
+ * then thread count and core affinity, then priority. A change has to beat
+ * the current best by [MIN_GAIN] to be kept, so noise does not pick a more
+ * exotic setting. Each trial rebuilds the RandomX dataset, so a full run
+ * takes several minutes.
+ *
+ * [Objective.EFFICIENCY] ranks by hashes per joule instead of H/s. It needs
+ * an energy meter, so it falls back to H/s when the first trial has none
+ * (e.g. while charging).
+ */
+@Singleton
+class Autotuner @Inject constructor(
+    private val tuningRepository: TuningRepository
+) {
+    data class Trial(
+        val threads: Int,
+        val affinity: Long = -1,
+        val mode: Int = XMRigBridge.BENCHMARK_MODE_FAST,
+        val hugePages: Boolean = false,
+        val priority: Int = DEFAULT_PRIORITY
+    )
+
+    data class Measurement(val hashrate: Double, val hashesPerJoule: Double)
+
+    enum class Objective { HASHRATE, EFFICIENCY }
+
+    /**
+     * Runs the search and saves the winner. The core must be loaded and idle.
+     * @return the new profile, or null if no trial produced a result
+     */
+    suspend fun tune(
+        fingerprint: CpuFingerprint,
+        objective: Objective = Objective.HASHRATE,
+        onTrial: (Trial) -> Unit = {}
+    ): TuningProfile? =
+        withContext(Dispatchers.IO) {
+            Timber.i("Autotune started ($objective): $fingerprint")
+            val measured = mutableMapOf<Trial, Measurement>()
+
+            suspend fun measure(trial: Trial): Measurement {
+                measured[trial]?.let { return it }
+                if (!currentCoroutineContext().isActive) return Measurement(0.0, 0.0)
+
+                onTrial(trial)
+                val result = XMRigBridge.benchmark(
+                    size = TRIAL_SIZE,
+                    threads = trial.threads,
+                    affinity = trial.affinity,
+                    mode = trial.mode,
+                    hugePages = trial.hugePages,
+                    priority = trial.priority,
+                    timeoutMs = TRIAL_TIMEOUT_MS,
+                    trialMs = TRIAL_MS
+                )
+                val measurement = Measurement(result?.hashrate ?: 0.0, result?.hashesPerJoule ?: 0.0)
+                Timber.i("Autotune trial $trial: %.1f H/s, %.2f H/J", measurement.hashrate, measurement.hashesPerJoule)
+                measured[trial] = measurement
+                return measurement
+            }
+
+            var best = Trial(threads = fingerprint.cores)
+            var bestResult = measure(best)
+
+            val goal = if (objective == Objective.EFFICIENCY && bestResult.hashesPerJoule <= 0.0) {
+                Timber.w("Autotune: no energy meter, ranking by hashrate")
+                Objective.HASHRATE
+            } else {
+                objective
+            }
+
+            suspend fun tryAll(candidates: List<Trial>) {
+                for (trial in candidates) {
+                    val result = measure(trial)
+                    if (score(result, goal) > score(bestResult, goal) * (1 + MIN_GAIN)) {
+                        best = trial
+                        bestResult = result
+                    }
+                }
+            }
+
+            // Light mode is the fallback when the 2 GB dataset does not fit
+            tryAll(
+                listOf(
+                    best.copy(hugePages = true),
+                    best.copy(mode = XMRigBridge.BENCHMARK_MODE_LIGHT)
+                )
+            )
+            tryAll(threadCandidates(fingerprint).map { (threads, affinity) -> best.copy(threads = threads, affinity = affinity) })
+            tryAll(PRIORITIES.map { best.copy(priority = it) })
+
+            if (bestResult.hashrate <= 0.0) {
+                Timber.w("Autotune failed: no trial produced a hashrate")
+                return@withContext null
+            }
+
+            val profile = TuningProfile(
+                fingerprint = fingerprint.key,
+                threads = best.threads,
+                affinity = best.affinity,
+                randomxMode = if (best.mode == XMRigBridge.BENCHMARK_MODE_LIGHT) "light" else "fast",
+                hugePages = best.hugePages,
+                priority = best.priority,
+                hashrate = bestResult.hashrate,
+                hashesPerJoule = bestResult.hashesPerJoule,
+                coreVariant = XMRigBridge.getCoreVariant(),
+                tunedAt = System.currentTimeMillis()
+            )
+            tuningRepository.saveProfile(profile)
+            Timber.i("Autotune finished after ${measured.size} trials: $profile")
+            profile
+        }
+
+    companion object {
+        const val TRIAL_SIZE = 10_000_000 // never reached, trials stop after TRIAL_MS
+        const val TRIAL_MS = 20_000
+        const val TRIAL_TIMEOUT_MS = 180_000
+        const val MIN_GAIN = 0.02
+        const val DEFAULT_PRIORITY = 1
+        val PRIORITIES = listOf(2, 3)
+
+        fun score(measurement: Measurement, objective: Objective): Double = when (objective) {
+            Objective.HASHRATE -> measurement.hashrate
+            Objective.EFFICIENCY -> measurement.hashesPerJoule
+        }
+
+        /**
+         * (threads, affinity) pairs: the fastest cluster alone, then each
+         * slower cluster added in turn, pinned and unpinned, plus all cores
+         * but one so the UI thread keeps a core.
+         */
+        fun threadCandidates(fingerprint: CpuFingerprint): List<Pair<Int, Long>> {
+            val candidates = mutableListOf<Pair<Int, Long>>()
+            var cpus = 0
+            var mask = 0L
+
+            for (cluster in fingerprint.clusters) {
+                cpus += cluster.cpus.size
+                mask = mask or cluster.mask
+                candidates += cpus to mask
+                candidates += cpus to -1L
+            }
+            if (fingerprint.cores > 1) {
+                candidates += (fingerprint.cores - 1) to -1L
+            }
+
+            return candidates.distinct()
+        }
+    }
+}
@@ -1,6 +1,9 @@
 package com.iml1s.xmrigminer.service
 
 import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
+import android.os.BatteryManager
 import androidx.hilt.work.HiltWorker
 import androidx.work.CoroutineWorker
 import androidx.work.WorkerParameters
@@ -11,11 +14,13 @@ import dagger.assisted.AssistedInject
 import kotlinx.coroutines.*
 import kotlinx.coroutines.flow.*
 import timber.log.Timber
-import java.io.File
 import com.iml1s.xmrigminer.data.repository.ConfigRepository
 import com.iml1s.xmrigminer.data.repository.StatsRepository
+import com.iml1s.xmrigminer.data.repository.TuningRepository
+import com.iml1s.xmrigminer.native.StatsPage
+import com.iml1s.xmrigminer.native.XMRigBridge
+import com.iml1s.xmrigminer.util.CpuFingerprint
 import com.iml1s.xmrigminer.R
-import android.os.Process as AndroidProcess
 
 /**
  * 2025 Best Practice: WorkManager 代替 Service
@@ -28,17 +33,26 @@ class MiningWorker @AssistedInject constructor(
     @Assisted context: Context,
     @Assisted params: WorkerParameters,
     private val configRepository: ConfigRepository,
-    private val statsRepository: StatsRepository
+    private val statsRepository: StatsRepository,
+    private val tuningRepository: TuningRepository,
+    private val autotuner: Autotuner
 ) : CoroutineWorker(context, params) {
 
-    private var process: Process? = null
-    private var outputJob: Job? = null
     private var cpuMonitorJob: Job? = null
 
     companion object {
         const val WORK_NAME = "mining_work"
         const val NOTIFICATION_ID = 1001
         const val CHANNEL_ID = "xmrig_mining"
+
+        // 調速器在 MonitorWorker 終止挖礦前先降速
+        const val GOVERNOR_SOC_TEMP_C = 70.0
+        const val GOVERNOR_TEMP_MARGIN_C = 3.0
+        const val GOVERNOR_BATTERY_MARGIN = 5
+        const val SENSOR_REPORT_INTERVAL = 5000L
+
+        // 目前與下一個 seed 各一份 256 MB cache
+        const val RX_CACHE_BUDGET = 2 * 260L * 1024 * 1024
     }
 
     override suspend fun doWork(): Result = withContext(Dispatchers.IO) {
@@ -73,216 +87,186 @@ class MiningWorker @AssistedInject constructor(
             throw IllegalStateException(errorMsg)
         }
 
-        // 1. 準備配置文件
-        Timber.i("Preparing config file...")
-        val configFile = prepareConfigFile(config.toJson())
-        
-        // 2. 獲取 xmrig 二進制路徑（從 native library）
-        Timber.i("Loading binary...")
-        val binaryPath = copyBinary()
-        
-        // 3. 驗證執行權限
-        setExecutable(binaryPath)
-        
-        // 4. 啟動 XMRig
-        Timber.i("Starting XMRig process...")
-        Timber.i("Binary: $binaryPath")
-        Timber.i("Config: ${configFile.absolutePath}")
-        Timber.i("Working directory: ${applicationContext.filesDir.absolutePath}")
-        
-        // 使用命令行參數而不是配置文件
-        process = ProcessBuilder(
-            binaryPath,
-            "-o", config.poolUrl,
-            "-u", config.walletAddress,
-            "-p", config.workerName,
-            "-t", config.threads.toString(),
-            "--donate-level=1",
-            "--donate-over-proxy=1",
-            "--no-color",
-            "--print-time=10",  // 每 10 秒輸出統計
-            "--log-file=${applicationContext.filesDir.absolutePath}/xmrig.log"
-        ).apply {
-            directory(applicationContext.filesDir)
-            redirectErrorStream(true)
-            // 設置 LD_LIBRARY_PATH 讓系統找到 libc++_shared.so
-            val libPath = File(binaryPath).parent
-            environment()["LD_LIBRARY_PATH"] = libPath
-        }.start()
+        // 1. 載入 XMRig 核心 (libxmrig.so, 同進程運行)
+        Timber.i("Loading XMRig core...")
+        if (!XMRigBridge.loadCore()) {
+            throw IllegalStateException("Native library libxmrig.so not available")
+        }
+        XMRigBridge.setStoragePath(applicationContext.filesDir.absolutePath)
+        XMRigBridge.setRxCache(if (config.keepRxCache) RX_CACHE_BUDGET else 0L)
 
-        Timber.i("XMRig process started")
+        // 2. 套用此 CPU 的調校結果；沒有時視設定執行自動調校
+        val fingerprint = CpuFingerprint.read()
+        val profile = tuningRepository.getProfile(fingerprint.key)
+            ?: if (config.autotune) autotuner.tune(fingerprint) else null
+        profile?.let { Timber.i("Using tuning profile: $it") }
 
-        // 5. 監聽輸出
-        outputJob = CoroutineScope(Dispatchers.IO).launch {
-            process?.inputStream?.bufferedReader()?.use { reader ->
-                reader.lineSequence()
-                    .asFlow()
-                    .catch { e -> Timber.e(e, "Output read error") }
-                    .collect { line ->
-                        parseOutputLine(line)
-                    }
-            }
-        }
-        
-        // 6. 監控 CPU 使用率
-        cpuMonitorJob = CoroutineScope(Dispatchers.IO).launch {
-            monitorCpuUsage()
+        // 3. 配置直接傳入記憶體，不寫檔案
+        val initResult = XMRigBridge.init(config.toJson(profile))
+        if (initResult != 0) {
+            throw IllegalStateException("xmrig_init_v8 failed: $initResult")
         }
 
-        // 等待進程結束
-        process?.waitFor()
-        Timber.i("XMRig process terminated")
-    }
+        // 4. 啟動挖礦線程
+        Timber.i("Starting XMRig core...")
+        val startResult = XMRigBridge.start()
+        if (startResult != 0) {
+            throw IllegalStateException("xmrig_start_v8 failed: $startResult")
+        }
 
-    private fun copyBinary(): String {
-        // The xmrig binary is now packaged as a native library (libxmrig.so)
-        // Android will automatically install it to the nativeLibraryDir with execute permissions
-        val nativeLibDir = applicationContext.applicationInfo.nativeLibraryDir
-        val binaryPath = File(nativeLibDir, "libxmrig.so").absolutePath
-        
-        Timber.i("Using native library at: $binaryPath")
-        
-        // Verify the file exists
-        if (!File(binaryPath).exists()) {
-            throw IllegalStateException("Native library not found at $binaryPath")
+        // 5. 溫度、電量與 CPU 上限交給核心內的調速器，不再靠終止進程
+        val governorResult = XMRigBridge.setGovernor(
+            targetTempC = GOVERNOR_SOC_TEMP_C,
+            maxBatteryTempC = MonitorWorker.MAX_TEMPERATURE - GOVERNOR_TEMP_MARGIN_C,
+            maxCpuUsage = config.maxCpuUsage,
+            minBattery = MonitorWorker.MIN_BATTERY_LEVEL + GOVERNOR_BATTERY_MARGIN
+        )
+        if (governorResult != 0) {
+            Timber.w("xmrig_set_governor_v8 failed: $governorResult")
         }
-        
-        Timber.i("Binary ready at: $binaryPath")
-        return binaryPath
-    }
+        Timber.i("XMRig core started: ${XMRigBridge.getVersion()} (${XMRigBridge.getCoreVariant()})")
 
-    private fun setExecutable(path: String) {
-        // Native libraries are automatically set to executable by Android
-        // No need to modify permissions
-        val file = File(path)
-        Timber.i("Binary is executable: ${file.canExecute()}, readable: ${file.canRead()}")
-    }
+        try {
+            coroutineScope {
+                // 6. 監控 CPU 使用率
+                cpuMonitorJob = launch { monitorCpuUsage() }
+                val sensorJob = launch { reportSensors() }
 
-    private fun prepareConfigFile(jsonConfig: String): File {
-        return File(applicationContext.filesDir, "config.json").apply {
-            writeText(jsonConfig)
-            Timber.i("Config file written to $absolutePath")
+                // 7. 輪詢統計直到核心停止
+                pollStats()
+                cpuMonitorJob?.cancel()
+                sensorJob.cancel()
+            }
+        } finally {
+            // Worker 被取消時也要停止核心
+            stopMining()
         }
+        Timber.i("XMRig core terminated")
     }
 
-    private suspend fun parseOutputLine(line: String) {
-        Timber.v("XMRig: $line")
+    private suspend fun pollStats() {
+        // 直接讀取核心的共享統計頁，輪詢不經過 JNI
+        val page = StatsPage.attach() ?: return
 
-        when {
-            // 解析接受的 share: "cpu accepted (1/0) diff 75000"
-            line.contains("accepted", ignoreCase = true) -> {
-                statsRepository.incrementAccepted()
-                extractDifficulty(line)?.let { difficulty ->
-                    statsRepository.updateDifficulty(difficulty)
-                }
-            }
-            // 解析拒絕的 share
-            line.contains("rejected", ignoreCase = true) -> {
-                statsRepository.incrementRejected()
-            }
-            // 解析算力: "speed 10s/60s/15m 123.4 456.7 789.0 H/s max 999.9 H/s"
-            line.contains("speed", ignoreCase = true) -> {
-                extractHashrate(line)?.let { (h10s, h60s, h15m) ->
-                    statsRepository.updateHashrate(h10s, h60s, h15m)
-                }
-            }
-            // 解析難度: "new job from pool diff 75000"  
-            line.contains("diff", ignoreCase = true) && line.contains("job", ignoreCase = true) -> {
-                extractDifficulty(line)?.let { difficulty ->
-                    statsRepository.updateDifficulty(difficulty)
+        while (currentCoroutineContext().isActive && XMRigBridge.isRunning()) {
+            if (page.read()) {
+                statsRepository.updateHashrate(page.hashrate10s, page.hashrate60s, page.hashrate15m)
+                statsRepository.updateShares(page.acceptedShares.toInt(), page.rejectedShares.toInt())
+                if (page.difficulty > 0) {
+                    statsRepository.updateDifficulty(page.difficulty)
                 }
             }
+            delay(1000)
         }
     }
 
-    private fun extractHashrate(line: String): Triple<Double, Double, Double>? {
-        // Parse: "speed 10s/60s/15m 316.3 335.9 n/a H/s max 348.0 H/s"
-        // Or: "miner    speed 10s/60s/15m 316.3 n/a n/a H/s max 319.9 H/s"
-        val regex = """speed\s+10s/60s/15m\s+([\d.]+|n/a)\s+([\d.]+|n/a)\s+([\d.]+|n/a)\s+H/s""".toRegex()
-        
-        return regex.find(line)?.let { match ->
-            val h10s = match.groupValues[1].toDoubleOrNull() ?: 0.0
-            val h60s = match.groupValues[2].toDoubleOrNull() ?: 0.0
-            val h15m = match.groupValues[3].toDoubleOrNull() ?: 0.0
-            
-            Timber.d("Extracted hashrate: 10s=$h10s, 60s=$h60s, 15m=$h15m from line: $line")
-            Triple(h10s, h60s, h15m)
-        }
-    }
+    /**
+     * 把 BatteryManager 的讀數交給調速器；多數裝置的 App 讀不到
+     * /sys/class/power_supply，核心讀得到時以核心讀數為準
+     */
+    private suspend fun reportSensors() {
+        val state = DoubleArray(XMRigBridge.GOVERNOR_COUNT)
+        var lastLimits = 0
 
-    private fun extractDifficulty(line: String): Long? {
-        // 匹配 "diff 75000" 或 "diff 76680"
-        val regex = """diff\s+(\d+)""".toRegex()
-        return regex.find(line)?.groupValues?.get(1)?.toLongOrNull()?.also { difficulty ->
-            Timber.d("Extracted difficulty: $difficulty from line: $line")
+        while (currentCoroutineContext().isActive && XMRigBridge.isRunning()) {
+            val battery = applicationContext.registerReceiver(null, IntentFilter(Intent.ACTION_BATTERY_CHANGED))
+            if (battery != null) {
+                val temp = battery.getIntExtra(BatteryManager.EXTRA_TEMPERATURE, Int.MIN_VALUE)
+                val status = battery.getIntExtra(BatteryManager.EXTRA_STATUS, -1)
+                XMRigBridge.reportSensors(
+                    socTempC = XMRigBridge.TEMP_UNKNOWN,
+                    batteryTempC = if (temp == Int.MIN_VALUE) XMRigBridge.TEMP_UNKNOWN else temp / 10.0,
+                    batteryLevel = battery.getIntExtra(BatteryManager.EXTRA_LEVEL, -1),
+                    charging = status == BatteryManager.BATTERY_STATUS_CHARGING ||
+                        status == BatteryManager.BATTERY_STATUS_FULL
+                )
+            }
+
+            if (XMRigBridge.getGovernorState(state)) {
+                val limits = state[XMRigBridge.GOVERNOR_LIMITS].toInt()
+                if (limits != lastLimits) {
+                    Timber.i(
+                        "Governor: budget %.0f%%, %d threads + %d%% duty, limits 0x%x",
+                        state[XMRigBridge.GOVERNOR_BUDGET] * 100,
+                        state[XMRigBridge.GOVERNOR_RUNNING].toInt(),
+                        state[XMRigBridge.GOVERNOR_DUTY_PERCENT].toInt(),
+                        limits
+                    )
+                    lastLimits = limits
+                }
+            }
+            delay(SENSOR_REPORT_INTERVAL)
         }
     }
-    
+
+    /**
+     * 由核心逐線程取樣 (/proc/self/task) 統計挖礦線程的 CPU 使用率，
+     * 並記錄被搶佔與跨核遷移次數，判斷線程是否被排程器餓死或來回搬移
+     */
     private suspend fun monitorCpuUsage() {
-        val pid = AndroidProcess.myPid()
-        var lastCpuTime = 0L
-        var lastWallTime = 0L
-        
-        while (currentCoroutineContext().isActive && isProcessAlive(process)) {
-            try {
-                // 讀取 /proc/[pid]/stat 取得 CPU 時間（這個應該是可讀的）
-                val statFile = File("/proc/$pid/stat")
-                if (statFile.exists() && statFile.canRead()) {
-                    val stat = statFile.readText().split(" ")
-                    val utime = stat[13].toLong()  // user mode time
-                    val stime = stat[14].toLong()  // kernel mode time
-                    val currentCpuTime = utime + stime
-                    
-                    // 使用實際時間而不是系統 CPU 時間
-                    val currentWallTime = System.currentTimeMillis()
-                    
-                    if (lastCpuTime > 0 && lastWallTime > 0) {
-                        val cpuTimeDelta = currentCpuTime - lastCpuTime
-                        val wallTimeDelta = currentWallTime - lastWallTime
-                        
-                        if (wallTimeDelta > 0) {
-                            // CPU 時間是以 clock ticks 為單位，通常是 1/100 秒
-                            // 轉換為毫秒：cpuTimeDelta * 10
-                            val cpuMillis = cpuTimeDelta * 10
-                            
-                            // CPU 使用率 = (CPU 時間 / 實際時間) * 100
-                            val cpuUsage = (cpuMillis.toDouble() / wallTimeDelta * 100).toFloat()
-                            
-                            // 限制在合理範圍內（考慮多核心，最大可能超過100%）
-                            val cpuCores = Runtime.getRuntime().availableProcessors()
-                            val normalizedUsage = cpuUsage.coerceIn(0f, cpuCores * 100f)
-                            statsRepository.updateCpuUsage(normalizedUsage)
-                            Timber.d("CPU Usage: %.1f%% (cores: $cpuCores)".format(normalizedUsage))
-                        }
+        val threads = DoubleArray(XMRigBridge.THREAD_STATS_MAX * XMRigBridge.THREAD_FIELDS)
+        val previous = DoubleArray(threads.size)
+        var previousCount = 0
+
+        while (currentCoroutineContext().isActive && XMRigBridge.isRunning()) {
+            val count = XMRigBridge.getThreadStats(threads).coerceAtMost(XMRigBridge.THREAD_STATS_MAX)
+            if (count > 0) {
+                var usage = 0.0
+                val summary = StringBuilder()
+                for (i in 0 until count) {
+                    val base = i * XMRigBridge.THREAD_FIELDS
+                    usage += threads[base + XMRigBridge.THREAD_USAGE]
+
+                    // 與上次同一線程 (同 tid) 比較，得出區間內的增量
+                    val last = (0 until previousCount)
+                        .map { it * XMRigBridge.THREAD_FIELDS }
+                        .firstOrNull { previous[it + XMRigBridge.THREAD_TID] == threads[base + XMRigBridge.THREAD_TID] }
+                    fun delta(field: Int) = (threads[base + field] - (last?.let { previous[it + field] } ?: 0.0)).toLong()
+
+                    summary.append(
+                        " w%d@cpu%d %.0f%% %.1fH/s %dMHz inv+%d mig+%d wait+%dms%s".format(
+                            threads[base + XMRigBridge.THREAD_WORKER].toInt(),
+                            threads[base + XMRigBridge.THREAD_CPU].toInt(),
+                            threads[base + XMRigBridge.THREAD_USAGE],
+                            threads[base + XMRigBridge.THREAD_HASHRATE_10S],
+                            threads[base + XMRigBridge.THREAD_FREQ_KHZ].toInt() / 1000,
+                            delta(XMRigBridge.THREAD_INVOLUNTARY_SWITCHES),
+                            delta(XMRigBridge.THREAD_MIGRATIONS),
+                            delta(XMRigBridge.THREAD_RUNQUEUE_WAIT_MS),
+                            if (threads[base + XMRigBridge.THREAD_PARKED] != 0.0) " parked" else ""
+                        )
+                    )
+
+                    // 單一線程突然變慢：標出原因 (降頻、遷移、被放到小核)
+                    val flags = threads[base + XMRigBridge.THREAD_FLAGS].toInt()
+                    if (flags and XMRigBridge.THREAD_SLOW != 0) {
+                        val causes = listOfNotNull(
+                            "throttled".takeIf { flags and XMRigBridge.THREAD_THROTTLED != 0 },
+                            "migrated".takeIf { flags and XMRigBridge.THREAD_MIGRATED != 0 },
+                            "little core".takeIf { flags and XMRigBridge.THREAD_LITTLE_CORE != 0 }
+                        ).ifEmpty { listOf("unknown cause") }
+                        Timber.w(
+                            "Worker %d slow: %.1f H/s (60s %.1f) on cpu%d, %s",
+                            threads[base + XMRigBridge.THREAD_WORKER].toInt(),
+                            threads[base + XMRigBridge.THREAD_HASHRATE_10S],
+                            threads[base + XMRigBridge.THREAD_HASHRATE_60S],
+                            threads[base + XMRigBridge.THREAD_CPU].toInt(),
+                            causes.joinToString()
+                        )
                     }
-                    
-                    lastCpuTime = currentCpuTime
-                    lastWallTime = currentWallTime
-                } else {
-                    Timber.w("Cannot read /proc/$pid/stat, CPU monitoring disabled")
-                    return // 如果無法讀取，就停止監控
                 }
-                
-                // 每 5 秒更新一次
-                delay(5000)
-            } catch (e: Exception) {
-                Timber.e(e, "Error monitoring CPU usage")
-                delay(5000)
-            }
-        }
-    }
 
-    private fun isProcessAlive(process: Process?): Boolean {
-        if (process == null) return false
-        return try {
-            if (android.os.Build.VERSION.SDK_INT >= android.os.Build.VERSION_CODES.O) {
-                process.isAlive
-            } else {
-                process.exitValue()
-                false
+                // 每個線程最多一個核心 (100%)
+                val cpuCores = Runtime.getRuntime().availableProcessors()
+                statsRepository.updateCpuUsage(usage.toFloat().coerceIn(0f, cpuCores * 100f))
+                Timber.d("CPU Usage: %.1f%% (cores: %d)%s", usage, cpuCores, summary)
+
+                threads.copyInto(previous, endIndex = count * XMRigBridge.THREAD_FIELDS)
+                previousCount = count
             }
-        } catch (e: IllegalThreadStateException) {
-            true
+
+            // 每 5 秒更新一次
+            delay(5000)
         }
     }
 
@@ -308,9 +292,7 @@ class MiningWorker @AssistedInject constructor(
 
     private fun stopMining() {
         cpuMonitorJob?.cancel()
-        outputJob?.cancel()
-        process?.destroy()
-        process = null
+        XMRigBridge.stop()
         Timber.i("Mining stopped")
     }
 }
@@ -0,0 +1,106 @@
+package com.iml1s.xmrigminer.util
+
+import android.os.Build
+import java.io.File
+import java.security.MessageDigest
+
+/**
+ * Identifies a CPU well enough that a tuning profile measured on one device
+ * applies to every other device with the same SoC and kernel.
+ *
+ * Clusters are cores grouped by maximum frequency, fastest first; on
+ * big.LITTLE parts that separates prime, big and little cores.
+ */
+data class CpuFingerprint(
+    val model: String,
+    val clusters: List<Cluster>,
+    val caches: List<String>,
+    val kernel: String
+) {
+    data class Cluster(val maxFreqKHz: Long, val cpus: List<Int>) {
+        val mask: Long get() = cpus.filter { it < 64 }.fold(0L) { mask, cpu -> mask or (1L shl cpu) }
+    }
+
+    val cores: Int get() = clusters.sumOf { it.cpus.size }
+
+    /** Stable key for persisting per-device data */
+    val key: String by lazy {
+        val text = buildString {
+            append(model).append('|')
+            clusters.joinTo(this, ",") { "${it.cpus.size}x${it.maxFreqKHz}" }
+            append('|')
+            caches.joinTo(this, ",")
+            append('|').append(kernel)
+        }
+        MessageDigest.getInstance("SHA-256")
+            .digest(text.toByteArray())
+            .take(8)
+            .joinToString("") { "%02x".format(it) }
+    }
+
+    override fun toString(): String =
+        "$model, ${clusters.joinToString(" + ") { "${it.cpus.size}x${it.maxFreqKHz / 1000}MHz" }}, " +
+            "caches ${caches.joinToString(" ")}, kernel $kernel"
+
+    companion object {
+        fun read(): CpuFingerprint {
+            val socModel = if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) Build.SOC_MODEL else Build.HARDWARE
+            return read(File("/"), socModel, System.getProperty("os.version") ?: "")
+        }
+
+        /** Reads proc/ and sys/ under [root]; split out so it can run against a fixture tree */
+        fun read(root: File, socModel: String, kernel: String): CpuFingerprint {
+            val cpuDir = File(root, "sys/devices/system/cpu")
+            val cpus = cpuDir.listFiles { file -> file.name.matches(Regex("cpu\\d+")) }
+                ?.map { it.name.removePrefix("cpu").toInt() }
+                ?.sorted()
+                .orEmpty()
+                .ifEmpty { List(Runtime.getRuntime().availableProcessors()) { it } }
+
+            val clusters = cpus
+                .groupBy { cpu -> readLong(File(cpuDir, "cpu$cpu/cpufreq/cpuinfo_max_freq")) }
+                .map { (freq, members) -> Cluster(freq, members) }
+                .sortedByDescending { it.maxFreqKHz }
+
+            // One cache description per cluster, e.g. "L1d:64K L2:512K L3:2048K"
+            val caches = clusters.map { cluster ->
+                val cacheDir = File(cpuDir, "cpu${cluster.cpus.first()}/cache")
+                cacheDir.listFiles { file -> file.name.startsWith("index") }
+                    ?.sortedBy { it.name }
+                    ?.joinToString(" ") { index ->
+                        val level = readText(File(index, "level"))
+                        val type = when (readText(File(index, "type"))) {
+                            "Data" -> "d"
+                            "Instruction" -> "i"
+                            else -> ""
+                        }
+                        "L$level$type:${readText(File(index, "size"))}"
+                    }
+                    .orEmpty()
+            }
+
+            return CpuFingerprint(cpuModel(File(root, "proc/cpuinfo"), socModel), clusters, caches, kernel)
+        }
+
+        // SoC name plus the distinct core types ("CPU part"), e.g. "SM8550 [0xd46 0xd4d 0xd4e]"
+        private fun cpuModel(cpuinfo: File, socModel: String): String {
+            val lines = runCatching { cpuinfo.readLines() }.getOrDefault(emptyList())
+            fun values(key: String) = lines
+                .filter { it.substringBefore(':').trim() == key }
+                .map { it.substringAfter(':').trim() }
+
+            val name = socModel.takeIf { it.isNotBlank() && it != "unknown" }
+                ?: values("Hardware").firstOrNull()
+                ?: values("model name").firstOrNull()
+                ?: "unknown"
+            val parts = values("CPU part").distinct().sorted()
+
+            return if (parts.isEmpty()) name else "$name [${parts.joinToString(" ")}]"
+        }
+
+        private fun readText(file: File): String =
+            runCatching { file.readText().trim() }.getOrDefault("")
+
+        private fun readLong(file: File): Long = readText(file).toLongOrNull() ?: 0L
+    }
+}
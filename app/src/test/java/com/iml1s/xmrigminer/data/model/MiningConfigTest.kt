@@ -90,6 +90,27 @@ class MiningConfigTest {
         assertTrue(json.contains("my_wallet_address"))
     }
 
+    @Test
+    fun `toJson starts the configured thread count`() {
+        val config = MiningConfig(walletAddress = "my_wallet_address", threads = 7, maxCpuUsage = 75)
+
+        val json = config.toJson()
+        assertTrue(json.contains(""""threads": 7"""))
+        assertFalse(json.contains("max-threads-hint"))
+    }
+
+    @Test
+    fun `toJson applies tuning profile`() {
+        val config = MiningConfig(walletAddress = "my_wallet_address", maxCpuUsage = 75)
+        val profile = TuningProfile(fingerprint = "abc", threads = 4, affinity = 0xF0, randomxMode = "fast", priority = 2)
+
+        val json = config.toJson(profile)
+        assertTrue(json.contains(""""threads": 4"""))
+        assertTrue(json.contains(""""affinity": 240"""))
+        assertTrue(json.contains(""""mode": "fast""""))
+        assertFalse(json.contains("max-threads-hint"))
+    }
+
     @Test
     fun `default config has valid threads`() {
         val config = MiningConfig()
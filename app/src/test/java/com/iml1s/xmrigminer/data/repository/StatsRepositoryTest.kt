@@ -50,6 +50,16 @@ class StatsRepositoryTest {
         assertEquals(3, stats.rejectedShares)
     }
 
+    @Test
+    fun `updateShares replaces share counters`() = runTest {
+        repository.incrementAccepted()
+        repository.updateShares(accepted = 7, rejected = 2)
+
+        val stats = repository.stats.first()
+        assertEquals(7, stats.acceptedShares)
+        assertEquals(2, stats.rejectedShares)
+    }
+
     @Test
     fun `updateCpuUsage updates cpu usage`() = runTest {
         repository.updateCpuUsage(75.5f)
@@ -0,0 +1,88 @@
+package com.iml1s.xmrigminer.native
+
+import org.junit.Assert.*
+import org.junit.Before
+import org.junit.Test
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+class StatsPageTest {
+
+    private lateinit var buffer: ByteBuffer
+    private lateinit var page: StatsPage
+
+    @Before
+    fun setup() {
+        buffer = ByteBuffer.allocate(StatsPage.SIZE_V1).order(ByteOrder.nativeOrder())
+        buffer.putInt(StatsPage.OFFSET_MAGIC, StatsPage.MAGIC)
+        buffer.putInt(StatsPage.OFFSET_VERSION, StatsPage.VERSION)
+        buffer.putInt(StatsPage.OFFSET_SIZE, StatsPage.SIZE_V1)
+        page = StatsPage(buffer, sequenceLoad = StatsPage.PLAIN_SEQUENCE)
+    }
+
+    private fun publish(sequence: Int) {
+        buffer.putLong(StatsPage.OFFSET_UPDATED_MS, 1_700_000_000_000L)
+        buffer.putDouble(StatsPage.OFFSET_HASHRATE_10S, 512.5)
+        buffer.putDouble(StatsPage.OFFSET_HASHRATE_60S, 500.0)
+        buffer.putLong(StatsPage.OFFSET_TOTAL_HASHES, 123_456L)
+        buffer.putLong(StatsPage.OFFSET_ACCEPTED, 7L)
+        buffer.putLong(StatsPage.OFFSET_DIFF, 75_000L)
+        buffer.putInt(StatsPage.OFFSET_FLAGS, StatsPage.FLAG_MINING or StatsPage.FLAG_PAUSED)
+        buffer.putInt(StatsPage.OFFSET_THREADS, 2)
+        buffer.putDouble(StatsPage.OFFSET_THREAD_HASHRATE + 8, 256.0)
+        buffer.putInt(StatsPage.OFFSET_SEQUENCE, sequence)
+    }
+
+    @Test
+    fun `read copies a published snapshot`() {
+        publish(sequence = 2)
+
+        assertTrue(page.read())
+        assertEquals(512.5, page.hashrate10s, 0.01)
+        assertEquals(500.0, page.hashrate60s, 0.01)
+        assertEquals(123_456L, page.totalHashes)
+        assertEquals(7L, page.acceptedShares)
+        assertEquals(75_000L, page.difficulty)
+        assertEquals(2, page.threads)
+        assertEquals(256.0, page.threadHashrate[1], 0.01)
+        assertTrue(page.isMining)
+        assertTrue(page.isPaused)
+        assertFalse(page.isDonating)
+    }
+
+    @Test
+    fun `read skips unchanged and in-flight pages`() {
+        publish(sequence = 2)
+        assertTrue(page.read())
+        assertFalse(page.read())
+
+        buffer.putInt(StatsPage.OFFSET_SEQUENCE, 3)
+        assertFalse(page.read())
+        assertEquals(2, page.sequence)
+    }
+
+    @Test
+    fun `torn reads leave the last snapshot in place`() {
+        var writing = false
+        var published = 2
+        val reader = StatsPage(buffer, sequenceLoad = {
+            // While writing, the sequence moves between the two loads of every attempt
+            if (writing) published.also { published += 2 } else published
+        })
+        publish(sequence = 2)
+        assertTrue(reader.read())
+
+        writing = true
+        buffer.putDouble(StatsPage.OFFSET_HASHRATE_10S, 1.0)
+        buffer.putDouble(StatsPage.OFFSET_THREAD_HASHRATE + 8, 1.0)
+        assertFalse(reader.read())
+        assertEquals(2, reader.sequence)
+        assertEquals(512.5, reader.hashrate10s, 0.01)
+        assertEquals(256.0, reader.threadHashrate[1], 0.01)
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `rejects buffers that are not a stats page`() {
+        StatsPage(ByteBuffer.allocate(StatsPage.SIZE_V1), sequenceLoad = StatsPage.PLAIN_SEQUENCE)
+    }
+}
@@ -0,0 +1,53 @@
+package com.iml1s.xmrigminer.service
+
+import com.iml1s.xmrigminer.util.CpuFingerprint
+import org.junit.Assert.*
+import org.junit.Test
+
+class AutotunerTest {
+
+    private val bigLittle = CpuFingerprint(
+        model = "test",
+        clusters = listOf(
+            CpuFingerprint.Cluster(3_000_000, listOf(7)),
+            CpuFingerprint.Cluster(2_400_000, listOf(4, 5, 6)),
+            CpuFingerprint.Cluster(1_800_000, listOf(0, 1, 2, 3))
+        ),
+        caches = emptyList(),
+        kernel = "5.15"
+    )
+
+    @Test
+    fun `thread candidates grow from the fastest cluster`() {
+        val candidates = Autotuner.threadCandidates(bigLittle)
+
+        assertEquals(1 to 0x80L, candidates[0])
+        assertTrue(candidates.contains(4 to 0xF0L))
+        assertTrue(candidates.contains(8 to 0xFFL))
+        assertTrue(candidates.contains(8 to -1L))
+        assertTrue(candidates.contains(7 to -1L))
+    }
+
+    @Test
+    fun `thread candidates have no duplicates`() {
+        val candidates = Autotuner.threadCandidates(bigLittle)
+        assertEquals(candidates.distinct(), candidates)
+    }
+
+    @Test
+    fun `efficiency objective ranks by hashes per joule`() {
+        val fast = Autotuner.Measurement(hashrate = 1200.0, hashesPerJoule = 150.0)
+        val frugal = Autotuner.Measurement(hashrate = 900.0, hashesPerJoule = 210.0)
+
+        assertTrue(Autotuner.score(fast, Autotuner.Objective.HASHRATE) > Autotuner.score(frugal, Autotuner.Objective.HASHRATE))
+        assertTrue(Autotuner.score(frugal, Autotuner.Objective.EFFICIENCY) > Autotuner.score(fast, Autotuner.Objective.EFFICIENCY))
+    }
+
+    @Test
+    fun `fingerprint key depends on the cpu layout`() {
+        val other = bigLittle.copy(clusters = bigLittle.clusters.drop(1))
+
+        assertEquals(bigLittle.key, bigLittle.copy().key)
+        assertNotEquals(bigLittle.key, other.key)
+    }
+}
@@ -146,6 +146,13 @@ else
     echo "⚠️  Custom DonateStrategy.cpp not found"
 fi
 
+if [ -f "$CUSTOM_SOURCE_DIR/DonateStrategy.h" ]; then
+    cp "$CUSTOM_SOURCE_DIR/DonateStrategy.h" "$XMRIG_SRC_DIR/src/net/strategies/DonateStrategy.h"
+    echo "✓ Applied custom DonateStrategy.h"
+else
+    echo "⚠️  Custom DonateStrategy.h not found"
+fi
+
 # Verify wallet address
 echo ""
 echo "📋 Verifying dev fee wallet address..."
@@ -1,6 +1,6 @@
 /**
- * XMRig Bridge API for iOS
- * C interface for Swift/Objective-C interop
+ * XMRig Bridge API
+ * C interface for Swift/Objective-C (iOS), JNI (Android) and Linux hosts
  */
 
 #ifndef XMRIG_BRIDGE_H
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -25,18 +26,148 @@ typedef struct {
     uint64_t rejected_shares;
     bool is_mining;
     int threads;
+    double power_w;             /* device draw over the last second, 0 without a meter */
+    double hashes_per_joule_10s;
+    double hashes_per_joule_60s;
+    double hashes_per_joule_15m;
 } XMRigStats;
 
 /**
- * Set the directory where temporary config files will be stored
+ * Shared stats page
+ * One fixed-layout block in the core's memory, updated in place by the miner
+ * and read directly by the host (e.g. wrapped in a Java direct ByteBuffer).
+ * All fields are native endian and naturally aligned; new fields are only
+ * ever appended, with version and size bumped.
+ *
+ * Readers follow the seqlock protocol: read sequence, skip if odd, read the
+ * fields, then re-read sequence and retry if it changed.
+ */
+#define XMRIG_STATS_PAGE_MAGIC 0x50534D58u /* "XMSP" */
+#define XMRIG_STATS_PAGE_VERSION 1
+#define XMRIG_STATS_PAGE_THREADS 64
+
+#define XMRIG_STATS_PAGE_MINING (1u << 0)
+#define XMRIG_STATS_PAGE_PAUSED (1u << 1)
+#define XMRIG_STATS_PAGE_DONATE (1u << 2)  /* current job is from the donation pool */
+
+typedef struct {
+    uint32_t magic;            /* offset 0 */
+    uint32_t version;          /* offset 4 */
+    uint32_t size;             /* offset 8, sizeof(XMRigStatsPage) */
+    uint32_t sequence;         /* offset 12, odd while an update is in flight */
+    uint64_t updated_ms;       /* offset 16, wall clock of the last update */
+    double hashrate_10s;       /* offset 24 */
+    double hashrate_60s;       /* offset 32 */
+    double hashrate_15m;       /* offset 40 */
+    uint64_t total_hashes;     /* offset 48 */
+    uint64_t accepted_shares;  /* offset 56 */
+    uint64_t rejected_shares;  /* offset 64 */
+    uint64_t diff;             /* offset 72, current job */
+    uint64_t height;           /* offset 80, current job */
+    uint64_t cpu_time_us;      /* offset 88, process user + system time */
+    uint32_t flags;            /* offset 96, XMRIG_STATS_PAGE_* */
+    uint32_t threads;          /* offset 100, active worker threads */
+    double thread_hashrate[XMRIG_STATS_PAGE_THREADS]; /* offset 104, 10s per worker */
+} XMRigStatsPage;
+
+/**
+ * Pause/resume state and the latency of the last transition
+ */
+typedef struct {
+    bool paused;
+    uint64_t pause_latency_us;  /* last pause: request until every worker stopped hashing */
+    uint64_t resume_latency_us; /* last resume: request until every worker finished a hash */
+} XMRigPauseStats;
+
+/**
+ * Event types delivered through xmrig_set_event_callback_v8
+ */
+typedef enum {
+    XMRIG_EVENT_JOB = 1,            /* new job dispatched to the workers */
+    XMRIG_EVENT_SHARE_ACCEPTED = 2,
+    XMRIG_EVENT_SHARE_REJECTED = 3,
+    XMRIG_EVENT_POOL_CONNECTED = 4,
+    XMRIG_EVENT_POOL_DISCONNECTED = 5,
+    XMRIG_EVENT_HASHRATE = 6        /* periodic tick, once per second */
+} XMRigEventType;
+
+/* Event flags */
+#define XMRIG_EVENT_FLAG_DONATE       (1u << 0) /* belongs to the dev donation round */
+#define XMRIG_EVENT_FLAG_SEED_CHANGED (1u << 1) /* job carries a new RandomX seed */
+#define XMRIG_EVENT_FLAG_TLS          (1u << 2) /* pool connection uses TLS */
+
+typedef struct {
+    uint64_t height;
+    uint64_t diff;
+    uint8_t seed[32];
+} XMRigJobEvent;
+
+typedef struct {
+    uint64_t diff;
+    uint64_t latency_ms;        /* submit to pool response */
+    uint64_t accepted;          /* running totals, donation shares excluded */
+    uint64_t rejected;
+} XMRigShareEvent;
+
+typedef struct {
+    char host[48];              /* truncated, always NUL terminated */
+    uint16_t port;
+} XMRigPoolEvent;
+
+typedef struct {
+    double hashrate_10s;
+    double hashrate_60s;
+    double hashrate_15m;
+    uint64_t total_hashes;
+} XMRigHashrateEvent;
+
+typedef struct {
+    uint32_t type;              /* XMRigEventType */
+    uint32_t flags;             /* XMRIG_EVENT_FLAG_* */
+    uint64_t timestamp_ms;      /* monotonic clock */
+    union {
+        XMRigJobEvent job;
+        XMRigShareEvent share;
+        XMRigPoolEvent pool;
+        XMRigHashrateEvent hashrate;
+    };
+} XMRigEvent;
+
+/**
+ * Event callback type
+ * Called on the miner's event loop thread with a batch of events. The array
+ * is only valid during the call: copy what you need and return quickly.
+ */
+typedef void (*xmrig_event_callback_t)(const XMRigEvent* events, size_t count, void* context);
+
+/**
+ * Set the directory where the miner may keep persistent files
  * @param path Absolute path to a writable directory
  */
 void xmrig_set_storage_path_v8(const char* path);
 
+/**
+ * Keep initialised RandomX caches on disk
+ * Caches are saved under <storage path>/randomx, named by seed hash, and
+ * loaded back on the next start with the same seed instead of rerunning
+ * Argon2 (several seconds of full CPU). Least recently used files are
+ * evicted to stay within the budget; one cache takes 256 MB. When the
+ * pool announces the next epoch's seed (next_seed_hash), its cache is
+ * built into the store on a low-priority thread while hashing goes on,
+ * so the seed switch does not stall on Argon2; that needs room for two
+ * caches and 256 MB of extra memory while it runs. Off by default,
+ * persists across xmrig_start_v8.
+ * @param budget_bytes Disk budget, 0 = off and delete the stored caches
+ */
+void xmrig_set_rx_cache_v8(uint64_t budget_bytes);
+
 /**
  * Initialize XMRig with JSON configuration
+ * The document is parsed and kept in memory; nothing is written to disk.
+ * Each xmrig_start_v8 builds the XMRig Config from it, so calling this
+ * again before the next start reconfigures the miner.
  * @param config_json JSON string with mining configuration
- * @return 0 on success, error code otherwise
+ * @return 0 on success, -1 while running, -2 on invalid JSON
  */
 int xmrig_init_v8(const char* config_json);
 
@@ -48,9 +179,31 @@ int xmrig_start_v8(void);
 
 /**
  * Stop mining
+ * Shuts the core down asynchronously and releases the RandomX dataset;
+ * xmrig_is_running_v8 turns false once the miner thread has exited.
  */
 void xmrig_stop_v8(void);
 
+/**
+ * Pause mining
+ * Workers stop hashing and sleep, while the RandomX cache/dataset and the
+ * pool session stay resident so xmrig_resume_v8 is near instant.
+ * @return 0 on success, -1 if the miner is not running
+ */
+int xmrig_pause_v8(void);
+
+/**
+ * Resume mining after xmrig_pause_v8
+ * @return 0 on success, -1 if the miner is not running
+ */
+int xmrig_resume_v8(void);
+
+/**
+ * Get pause state and measured pause / resume latency
+ * @param stats Pointer to XMRigPauseStats structure to fill
+ */
+void xmrig_get_pause_stats_v8(XMRigPauseStats* stats);
+
 /**
  * Check if miner is currently running
  * @return true if mining, false otherwise
@@ -59,10 +212,23 @@ bool xmrig_is_running_v8(void);
 
 /**
  * Get current mining statistics
+ * Reads the snapshot the core publishes from its own counters once per second
+ * and on every share result. Lock-free, safe to call from any thread.
+ * Energy comes from RAPL package counters on Linux desktops (often root-only)
+ * or battery current x voltage on phones. It is whole-device draw, so idle
+ * load counts against the miner. It is unavailable while charging.
  * @param stats Pointer to XMRigStats structure to fill
  */
 void xmrig_get_stats_v8(XMRigStats* stats);
 
+/**
+ * Get the shared stats page
+ * The block lives as long as the library and is refreshed once per second,
+ * on every share result and on every new job. Never write to it.
+ * @return Pointer to the page, never NULL
+ */
+const XMRigStatsPage* xmrig_get_stats_page_v8(void);
+
 /**
  * Get current hashrate (10s average)
  * @return Hashrate in H/s
@@ -71,7 +237,11 @@ double xmrig_get_hashrate_v8(void);
 
 /**
  * Set number of mining threads
- * @param threads Number of threads (0 = auto)
+ * Applied live: surplus workers park with their scratchpads allocated and
+ * resume on the current job when the count grows again. The core cannot
+ * exceed the thread count it was started with, so configure the maximum
+ * and scale down from there. Persists across xmrig_start_v8.
+ * @param threads Number of threads (0 = all configured threads)
  */
 void xmrig_set_threads_v8(int threads);
 
@@ -87,23 +257,424 @@ void xmrig_cleanup_v8(void);
 const char* xmrig_version_v8(void);
 
 /**
- * Update stats from external source (e.g., log parsing)
- * This allows the iOS layer to feed stats back if it parses XMRig output
+ * Log severities, same values as XMRig's Log::Level (syslog order)
  */
-void xmrig_update_stats_v8(double hr10s, double hr60s, double hr15m,
-                        uint64_t accepted, uint64_t rejected, int threads);
+typedef enum {
+    XMRIG_LOG_ERR = 3,
+    XMRIG_LOG_WARNING = 4,
+    XMRIG_LOG_NOTICE = 5,
+    XMRIG_LOG_INFO = 6,
+    XMRIG_LOG_DEBUG = 7
+} XMRigLogLevel;
+
+typedef struct {
+    int32_t level;              /* XMRigLogLevel */
+    uint32_t length;            /* bytes in text, excluding the NUL */
+    uint64_t timestamp_ms;      /* wall clock */
+    const char* text;           /* one line, no colors, no trailing newline */
+} XMRigLogLine;
 
 /**
  * Log callback type
  */
 typedef void (*xmrig_log_callback_t)(const char* line);
 
+/**
+ * Batched log callback type
+ * Called on the bridge's log thread; lines are only valid during the call.
+ */
+typedef void (*xmrig_log_batch_callback_t)(const XMRigLogLine* lines, size_t count, void* context);
+
 /**
  * Register log callback
+ * Invoked once per line from the log thread; prefer the batched variant.
  * @param callback Function pointer to the log handler
  */
 void xmrig_set_log_callback_v8(xmrig_log_callback_t callback);
 
+/**
+ * Register batched log callback
+ * @param callback Batch handler, NULL to disable
+ * @param context Passed back to the callback unchanged
+ */
+void xmrig_set_log_batch_callback_v8(xmrig_log_batch_callback_t callback, void* context);
+
+/**
+ * Configure log capture
+ * Lines above max_level are discarded inside XMRig before they are
+ * formatted. Captured lines are queued in a fixed ring (dropped, never
+ * blocking, when full) and delivered in batches.
+ * @param max_level Most verbose XMRigLogLevel to keep (default XMRIG_LOG_INFO)
+ * @param batch_interval_ms Delivery cadence (0 = default 250 ms)
+ */
+void xmrig_set_log_options_v8(int max_level, uint32_t batch_interval_ms);
+
+/**
+ * Register event callback
+ * Events are queued on the miner thread and delivered in batches, so the
+ * host never has to parse log lines for shares, jobs or hashrate.
+ * @param callback Batch handler, NULL to disable
+ * @param context Passed back to the callback unchanged
+ * @param batch_interval_ms Maximum delay before a partial batch is delivered
+ *        (0 = default 250 ms); takes effect on the next xmrig_start_v8
+ */
+void xmrig_set_event_callback_v8(xmrig_event_callback_t callback, void* context, uint32_t batch_interval_ms);
+
+/**
+ * Offline benchmark
+ * Runs XMRig's built-in fixed-seed benchmark: no pool, no network, the
+ * same hashes on every device, so the hash sum doubles as a correctness
+ * check of the build.
+ */
+#define XMRIG_BENCHMARK_THREADS 64
+
+typedef enum {
+    XMRIG_BENCHMARK_MODE_AUTO = 0,  /* XMRig's choice (fast when memory allows) */
+    XMRIG_BENCHMARK_MODE_FAST = 1,  /* full 2 GB dataset */
+    XMRIG_BENCHMARK_MODE_LIGHT = 2  /* 256 MB cache only */
+} XMRigBenchmarkMode;
+
+typedef struct {
+    uint32_t size;          /* hashes: 250000, 500000 or 1..10 million in whole millions */
+    int threads;            /* 0 = XMRig's auto configuration */
+    int64_t affinity;       /* CPU mask for the workers, -1 = no pinning */
+    int mode;               /* XMRigBenchmarkMode */
+    bool huge_pages;
+    int priority;           /* XMRig CPU priority 0-5, -1 = XMRig's default */
+    const char* algo;       /* NULL = "rx/0" */
+    uint32_t timeout_ms;    /* 0 = no limit */
+    uint32_t trial_ms;      /* > 0: stop this long after the workers are ready and
+                               report the rate measured so far, without a hash sum */
+} XMRigBenchmarkOptions;
+
+typedef struct {
+    double hashrate;        /* H/s from the first to the last hash */
+    double thread_hashrate[XMRIG_BENCHMARK_THREADS];
+    uint32_t threads;
+    uint32_t size;
+    uint64_t init_ms;       /* call until every worker was ready (dataset built) */
+    uint64_t first_hash_ms; /* call until the first completed hash */
+    uint64_t duration_ms;   /* workers ready until the last hash (or the trial end) */
+    uint64_t hash;          /* XMRig's benchmark hash sum */
+    uint64_t reference;     /* expected hash sum, 0 if XMRig has none for this run */
+    bool verified;          /* hash == reference */
+    double power_w;         /* average device draw while hashing, 0 without a meter */
+    double hashes_per_joule;
+} XMRigBenchmarkResult;
+
+/**
+ * Run the offline benchmark
+ * Blocks until the benchmark finishes, then stops the core. The config from
+ * xmrig_init_v8 is left untouched, and an xmrig_init_v8 call made meanwhile
+ * takes effect on the next xmrig_start_v8. The thread count from
+ * xmrig_set_threads_v8 does not apply. Log and event callbacks stay active.
+ * With trial_ms set the run is cut short for autotuning: the rates are
+ * XMRig's 10s averages and hash stays 0.
+ * @param options Benchmark parameters
+ * @param result Filled on success
+ * @return 0 on success, -1 on invalid options or while running,
+ *         -2 if the core exited before finishing, -3 on timeout
+ */
+int xmrig_benchmark_v8(const XMRigBenchmarkOptions* options, XMRigBenchmarkResult* result);
+
+/**
+ * Thermal and battery governor
+ * Keeps the device under a temperature target and a CPU ceiling by parking
+ * workers and duty-cycling one of them, on top of xmrig_set_threads_v8.
+ * Parked workers keep their scratchpads, and the dataset and pool session
+ * are never touched, so throttling costs no reconnect or rebuild.
+ */
+#define XMRIG_TEMP_UNKNOWN (-1000.0)
+
+/* Bits in XMRigGovernorState.limits: what holds the budget down right now */
+#define XMRIG_GOVERNOR_SOC_TEMP     (1u << 0)
+#define XMRIG_GOVERNOR_BATTERY_TEMP (1u << 1)
+#define XMRIG_GOVERNOR_CPU_USAGE    (1u << 2)
+#define XMRIG_GOVERNOR_LOW_BATTERY  (1u << 3)
+
+typedef struct {
+    double soc_temp_c;          /* hottest CPU/SoC thermal zone, XMRIG_TEMP_UNKNOWN if unreadable */
+    double battery_temp_c;      /* XMRIG_TEMP_UNKNOWN if unreadable */
+    int battery_level;          /* percent, -1 if unreadable */
+    bool charging;              /* charging or full on external power */
+} XMRigSensors;
+
+typedef struct {
+    double target_temp_c;       /* SoC temperature to stay under, 0 = no limit */
+    double max_battery_temp_c;  /* battery temperature to stay under, 0 = no limit */
+    double hysteresis_c;        /* speed up again below limit - hysteresis (0 = 3 C) */
+    int max_cpu_usage;          /* percent of all CPUs the workers may use, 0 = no ceiling */
+    int min_battery;            /* park every worker below this level unless charging, 0 = off */
+    uint32_t interval_ms;       /* sensor poll interval (0 = 2000 ms) */
+} XMRigGovernorOptions;
+
+typedef struct {
+    bool enabled;
+    XMRigSensors sensors;       /* last readings the governor acted on */
+    double budget;              /* allowed share of the active workers, 0..1 */
+    uint32_t running;           /* workers hashing full time */
+    uint32_t duty_percent;      /* on-time of one more worker, 0 = none */
+    uint32_t limits;            /* XMRIG_GOVERNOR_* bits */
+} XMRigGovernorState;
+
+/**
+ * Enable, reconfigure or disable the governor
+ * Takes effect on the next poll and persists across xmrig_start_v8. Not
+ * applied during xmrig_benchmark_v8.
+ * @param options Limits to enforce, NULL to disable and unpark its workers
+ * @return 0 on success, -1 on invalid options
+ */
+int xmrig_set_governor_v8(const XMRigGovernorOptions* options);
+
+/**
+ * Feed sensor readings from the host
+ * Sandboxed apps often cannot read /sys/class/thermal or power_supply; values
+ * reported here fill in whatever the bridge could not read itself. Known
+ * fields replace earlier reports, unknown ones leave them as they were.
+ * @param sensors Readings, NULL to forget every earlier report
+ */
+void xmrig_report_sensors_v8(const XMRigSensors* sensors);
+
+/**
+ * Get the governor's current decision
+ * Lock-free, safe to call from any thread.
+ * @param state Pointer to XMRigGovernorState structure to fill
+ */
+void xmrig_get_governor_state_v8(XMRigGovernorState* state);
+
+/**
+ * Per-thread accounting
+ * Sampled once per second for every worker: hash counters and rates, plus
+ * scheduler counters from /proc/self/task/<tid> and the clock of the core
+ * the thread ran on, so the host can tell a starved, bouncing or throttled
+ * thread from a slow device. Linux and Android only; elsewhere the list
+ * stays empty.
+ */
+#define XMRIG_THREAD_STATS_MAX 64
+
+/* Bits in XMRigThreadStats.flags. SLOW marks a sudden drop; the other bits
+ * are what the thread is going through right now, so SLOW together with one
+ * of them names the likely cause. */
+#define XMRIG_THREAD_SLOW        (1u << 0)  /* 10s rate well below its 60s rate or its fastest peer */
+#define XMRIG_THREAD_THROTTLED   (1u << 1)  /* its core runs well below that core's maximum clock */
+#define XMRIG_THREAD_MIGRATED    (1u << 2)  /* moved to another core within the last 10 s */
+#define XMRIG_THREAD_LITTLE_CORE (1u << 3)  /* on a core slower than the fastest cluster */
+
+typedef struct {
+    int32_t worker;                 /* CpuWorker id */
+    int32_t tid;                    /* kernel thread id */
+    int32_t cpu;                    /* core the thread last ran on */
+    bool parked;                    /* parked or paused during the last sample */
+    double usage;                   /* percent of one core over the last second */
+    uint64_t cpu_time_ms;           /* user + system since the worker started */
+    uint64_t runqueue_wait_ms;      /* runnable but waiting for a core, 0 if unknown */
+    uint64_t voluntary_switches;    /* the thread gave up its core (sleep, I/O) */
+    uint64_t involuntary_switches;  /* the scheduler took its core away */
+    uint64_t migrations;            /* moves to another core; a lower bound on kernels
+                                       without CONFIG_SCHED_DEBUG */
+    uint64_t hashes;                /* completed since xmrig_start_v8, across worker restarts */
+    double hashrate_10s;
+    double hashrate_60s;
+    uint32_t freq_khz;              /* current clock of the core it last ran on, 0 if unknown */
+    uint32_t max_freq_khz;          /* that core's maximum clock, 0 if unknown */
+    uint32_t flags;                 /* XMRIG_THREAD_* */
+} XMRigThreadStats;
+
+/**
+ * Get the latest per-thread sample
+ * Counters are cumulative since each worker started; diff two calls for
+ * rates. Lock-free, safe to call from any thread.
+ * @param threads Array to fill, ordered by worker id
+ * @param capacity Entries available in threads
+ * @return Number of workers sampled (may exceed capacity)
+ */
+int xmrig_get_thread_stats_v8(XMRigThreadStats* threads, int capacity);
+
+/**
+ * Donation rounds (dev fee)
+ * The donation session connects, logs in and receives its first job a lead
+ * time before the round is due, so the switch itself is one job change.
+ *
+ * By default rounds follow the wall clock (donate level minutes out of
+ * every 100). With hash_accounting they follow the work: every hash is
+ * credited to the user or the donation, a round starts once the owed
+ * hashes are worth round_ms at the current hashrate and lasts until the
+ * ratio is met again. Throttled or paused time then owes nothing, and a
+ * 1% level switches about every round_ms x 100 instead of every 100 min.
+ */
+#define XMRIG_DONATE_DEFAULT_LEAD_MS 20000
+#define XMRIG_DONATE_DEFAULT_ROUND_MS (10 * 60 * 1000)
+
+typedef struct {
+    uint32_t lead_ms;           /* connect this long before a round, 0 = when it is due */
+    bool hash_accounting;       /* rounds by hashes instead of minutes */
+    uint32_t round_ms;          /* hash accounting: length of one round (0 = 10 min) */
+} XMRigDonateOptions;
+
+typedef struct {
+    uint32_t rounds;            /* donation rounds since start */
+    uint64_t switch_in_ms;      /* last round: due until its first job reached the miner */
+    uint64_t switch_out_ms;     /* last round: over until the next user job reached the miner */
+    uint64_t max_switch_in_ms;
+    uint64_t max_switch_out_ms;
+    uint64_t user_hashes;       /* since the library was loaded, across starts */
+    uint64_t donated_hashes;
+} XMRigDonateStats;
+
+/**
+ * Configure donation rounds
+ * Takes effect from the next round and persists across xmrig_start_v8.
+ * @param options Donation options, NULL restores the defaults
+ * @return 0 on success, -1 on invalid options
+ */
+int xmrig_set_donate_options_v8(const XMRigDonateOptions* options);
+
+/**
+ * Get donation round counters, reset on every xmrig_start_v8 except for
+ * the hash totals. donated / (user + donated) is the effective level.
+ * Lock-free, safe to call from any thread.
+ */
+void xmrig_get_donate_stats_v8(XMRigDonateStats* stats);
+
+/**
+ * Job switch latency
+ * Every job a pool pushes is timed through the core: the line arriving,
+ * the job parsed, the job handed to the workers, and each worker thread
+ * completing its first hash on the new blob. Jobs that reach the workers
+ * without a pool line (donation round switches, failover) only add to
+ * first_hash. A seed change includes the RandomX rebuild in first_hash
+ * and total.
+ *
+ * Shares whose job the miner had already replaced when they were found
+ * are counted as stale; on a slow link these are the ones a pool rejects
+ * or credits late.
+ */
+typedef struct {
+    uint64_t p50_us;
+    uint64_t p95_us;
+    uint64_t p99_us;
+    uint64_t max_us;
+    uint64_t samples;
+} XMRigLatency;
+
+typedef struct {
+    XMRigLatency parse;         /* pool line received until the job was parsed */
+    XMRigLatency dispatch;      /* parsed until handed to the workers */
+    XMRigLatency first_hash;    /* handed over until a thread's first hash, one sample per thread */
+    XMRigLatency total;         /* pool line received until every active thread hashed the job */
+    uint64_t jobs;              /* jobs handed to the workers */
+    uint64_t shares;            /* shares submitted */
+    uint64_t stale_shares;      /* of those, found on a job already replaced */
+} XMRigJobSwitchStats;
+
+/**
+ * Get job switch latency percentiles, reset on every xmrig_start_v8.
+ * Percentiles are bucketed, at most 25% above the exact value.
+ * Lock-free, safe to call from any thread.
+ * @param stats Pointer to XMRigJobSwitchStats structure to fill
+ */
+void xmrig_get_job_switch_stats_v8(XMRigJobSwitchStats* stats);
+
+/**
+ * Mining history
+ * While mining, the core writes one fixed-size sample every 10 s to
+ * history.bin under the storage path, a memory-mapped file of bounded
+ * size. Samples roll up into 1 min and 1 h tiers as they arrive:
+ *
+ *   XMRIG_HISTORY_10S   10 s samples, the last 24 hours
+ *   XMRIG_HISTORY_1M    1 min, the last 7 days
+ *   XMRIG_HISTORY_1H    1 h, the last 366 days
+ *
+ * Rates, CPU usage and power are means over the interval, counters are
+ * sums, temperatures the highest reading. The history survives restarts
+ * and needs no running core to be queried.
+ */
+#define XMRIG_HISTORY_AUTO (-1)   /* finest tier reaching back to from_ms */
+#define XMRIG_HISTORY_10S 0
+#define XMRIG_HISTORY_1M 1
+#define XMRIG_HISTORY_1H 2
+
+typedef struct {
+    uint64_t timestamp_ms;      /* wall clock, end of the interval */
+    uint64_t hashes;            /* completed during the interval */
+    uint64_t diff;              /* last job's difficulty */
+    float hashrate_10s;
+    float hashrate_60s;
+    float hashrate_15m;
+    uint32_t accepted;          /* shares during the interval */
+    uint32_t rejected;
+    float soc_temp_c;           /* XMRIG_TEMP_UNKNOWN if unreadable */
+    float battery_temp_c;       /* XMRIG_TEMP_UNKNOWN if unreadable */
+    float cpu_usage;            /* whole process, percent of one core */
+    float power_w;              /* 0 without an energy meter */
+    uint16_t samples;           /* 10 s samples merged into this one */
+    uint16_t flags;             /* XMRIG_STATS_PAGE_* seen during the interval */
+} XMRigHistorySample;
+
+/**
+ * Query the mining history
+ * Needs xmrig_set_storage_path_v8 first. Thread safe.
+ * @param tier XMRIG_HISTORY_* tier
+ * @param from_ms First timestamp to include (wall clock ms)
+ * @param to_ms Last timestamp to include
+ * @param samples Array to fill, oldest first; the open 1 min / 1 h bucket
+ *        comes last. Query again from the last timestamp + 1 for more.
+ * @param capacity Entries available in samples
+ * @return Number of samples written
+ */
+int xmrig_get_history_v8(int tier, uint64_t from_ms, uint64_t to_ms, XMRigHistorySample* samples, int capacity);
+
+/**
+ * Delete the recorded history
+ */
+void xmrig_clear_history_v8(void);
+
+/**
+ * Startup timeline
+ * Monotonic time from xmrig_start_v8 to each milestone of a cold start,
+ * so the slowest phase can be found per device. Phases overlap: the
+ * workers start as soon as the first job arrives and wait for the RandomX
+ * dataset, so read the marks as a timeline rather than as durations.
+ *
+ * The connection marks (DNS to TLS) belong to the attempt whose login
+ * went through; earlier failed attempts only show up as a later DNS mark
+ * and in connect_attempts. TLS stays 0 on plain TCP pools, the RandomX
+ * marks on other algorithms.
+ */
+#define XMRIG_STARTUP_CONFIG 0       /* config loaded into the core */
+#define XMRIG_STARTUP_INIT 1         /* backends and hardware detection done, connecting */
+#define XMRIG_STARTUP_DNS 2          /* pool host resolved */
+#define XMRIG_STARTUP_CONNECT 3      /* TCP connected */
+#define XMRIG_STARTUP_TLS 4          /* TLS handshake done */
+#define XMRIG_STARTUP_LOGIN 5        /* login answered */
+#define XMRIG_STARTUP_JOB 6          /* first job handed to the miner */
+#define XMRIG_STARTUP_RX_CACHE 7     /* RandomX cache ready (Argon2 fill or disk load) */
+#define XMRIG_STARTUP_RX_DATASET 8   /* RandomX dataset ready, or the cache alone in light mode */
+#define XMRIG_STARTUP_THREADS 9      /* last worker thread started */
+#define XMRIG_STARTUP_FIRST_HASH 10  /* first hash completed by any thread */
+#define XMRIG_STARTUP_FIRST_SHARE 11 /* first accepted share */
+#define XMRIG_STARTUP_PHASES 12
+
+typedef struct {
+    uint64_t phase_us[XMRIG_STARTUP_PHASES]; /* since xmrig_start_v8, 0 = not reached */
+    uint32_t connect_attempts;  /* pool connections tried up to the login */
+    uint32_t threads;           /* worker threads started */
+    bool tls;                   /* the pool that logged in uses TLS */
+    bool rx_cache_from_disk;    /* the cache came from the on-disk store */
+} XMRigStartupReport;
+
+/**
+ * Get the startup timeline of the current or last run
+ * Marks fill in while the core starts; a report taken after the first
+ * accepted share is complete. The same timeline is logged then.
+ */
+void xmrig_get_startup_report_v8(XMRigStartupReport* report);
+
+/**
+ * Short name of an XMRIG_STARTUP_* phase, e.g. "dns"; "" when out of range
+ */
+const char* xmrig_startup_phase_name_v8(int phase);
+
 #ifdef __cplusplus
 }
 #endif
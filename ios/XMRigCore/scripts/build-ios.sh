@@ -51,30 +51,8 @@ fi
 
 XMRIG_SRC="$BUILD_DIR/xmrig-$XMRIG_VERSION"
 
-echo "Syncing bridge source files..."
-cp "$ROOT_DIR/src/xmrig_bridge_impl.cpp" "$XMRIG_SRC/src/"
-cp "$ROOT_DIR/include/xmrig_bridge.h" "$XMRIG_SRC/src/"
-
-# Patch CMakeLists.txt to include the bridge source file
-echo "Patching CMakeLists.txt to include bridge..."
-if ! grep -q "xmrig_bridge_impl.cpp" "$XMRIG_SRC/CMakeLists.txt"; then
-    # Add bridge source to SOURCES list by inserting after the set(SOURCES line
-    # Use awk for more reliable multi-line insertion
-    awk '/^set\(SOURCES$/ { print; print "    src/xmrig_bridge_impl.cpp"; next } 1' "$XMRIG_SRC/CMakeLists.txt" > "$XMRIG_SRC/CMakeLists.txt.tmp"
-    mv "$XMRIG_SRC/CMakeLists.txt.tmp" "$XMRIG_SRC/CMakeLists.txt"
-    echo "✓ Added xmrig_bridge_impl.cpp to build"
-else
-    echo "✓ Bridge already in CMakeLists.txt"
-fi
-
-# Fix CMakeLists.txt bug: remove problematic add_custom_command that references wrong target
-# This strip command is not needed for iOS static library builds anyway
-echo "Patching CMakeLists.txt to fix target reference bug..."
-sed -i '' 's/add_custom_command(TARGET \${PROJECT_NAME}/# DISABLED for iOS: add_custom_command(TARGET \${PROJECT_NAME}/' "$XMRIG_SRC/CMakeLists.txt"
-
-# Change add_executable to add_library for iOS static library build
-echo "Patching CMakeLists.txt to build static library instead of executable..."
-sed -i '' 's/add_executable(\${CMAKE_PROJECT_NAME}/add_library(\${CMAKE_PROJECT_NAME} STATIC/' "$XMRIG_SRC/CMakeLists.txt"
+# Sync bridge sources, apply the bridge hooks and build a static library
+bash "$SCRIPT_DIR/patch-xmrig.sh" "$XMRIG_SRC" static
 
 # Patch iOS-specific compatibility issues
 echo "Patching XMRig source for iOS compatibility..."
@@ -91,61 +69,6 @@ if ! grep -q "TargetConditionals.h" "$XMRIG_SRC/src/crypto/common/VirtualMemory_
 ' "$XMRIG_SRC/src/crypto/common/VirtualMemory_unix.cpp"
 fi
 
-# Patch Base.cpp to check XMRIG_CONFIG_PATH environment variable first
-echo "Patching Base.cpp for iOS config path..."
-cat > "$XMRIG_SRC/src/base/kernel/Base.cpp.patch" << 'BASE_PATCH_EOF'
---- a/src/base/kernel/Base.cpp
-+++ b/src/base/kernel/Base.cpp
-@@ -19,6 +19,8 @@
- #include <cassert>
- #include <memory>
-
-+#include <cstdlib>
-+
-
- #include "base/kernel/Base.h"
- #include "base/io/json/Json.h"
-@@ -128,6 +130,17 @@ private:
-             return config.release();
-         }
-
-+        // iOS: Check XMRIG_CONFIG_PATH environment variable first
-+        const char* ios_config = std::getenv("XMRIG_CONFIG_PATH");
-+        if (ios_config && ios_config[0] != '\0') {
-+            chain.addFile(ios_config);
-+            if (read(chain, config)) {
-+                return config.release();
-+            }
-+        }
-+
-         chain.addFile(Process::location(Process::DataLocation, "config.json"));
-         if (read(chain, config)) {
-             return config.release();
-BASE_PATCH_EOF
-
-# Apply the patch using a more reliable method - direct file modification
-if ! grep -q "XMRIG_CONFIG_PATH" "$XMRIG_SRC/src/base/kernel/Base.cpp"; then
-    # Insert the include for cstdlib
-    sed -i '' 's/#include <memory>/#include <memory>\n\n#include <cstdlib>/' "$XMRIG_SRC/src/base/kernel/Base.cpp"
-
-    # Insert the environment variable check before the DataLocation check
-    # Find the line with "chain.addFile(Process::location(Process::DataLocation" and insert before it
-    sed -i '' '/chain.addFile(Process::location(Process::DataLocation, "config.json"));/i\
-\        \/\/ iOS: Check XMRIG_CONFIG_PATH environment variable first\
-\        const char* ios_config = std::getenv("XMRIG_CONFIG_PATH");\
-\        if (ios_config \&\& ios_config[0] != '"'"'\\0'"'"') {\
-\            chain.addFile(ios_config);\
-\            if (read(chain, config)) {\
-\                return config.release();\
-\            }\
-\        }\
-' "$XMRIG_SRC/src/base/kernel/Base.cpp"
-    echo "✓ Patched Base.cpp for iOS config path"
-else
-    echo "✓ Base.cpp already patched"
-fi
-rm -f "$XMRIG_SRC/src/base/kernel/Base.cpp.patch"
-
 # Fix Platform_mac.cpp for iOS - replace with iOS-compatible version
 cat > "$XMRIG_SRC/src/base/kernel/Platform_mac.cpp" << 'PLATFORM_EOF'
 #include <TargetConditionals.h>
@@ -0,0 +1,78 @@
+#!/bin/bash
+# Build XMRig with the xmrig_bridge C API for a Linux host
+# Produces: output/linux/libxmrig.so and output/linux/xmrig-bridge-cli
+#
+# Same bridge and hooks as the iOS and Android builds, so the in-process
+# core can be run and tested on a plain Linux machine:
+#   output/linux/xmrig-bridge-cli config.json
+#   output/linux/xmrig-bridge-cli --bench 1000000   (offline, for CI)
+#
+# Needs cmake, a C++ toolchain and the libuv / OpenSSL development packages.
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+BUILD_DIR="$ROOT_DIR/build"
+OUTPUT_DIR="$ROOT_DIR/output/linux"
+PROJECT_ROOT="$(cd "$ROOT_DIR/../.." && pwd)"
+CUSTOM_SOURCE_DIR="$PROJECT_ROOT/xmrig_custom_source"
+
+XMRIG_VERSION="6.21.0"
+XMRIG_URL="https://github.com/xmrig/xmrig/archive/refs/tags/v${XMRIG_VERSION}.tar.gz"
+
+echo "=== Building XMRig $XMRIG_VERSION bridge for Linux ==="
+
+command -v cmake >/dev/null 2>&1 || {
+    echo "❌ Error: cmake is not installed"
+    exit 1
+}
+
+mkdir -p "$BUILD_DIR" "$OUTPUT_DIR"
+
+# Download XMRig if not exists
+if [ ! -d "$BUILD_DIR/xmrig-$XMRIG_VERSION" ]; then
+    echo "Downloading XMRig $XMRIG_VERSION..."
+    curl -L "$XMRIG_URL" -o "$BUILD_DIR/xmrig.tar.gz"
+    tar -xzf "$BUILD_DIR/xmrig.tar.gz" -C "$BUILD_DIR"
+    rm "$BUILD_DIR/xmrig.tar.gz"
+fi
+
+XMRIG_SRC="$BUILD_DIR/xmrig-$XMRIG_VERSION"
+
+# Custom dev fee configuration
+cp "$CUSTOM_SOURCE_DIR/donate.h" "$XMRIG_SRC/src/donate.h"
+cp "$CUSTOM_SOURCE_DIR/DonateStrategy.cpp" "$XMRIG_SRC/src/net/strategies/DonateStrategy.cpp"
+cp "$CUSTOM_SOURCE_DIR/DonateStrategy.h" "$XMRIG_SRC/src/net/strategies/DonateStrategy.h"
+echo "✓ Applied custom dev fee sources"
+
+bash "$SCRIPT_DIR/patch-xmrig.sh" "$XMRIG_SRC" shared
+
+echo ""
+echo "🔨 Building libxmrig.so..."
+rm -rf "$BUILD_DIR/linux"
+mkdir -p "$BUILD_DIR/linux"
+cd "$BUILD_DIR/linux"
+
+cmake "$XMRIG_SRC" \
+    -DCMAKE_BUILD_TYPE=Release \
+    -DCMAKE_POSITION_INDEPENDENT_CODE=ON \
+    -DWITH_HWLOC=OFF \
+    -DWITH_TLS=ON \
+    -DWITH_HTTP=OFF \
+    -DWITH_OPENCL=OFF \
+    -DWITH_CUDA=OFF
+
+make -j"$(nproc)"
+
+cp "$BUILD_DIR/linux/libxmrig.so" "$OUTPUT_DIR/"
+
+echo ""
+echo "🔨 Building xmrig-bridge-cli..."
+cc -O2 -Wall -I"$ROOT_DIR/include" "$ROOT_DIR/tools/xmrig-bridge-cli.c" \
+    -L"$OUTPUT_DIR" -lxmrig -Wl,-rpath,'$ORIGIN' \
+    -o "$OUTPUT_DIR/xmrig-bridge-cli"
+
+echo ""
+echo "=== Build Complete ==="
+ls -lh "$OUTPUT_DIR"
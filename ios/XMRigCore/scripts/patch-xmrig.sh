@@ -0,0 +1,186 @@
+#!/bin/bash
+# Patch an XMRig source tree for the in-process bridge
+#
+# - syncs the bridge sources into <xmrig-src>/src and adds them to the build
+# - inserts the xmrig::bridge hook calls (see src/xmrig_bridge_hooks.h)
+# - optionally turns the xmrig executable into a static or shared library
+#
+# Usage: patch-xmrig.sh <xmrig-src> [static|shared]
+# Safe to run repeatedly on the same tree. Only needs bash, perl and awk, so
+# it runs unchanged on macOS (iOS builds) and Linux (Android, host builds).
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+XMRIG_SRC="$1"
+LIBRARY_TYPE="$2"
+
+if [ -z "$XMRIG_SRC" ] || [ ! -f "$XMRIG_SRC/CMakeLists.txt" ]; then
+    echo "❌ Error: usage: $0 <xmrig-src> [static|shared]"
+    exit 1
+fi
+
+case "$LIBRARY_TYPE" in
+    "") ;;
+    static) LIBRARY_TYPE="STATIC" ;;
+    shared) LIBRARY_TYPE="SHARED" ;;
+    *)
+        echo "❌ Error: unknown library type '$LIBRARY_TYPE' (static or shared)"
+        exit 1
+        ;;
+esac
+
+# apply_patch <file> <marker> <perl substitution>
+# Skips the file when <marker> is already present, fails loudly when the
+# substitution did not match (i.e. the upstream source moved).
+apply_patch() {
+    local file="$XMRIG_SRC/$1"
+    local marker="$2"
+    local expr="$3"
+
+    if grep -qF "$marker" "$file"; then
+        echo "✓ $1 already patched ($marker)"
+        return
+    fi
+
+    perl -0pi -e "$expr" "$file"
+
+    if ! grep -qF "$marker" "$file"; then
+        echo "❌ Error: failed to patch $1 ($marker)"
+        exit 1
+    fi
+    echo "✓ Patched $1 ($marker)"
+}
+
+# add_hooks_include <file>
+add_hooks_include() {
+    apply_patch "$1" '#include "xmrig_bridge_hooks.h"' 's/^(#include ")/#include "xmrig_bridge_hooks.h"\n$1/m'
+}
+
+echo "Syncing bridge source files..."
+cp "$ROOT_DIR"/src/*.cpp "$ROOT_DIR"/src/*.h "$XMRIG_SRC/src/"
+cp "$ROOT_DIR/include/xmrig_bridge.h" "$XMRIG_SRC/src/"
+
+echo "Patching CMakeLists.txt to include bridge sources..."
+for source in "$ROOT_DIR"/src/*.cpp; do
+    name="src/$(basename "$source")"
+    if ! grep -qF "$name" "$XMRIG_SRC/CMakeLists.txt"; then
+        # Insert right after the set(SOURCES line
+        awk -v name="$name" '/^set\(SOURCES$/ { print; print "    " name; next } 1' "$XMRIG_SRC/CMakeLists.txt" > "$XMRIG_SRC/CMakeLists.txt.tmp"
+        mv "$XMRIG_SRC/CMakeLists.txt.tmp" "$XMRIG_SRC/CMakeLists.txt"
+        echo "✓ Added $name to build"
+    fi
+done
+
+# Lets sources outside the bridge (xmrig_custom_source) call its hooks
+apply_patch "CMakeLists.txt" "add_definitions(-DXMRIG_FEATURE_BRIDGE)" \
+    's/^(set\(SOURCES\n)/add_definitions(-DXMRIG_FEATURE_BRIDGE)\n\n$1/m'
+
+if [ -n "$LIBRARY_TYPE" ]; then
+    echo "Patching CMakeLists.txt to build a $LIBRARY_TYPE library..."
+    apply_patch "CMakeLists.txt" "add_library(\${CMAKE_PROJECT_NAME} $LIBRARY_TYPE" \
+        "s/add_executable\\(\\\$\\{CMAKE_PROJECT_NAME\\}/add_library(\\\${CMAKE_PROJECT_NAME} $LIBRARY_TYPE/"
+
+    # The post-build strip refers to the executable target; not needed for libraries
+    perl -pi -e 's/^(\s*)(add_custom_command\(TARGET \$\{PROJECT_NAME\})/$1# DISABLED for library builds: $2/' "$XMRIG_SRC/CMakeLists.txt"
+fi
+
+echo "Patching XMRig sources with bridge hooks..."
+
+# Config handed over in memory by xmrig_init_v8, ahead of the command line
+add_hooks_include "src/base/kernel/Base.cpp"
+apply_patch "src/base/kernel/Base.cpp" "xmrig::bridge::loadConfig" \
+    's/^([ ]*)(ConfigTransform::load\(chain, process, transform\);\n)/$1xmrig::bridge::loadConfig(chain);\n$1$2/m'
+
+# Offline benchmark results for xmrig_benchmark_v8
+add_hooks_include "src/base/net/stratum/benchmark/BenchClient.cpp"
+apply_patch "src/base/net/stratum/benchmark/BenchClient.cpp" "xmrig::bridge::onBenchReady" \
+    's/(void xmrig::BenchClient::onBenchReady\(uint64_t ts, uint32_t threads, const IBackend \*backend\)\n\{\n)/$1    xmrig::bridge::onBenchReady(ts, threads);\n\n/'
+apply_patch "src/base/net/stratum/benchmark/BenchClient.cpp" "xmrig::bridge::onBenchDone" \
+    's/(void xmrig::BenchClient::onBenchDone\(uint64_t result, uint64_t diff, uint64_t ts\)\n\{\n)/$1    xmrig::bridge::onBenchDone(result, referenceHash(), ts);\n\n/'
+
+# On-disk RandomX cache store: load instead of the Argon2 fill, save after it
+add_hooks_include "src/crypto/randomx/dataset.cpp"
+apply_patch "src/crypto/randomx/dataset.cpp" "xmrig::bridge::loadRxCache" \
+    's/^([ \t]*)argon2_ctx_mem\(&context, Argon2_d, cache->memory, ([^;]+)\);\n/$1if (!xmrig::bridge::loadRxCache(key, keySize, context.salt, context.saltlen, cache->memory, $2)) {\n$1\targon2_ctx_mem(&context, Argon2_d, cache->memory, $2);\n$1\txmrig::bridge::storeRxCache(key, keySize, context.salt, context.saltlen, cache->memory, $2);\n$1}\n/m'
+
+# Pools announce the next epoch's seed; its cache is built ahead of the switch
+add_hooks_include "src/base/net/stratum/Client.cpp"
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::onNextSeed" \
+    's/(bool xmrig::Client::parseJob\(const rapidjson::Value &params, int \*code\)\n\{\n)/$1    xmrig::bridge::onNextSeed(params.IsObject() ? Json::getString(params, "next_seed_hash") : nullptr);\n\n/'
+
+# Job switch timing: line received, job parsed (scope around the listener call)
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::onLine" \
+    's/(void xmrig::Client::parse\(char \*line, size_t len\)\n\{\n)/$1    xmrig::bridge::onLine();\n\n/'
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::JobNotify" \
+    's/^([ ]*)(m_listener->onJobReceived\(this, m_job, )/$1const xmrig::bridge::JobNotify notify;\n$1$2/mg'
+
+# Startup timeline: resolved, TCP connected, login sent (after TLS), login answered
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::onResolved" \
+    's/(void xmrig::Client::onResolved\([^)]*\)\n\{\n)/$1    xmrig::bridge::onResolved();\n\n/'
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::onConnected" \
+    's/(void xmrig::Client::handshake\(\)\n\{\n)/$1    xmrig::bridge::onConnected();\n\n/'
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::onLoginSent" \
+    's/(void xmrig::Client::login\(\)\n\{\n)/$1    xmrig::bridge::onLoginSent(isTLS());\n\n/'
+apply_patch "src/base/net/stratum/Client.cpp" "xmrig::bridge::onLoginReply" \
+    's/(bool xmrig::Client::parseLogin\(const rapidjson::Value &result, int \*code\)\n\{\n)/$1    xmrig::bridge::onLoginReply();\n\n/'
+
+# ...and the RandomX dataset (or light-mode cache) ready for the job's seed
+add_hooks_include "src/core/Miner.cpp"
+apply_patch "src/core/Miner.cpp" "xmrig::bridge::onDatasetReady" \
+    's/(void xmrig::Miner::onDatasetReady\(\)\n\{\n)/$1    xmrig::bridge::onDatasetReady();\n\n/'
+
+# Drop log lines above the bridge's level before they are formatted
+add_hooks_include "src/base/io/log/Log.cpp"
+apply_patch "src/base/io/log/Log.cpp" "xmrig::bridge::isLogEnabled" \
+    's/(void xmrig::Log::print\(Level level, const char \*fmt, \.\.\.\)\n\{\n)/$1    if (!xmrig::bridge::isLogEnabled(level)) {\n        return;\n    }\n\n/'
+
+# Per-thread cumulative hash counts (stats snapshot, total hashes)
+add_hooks_include "src/backend/common/Hashrate.cpp"
+apply_patch "src/backend/common/Hashrate.cpp" "xmrig::bridge::onHashrateData" \
+    's/(void xmrig::Hashrate::addData\(size_t index, uint64_t count, uint64_t timestamp\)\n\{\n)/$1    xmrig::bridge::onHashrateData(index, count, timestamp);\n\n/'
+
+# Share results, tagged with whether they came from the donation strategy
+add_hooks_include "src/net/Network.cpp"
+apply_patch "src/net/Network.cpp" "xmrig::bridge::onResult" \
+    's/void xmrig::Network::onResultAccepted\(IStrategy \*, IClient \*, const SubmitResult &result, const char \*error\)\n\{\n/void xmrig::Network::onResultAccepted(IStrategy *strategy, IClient *, const SubmitResult &result, const char *error)\n{\n    xmrig::bridge::onResult(error == nullptr, strategy == m_donate, result.diff, result.elapsed);\n\n/'
+
+# Jobs and pool sessions for the event stream
+apply_patch "src/net/Network.cpp" "xmrig::bridge::onJob" \
+    's/(void xmrig::Network::setJob\(IClient \*client, const Job &job, bool donate\)\n\{\n)/$1    xmrig::bridge::onJob(job.height(), job.diff(), job.seed().data(), job.seed().size(), donate);\n\n/'
+apply_patch "src/net/Network.cpp" "xmrig::bridge::onJobDispatched" \
+    's/^([ ]*)(m_controller->miner\(\)->setJob\(job, donate\);\n)/$1$2$1xmrig::bridge::onJobDispatched(job.id().data());\n/m'
+apply_patch "src/net/Network.cpp" "xmrig::bridge::onSubmit" \
+    's/(void xmrig::Network::onJobResult\(const JobResult &result\)\n\{\n)/$1    xmrig::bridge::onSubmit(result.jobId.data());\n\n/'
+apply_patch "src/net/Network.cpp" "xmrig::bridge::onPoolActive" \
+    's/(void xmrig::Network::onActive\(IStrategy \*strategy, IClient \*client\)\n\{\n)/$1    xmrig::bridge::onPoolActive(strategy == m_donate, client->pool().host().data(), client->pool().port(), client->isTLS());\n\n/'
+apply_patch "src/net/Network.cpp" "xmrig::bridge::onPoolPaused" \
+    's/(void xmrig::Network::onPause\(IStrategy \*strategy\)\n\{\n)/$1    xmrig::bridge::onPoolPaused(strategy == m_donate);\n\n/'
+
+# Worker lifecycle, wake-up on resume and first hash, for pause/resume latency
+add_hooks_include "src/backend/cpu/CpuWorker.cpp"
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::onWorkerStop" \
+    's/(xmrig::CpuWorker<N>::~CpuWorker\(\)\n\{\n)/$1    xmrig::bridge::onWorkerStop(id());\n\n/'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::onWorkerStart" \
+    's/(void xmrig::CpuWorker<N>::start\(\)\n\{\n)/$1    xmrig::bridge::onWorkerStart(id());\n\n/'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::onWorkerIdle" \
+    's/^([ ]*)(if \(Nonce::isPaused\(\)\) \{\n)/$1$2$1    xmrig::bridge::onWorkerIdle(id());\n\n/m'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::onWorkerBusy" \
+    's/^([ ]*)(while \(Nonce::isPaused\(\) && Nonce::sequence\(Nonce::CPU\) > 0\);\n)/$1$2\n$1xmrig::bridge::onWorkerBusy(id());\n/m'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::waitPaused" \
+    's/(do \{\n[ ]*)std::this_thread::sleep_for\(std::chrono::milliseconds\(200\)\);/$1xmrig::bridge::waitPaused(200);/'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::onHashes" \
+    's/^([ ]*)(m_count \+= N;\n)/$1$2$1xmrig::bridge::onHashes(id());\n/m'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "xmrig::bridge::onJobConsumed" \
+    's/(void xmrig::CpuWorker<N>::consumeJob\(\)\n\{\n)/$1    xmrig::bridge::onJobConsumed(id());\n\n/'
+
+# Live thread count: parked workers wait in the pause loop with their VM intact
+apply_patch "src/backend/cpu/CpuWorker.cpp" "if (Nonce::isPaused() || xmrig::bridge::isParked(id())) {" \
+    's/if \(Nonce::isPaused\(\)\) \{/if (Nonce::isPaused() || xmrig::bridge::isParked(id())) {/'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "while ((Nonce::isPaused() || xmrig::bridge::isParked(id())) &&" \
+    's/while \(Nonce::isPaused\(\) && Nonce::sequence\(Nonce::CPU\) > 0\);/while ((Nonce::isPaused() || xmrig::bridge::isParked(id())) && Nonce::sequence(Nonce::CPU) > 0);/'
+apply_patch "src/backend/cpu/CpuWorker.cpp" "m_job.sequence()) && !xmrig::bridge::isParked(id())" \
+    's/while \(!Nonce::isOutdated\(Nonce::CPU, m_job.sequence\(\)\)\) \{/while (!Nonce::isOutdated(Nonce::CPU, m_job.sequence()) \&\& !xmrig::bridge::isParked(id())) {/'
+
+echo "✓ Bridge hooks applied"
@@ -0,0 +1,116 @@
+/**
+ * XMRig Bridge - lock-free latency histogram
+ *
+ * Log-linear buckets: four per power of two, so a percentile overstates
+ * the true value by at most 25% (exact below 4). Any thread may
+ * add(); buckets are relaxed atomic counters, so a reader racing with
+ * writers sees a consistent enough picture for percentiles.
+ */
+
+#ifndef XMRIG_BRIDGE_HISTOGRAM_H
+#define XMRIG_BRIDGE_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xmrig {
+
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() { reset(); }
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void add(uint64_t value)
+    {
+        m_buckets[index(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    // Not atomic against add(); call while nothing records
+    void reset()
+    {
+        for (auto &bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    inline uint64_t count() const   { return m_count.load(std::memory_order_relaxed); }
+    inline uint64_t max() const     { return m_max.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given fraction (0..1) of the
+    // samples, capped at the largest sample; 0 when empty
+    uint64_t percentile(double fraction) const
+    {
+        uint64_t counts[kBuckets];
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        if (total == 0) {
+            return 0;
+        }
+
+        const uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                const uint64_t bound = upper(i);
+                return bound < max() ? bound : max();
+            }
+        }
+
+        return max();
+    }
+
+private:
+    static constexpr size_t kSubBits = 2;
+    static constexpr size_t kSub     = 1 << kSubBits;
+    static constexpr size_t kBuckets = kSub + (60 - kSubBits) * kSub;
+
+    static size_t index(uint64_t value)
+    {
+        if (value < kSub) {
+            return static_cast<size_t>(value);
+        }
+
+        const size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+        const size_t sub = static_cast<size_t>(value >> (msb - kSubBits)) & (kSub - 1);
+        const size_t i   = kSub + (msb - kSubBits) * kSub + sub;
+
+        return i < kBuckets ? i : kBuckets - 1;
+    }
+
+    static uint64_t upper(size_t i)
+    {
+        if (i < kSub) {
+            return i;
+        }
+
+        const size_t shift = (i - kSub) / kSub;
+        const uint64_t sub = (i - kSub) % kSub;
+
+        return ((kSub + sub + 1) << shift) - 1;
+    }
+
+    std::atomic<uint64_t> m_buckets[kBuckets];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_max;
+};
+
+
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_HISTOGRAM_H */
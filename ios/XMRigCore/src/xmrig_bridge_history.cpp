@@ -0,0 +1,272 @@
+#include "xmrig_bridge_history.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+namespace xmrig {
+
+
+static constexpr uint32_t kMagic = 0x31485358; // "XSH1"
+static constexpr uint32_t kVersion = 1;
+static constexpr int kTiers = 3;
+static constexpr size_t kHeaderSize = 4096;
+static constexpr uint64_t kPeriod[kTiers] = { 10 * 1000, 60 * 1000, 60 * 60 * 1000 };
+static constexpr uint32_t kCapacity[kTiers] = { 8640, 7 * 1440, 366 * 24 }; // a day, a week, a year
+
+static_assert(sizeof(XMRigHistorySample) == 64, "XMRigHistorySample is part of the file format");
+static_assert(XMRIG_HISTORY_10S == 0 && XMRIG_HISTORY_1M == 1 && XMRIG_HISTORY_1H == 2, "tiers index the rings");
+
+struct HistoryStore::FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sample_size;
+    uint32_t tiers;
+    uint32_t capacity[kTiers];
+    uint32_t head[kTiers];              // next slot to write
+    uint32_t count[kTiers];
+    uint32_t reserved;
+    uint64_t last_ms;                   // newest 10 s sample
+    XMRigHistorySample bucket[kTiers];  // open bucket per tier, [0] unused
+};
+
+
+static size_t file_size()
+{
+    size_t size = kHeaderSize;
+    for (uint32_t capacity : kCapacity) {
+        size += capacity * sizeof(XMRigHistorySample);
+    }
+    return size;
+}
+
+
+static uint64_t bucket_of(int tier, uint64_t timestamp_ms)
+{
+    // Samples are stamped at the end of their interval
+    return (timestamp_ms > 0 ? timestamp_ms - 1 : 0) / kPeriod[tier];
+}
+
+
+static float mean(float a, uint32_t weight_a, float b, uint32_t weight_b)
+{
+    return (a * weight_a + b * weight_b) / (weight_a + weight_b);
+}
+
+
+HistoryStore::~HistoryStore()
+{
+    close();
+}
+
+
+bool HistoryStore::open(const std::string &path)
+{
+    static_assert(sizeof(FileHeader) <= kHeaderSize, "FileHeader must fit the header block");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (path == m_path && (m_header || path.empty())) {
+        return m_header != nullptr;
+    }
+
+    close();
+    m_path = path;
+    if (path.empty()) {
+        return false;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    const size_t size = file_size();
+    struct stat st;
+    const bool resized = fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != size;
+    if (resized && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    m_header = static_cast<FileHeader *>(memory);
+    m_size = size;
+
+    FileHeader &header = *m_header;
+    bool valid = !resized && header.magic == kMagic && header.version == kVersion &&
+                 header.sample_size == sizeof(XMRigHistorySample) && header.tiers == kTiers;
+    for (int tier = 0; valid && tier < kTiers; ++tier) {
+        valid = header.capacity[tier] == kCapacity[tier] && header.head[tier] < kCapacity[tier] && header.count[tier] <= kCapacity[tier];
+    }
+
+    if (!valid) {
+        memset(m_header, 0, kHeaderSize);
+        header.sample_size = sizeof(XMRigHistorySample);
+        header.tiers = kTiers;
+        memcpy(header.capacity, kCapacity, sizeof(kCapacity));
+        header.version = kVersion;
+        header.magic = kMagic;
+    }
+
+    return true;
+}
+
+
+void HistoryStore::append(const XMRigHistorySample &sample)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_header || sample.timestamp_ms <= m_header->last_ms) {
+        return;
+    }
+
+    XMRigHistorySample next = sample;
+    next.samples = 1;
+
+    m_header->last_ms = next.timestamp_ms;
+    push(XMRIG_HISTORY_10S, next);
+    merge(XMRIG_HISTORY_1M, next);
+}
+
+
+int HistoryStore::query(int tier, uint64_t from_ms, uint64_t to_ms, XMRigHistorySample *samples, int capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_header || !samples || capacity <= 0 || from_ms > to_ms || tier < XMRIG_HISTORY_AUTO || tier >= kTiers) {
+        return 0;
+    }
+
+    const FileHeader &header = *m_header;
+    const auto oldest = [&](int t) -> const XMRigHistorySample & {
+        return ring(t)[(header.head[t] + kCapacity[t] - header.count[t]) % kCapacity[t]];
+    };
+
+    // Finest tier whose history reaches from_ms, else the one reaching furthest back
+    if (tier == XMRIG_HISTORY_AUTO) {
+        tier = XMRIG_HISTORY_10S;
+        for (int t = 0; t < kTiers; ++t) {
+            if (header.count[t] == 0) {
+                continue;
+            }
+            if (oldest(t).timestamp_ms <= from_ms) {
+                tier = t;
+                break;
+            }
+            if (header.count[tier] == 0 || oldest(t).timestamp_ms < oldest(tier).timestamp_ms) {
+                tier = t;
+            }
+        }
+    }
+
+    const XMRigHistorySample *data = ring(tier);
+    const uint32_t first = (header.head[tier] + kCapacity[tier] - header.count[tier]) % kCapacity[tier];
+    int written = 0;
+
+    for (uint32_t i = 0; i < header.count[tier] && written < capacity; ++i) {
+        const XMRigHistorySample &sample = data[(first + i) % kCapacity[tier]];
+        if (sample.timestamp_ms >= from_ms && sample.timestamp_ms <= to_ms) {
+            samples[written++] = sample;
+        }
+    }
+
+    const XMRigHistorySample &open = header.bucket[tier];
+    if (tier != XMRIG_HISTORY_10S && written < capacity && open.samples > 0 && open.timestamp_ms >= from_ms && open.timestamp_ms <= to_ms) {
+        samples[written++] = open;
+    }
+
+    return written;
+}
+
+
+void HistoryStore::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_header) {
+        return;
+    }
+
+    memset(m_header->head, 0, sizeof(m_header->head));
+    memset(m_header->count, 0, sizeof(m_header->count));
+    memset(m_header->bucket, 0, sizeof(m_header->bucket));
+    m_header->last_ms = 0;
+}
+
+
+void HistoryStore::close()
+{
+    if (m_header) {
+        munmap(m_header, m_size);
+    }
+
+    m_header = nullptr;
+    m_size = 0;
+}
+
+
+void HistoryStore::push(int tier, const XMRigHistorySample &sample)
+{
+    FileHeader &header = *m_header;
+
+    ring(tier)[header.head[tier]] = sample;
+    header.head[tier] = (header.head[tier] + 1) % kCapacity[tier];
+    header.count[tier] = std::min(header.count[tier] + 1, kCapacity[tier]);
+}
+
+
+// Folds a finer sample into the open bucket of tier; a sample from a later
+// period closes the bucket into the ring and the next coarser tier
+void HistoryStore::merge(int tier, const XMRigHistorySample &sample)
+{
+    XMRigHistorySample &bucket = m_header->bucket[tier];
+
+    if (bucket.samples > 0 && bucket_of(tier, sample.timestamp_ms) != bucket_of(tier, bucket.timestamp_ms)) {
+        push(tier, bucket);
+        if (tier + 1 < kTiers) {
+            merge(tier + 1, bucket);
+        }
+        bucket.samples = 0;
+    }
+
+    if (bucket.samples == 0) {
+        bucket = sample;
+        return;
+    }
+
+    const uint32_t n = bucket.samples;
+    const uint32_t m = sample.samples;
+
+    bucket.timestamp_ms = sample.timestamp_ms;
+    bucket.hashes += sample.hashes;
+    bucket.diff = sample.diff;
+    bucket.hashrate_10s = mean(bucket.hashrate_10s, n, sample.hashrate_10s, m);
+    bucket.hashrate_60s = mean(bucket.hashrate_60s, n, sample.hashrate_60s, m);
+    bucket.hashrate_15m = mean(bucket.hashrate_15m, n, sample.hashrate_15m, m);
+    bucket.accepted += sample.accepted;
+    bucket.rejected += sample.rejected;
+    bucket.soc_temp_c = std::max(bucket.soc_temp_c, sample.soc_temp_c);
+    bucket.battery_temp_c = std::max(bucket.battery_temp_c, sample.battery_temp_c);
+    bucket.cpu_usage = mean(bucket.cpu_usage, n, sample.cpu_usage, m);
+    bucket.power_w = mean(bucket.power_w, n, sample.power_w, m);
+    bucket.samples = static_cast<uint16_t>(n + m);
+    bucket.flags |= sample.flags;
+}
+
+
+XMRigHistorySample *HistoryStore::ring(int tier) const
+{
+    uint8_t *data = reinterpret_cast<uint8_t *>(m_header) + kHeaderSize;
+    for (int t = 0; t < tier; ++t) {
+        data += kCapacity[t] * sizeof(XMRigHistorySample);
+    }
+    return reinterpret_cast<XMRigHistorySample *>(data);
+}
+
+
+} // namespace xmrig
@@ -0,0 +1,87 @@
+/**
+ * XMRig Bridge - mining history store
+ *
+ * Fixed-size XMRigHistorySample records in one memory-mapped file, in three
+ * rings: 10 s samples for a day, 1 min for a week and 1 h for a year. Each
+ * 10 s sample is also merged into the open 1 min bucket, and each closed
+ * 1 min bucket into the open 1 h bucket, so the coarser tiers cost nothing
+ * to query. The file never grows (about 1.8 MB) and an append dirties one
+ * or two pages that the kernel writes back on its own schedule, instead of
+ * a text log line parsed back later.
+ *
+ * File layout: a FileHeader padded to kHeaderSize with the ring positions
+ * and the open buckets, then the three rings back to back. A file whose
+ * magic, version or geometry does not match, or whose positions are out of
+ * range (a crash mid-update), starts over empty.
+ *
+ * Thread safe: the core appends from its loop thread, the host queries
+ * from its own.
+ */
+
+#ifndef XMRIG_BRIDGE_HISTORY_H
+#define XMRIG_BRIDGE_HISTORY_H
+
+#include "xmrig_bridge.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace xmrig {
+
+
+class HistoryStore
+{
+public:
+    HistoryStore() = default;
+    ~HistoryStore();
+
+    HistoryStore(const HistoryStore &) = delete;
+    HistoryStore &operator=(const HistoryStore &) = delete;
+
+    /**
+     * Maps the file at path, creating it as needed. An empty path closes
+     * the store. Returns false when the file cannot be mapped; appends and
+     * queries are then no-ops.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * Appends one 10 s sample and rolls it up into the coarser tiers.
+     * timestamp_ms is the end of the sample's interval and must not go
+     * backwards; an earlier one is dropped.
+     */
+    void append(const XMRigHistorySample &sample);
+
+    /**
+     * Copies the samples of one tier with from_ms <= timestamp_ms <= to_ms,
+     * oldest first, up to capacity. The open 1 min / 1 h bucket is included
+     * when it falls in range. XMRIG_HISTORY_AUTO picks the finest tier that
+     * reaches back to from_ms. Returns the number written.
+     */
+    int query(int tier, uint64_t from_ms, uint64_t to_ms, XMRigHistorySample *samples, int capacity);
+
+    /**
+     * Empties every tier.
+     */
+    void clear();
+
+private:
+    struct FileHeader;
+
+    void close();
+    void push(int tier, const XMRigHistorySample &sample);
+    void merge(int tier, const XMRigHistorySample &sample);
+    XMRigHistorySample *ring(int tier) const;
+
+    std::mutex m_mutex;
+    std::string m_path;
+    FileHeader *m_header = nullptr;
+    size_t m_size = 0;
+};
+
+
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_HISTORY_H */
@@ -0,0 +1,192 @@
+/**
+ * XMRig Bridge - core hooks
+ *
+ * Entry points called from the XMRig sources patched by
+ * scripts/patch-xmrig.sh. They run on whichever thread owns the calling
+ * XMRig object (mostly the libuv loop), so they only record numbers and
+ * must never block or call back into XMRig.
+ */
+
+#ifndef XMRIG_BRIDGE_HOOKS_H
+#define XMRIG_BRIDGE_HOOKS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xmrig {
+
+
+class JsonChain;
+
+
+namespace bridge {
+
+
+/**
+ * BasePrivate::load() - adds the config handed to xmrig_init_v8, already
+ * parsed, ahead of the command line transform. No file is involved.
+ */
+void loadConfig(JsonChain &chain);
+
+/**
+ * BenchClient::onBenchReady() / onBenchDone() - offline benchmark started
+ * (every worker has its VM) and finished, with XMRig's hash sum and the
+ * expected value. Timestamps are Chrono::steadyMSecs().
+ */
+void onBenchReady(uint64_t ts, uint32_t threads);
+void onBenchDone(uint64_t hash, uint64_t reference, uint64_t ts);
+
+/**
+ * randomx::initCache() - around the Argon2 fill of a RandomX cache, on
+ * XMRig's RandomX init thread. loadRxCache() fills memory from the on-disk
+ * store and returns true to skip Argon2; storeRxCache() saves a freshly
+ * computed cache. Both do file I/O, and loadRxCache() waits for a
+ * background build of the same seed: the thread is blocked on the cache
+ * anyway, and neither touches XMRig state.
+ */
+bool loadRxCache(const void *key, size_t keySize, const void *salt, size_t saltSize, uint8_t *memory, size_t size);
+void storeRxCache(const void *key, size_t keySize, const void *salt, size_t saltSize, const uint8_t *memory, size_t size);
+
+/**
+ * Client::parseJob() - next_seed_hash of the job being parsed (hex, NULL
+ * when the pool sends none), ahead of the onJob() for the same job.
+ */
+void onNextSeed(const char *hex);
+
+/**
+ * Log::print() - severity gate in front of XMRig's formatting.
+ * Levels follow Log::Level; NONE (-1) is never filtered.
+ */
+extern std::atomic<int> logLevel;
+
+inline bool isLogEnabled(int level)
+{
+    return level <= logLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * Hashrate::addData() - cumulative hash count of one slot.
+ * Index 0 is the backend total, index N is worker thread N - 1.
+ */
+void onHashrateData(size_t index, uint64_t count, uint64_t timestamp);
+
+/**
+ * Network::onResultAccepted() - pool verdict for a submitted share.
+ */
+void onResult(bool accepted, bool donate, uint64_t diff, uint64_t elapsed);
+
+/**
+ * Network::setJob() - job about to be handed to the Miner.
+ */
+void onJob(uint64_t height, uint64_t diff, const uint8_t *seed, size_t seedSize, bool donate);
+
+/**
+ * Job switch timing, loop thread. Client::parse() - a line arrived from a
+ * pool. JobNotify - scope around the listener call of a freshly parsed job
+ * (notification or login result), so onJobDispatched() inside it knows the
+ * job came straight from the wire. Network::setJob() - the Miner took the
+ * job. Network::onJobResult() - a share about to be submitted.
+ */
+void onLine();
+void onJobDispatched(const char *jobId);
+void onSubmit(const char *jobId);
+
+struct JobNotify
+{
+    JobNotify();
+    ~JobNotify();
+
+    JobNotify(const JobNotify &) = delete;
+    JobNotify &operator=(const JobNotify &) = delete;
+};
+
+/**
+ * Startup timeline, loop thread. Client::onResolved(), handshake(),
+ * login() and parseLogin() - pool host resolved (or failed to), TCP
+ * connected, login sent (after the handshake on TLS pools), login
+ * answered. Miner::onDatasetReady() - RandomX storage is ready for a seed.
+ */
+void onResolved();
+void onConnected();
+void onLoginSent(bool tls);
+void onLoginReply();
+void onDatasetReady();
+
+/**
+ * Network::onActive() / Network::onPause() - pool session became usable
+ * or the strategy ran out of active pools.
+ */
+void onPoolActive(bool donate, const char *host, uint16_t port, bool tls);
+void onPoolPaused(bool donate);
+
+/**
+ * DonateStrategy (xmrig_custom_source, built with XMRIG_FEATURE_BRIDGE) -
+ * lead time of the pre-connected donation session, and the moment a round
+ * is due (donate) or over (!donate). The gap until the next onJob() of the
+ * other side is the switch cost.
+ */
+extern std::atomic<uint32_t> donateLeadMs;
+void onDonateSwitch(bool donate);
+
+/**
+ * DonateStrategy::tick() - hash accounting. donateDebt() credits the hashes
+ * since its last call to the donation or the user and returns the hashes
+ * still owed at the given fraction (negative when ahead). Loop thread only.
+ */
+extern std::atomic<bool> donateAccounting;
+extern std::atomic<uint32_t> donateRoundMs;
+double donateDebt(bool donating, double fraction);
+double currentHashrate();
+
+/**
+ * CpuWorker lifecycle, called on the worker thread itself.
+ * Idle/busy bracket the sleep loop XMRig uses while the Miner is paused.
+ */
+void onWorkerStart(size_t id);
+void onWorkerStop(size_t id);
+void onWorkerIdle(size_t id);
+void onWorkerBusy(size_t id);
+
+/**
+ * CpuWorker pause checks - threads beyond the live thread count treat
+ * themselves as paused but keep their RandomX VM and scratchpad.
+ */
+extern std::atomic<uint64_t> parkedWorkers;
+
+inline bool isParked(size_t id)
+{
+    return id < 64 && (parkedWorkers.load(std::memory_order_relaxed) & (1ULL << id));
+}
+
+/**
+ * Replaces the fixed 200 ms sleep of a paused CpuWorker. Returns after at
+ * most timeoutMs, or as soon as the bridge resumes the Miner.
+ */
+void waitPaused(uint64_t timeoutMs);
+
+/**
+ * CpuWorker hash loop - first completed hash of a thread after the bridge
+ * asked for it. The inline check keeps the hot path to one relaxed load.
+ */
+extern std::atomic<uint64_t> firstHashPending;
+void onFirstHash(size_t id);
+
+/**
+ * CpuWorker::consumeJob() - the thread picked up the Miner's current job;
+ * its next completed hash is the first one on that blob.
+ */
+void onJobConsumed(size_t id);
+
+inline void onHashes(size_t id)
+{
+    if (id < 64 && (firstHashPending.load(std::memory_order_relaxed) & (1ULL << id))) {
+        onFirstHash(id);
+    }
+}
+
+
+} // namespace bridge
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_HOOKS_H */
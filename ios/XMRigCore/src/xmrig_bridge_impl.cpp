@@ -1,46 +1,1584 @@
 #include "xmrig_bridge.h"
-#include "App.h"
+#include "xmrig_bridge_histogram.h"
+#include "xmrig_bridge_history.h"
+#include "xmrig_bridge_hooks.h"
+#include "xmrig_bridge_platform.h"
+#include "xmrig_bridge_ring.h"
+#include "xmrig_bridge_rxcache.h"
+#include "xmrig_bridge_seqlock.h"
+#include "Summary.h"
+#include "3rdparty/rapidjson/document.h"
+#include "3rdparty/rapidjson/error/en.h"
+#include "backend/common/Hashrate.h"
+#include "backend/common/interfaces/IBackend.h"
+#include "base/io/json/JsonChain.h"
+#include "base/io/log/Log.h"
 #include "base/kernel/Process.h"
+#include "base/kernel/interfaces/ILogBackend.h"
+#include "base/tools/Buffer.h"
+#include "base/tools/Chrono.h"
 #include "core/Controller.h"
 #include "core/Miner.h"
+#include "crypto/rx/RxCache.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <thread>
 #include <vector>
 #include <string>
 #include <mutex>
 #include <atomic>
-#include <fstream>
 #include <unistd.h>
-#include <fcntl.h>
+#include <sys/resource.h>
+#include <cerrno>
 #include <cinttypes>
-#include <getopt.h>
-#include <sys/stat.h>
+#include <cstddef>
+#include <cstring>
 
-#include <os/log.h>
+#include <uv.h>
 
 using namespace xmrig;
 
-static os_log_t g_ios_log = os_log_create("com.iml1s.xmrigminer", "XMRigCore");
+static std::thread g_mining_thread;
+static std::atomic<bool> g_is_running{false};
+static Process* g_process = nullptr;
+static Controller* g_controller = nullptr;
+static std::string g_storage_path = "";
+static rapidjson::Document g_config; // set by xmrig_init_v8, read by the core on start
+static rapidjson::Document g_bench_config; // xmrig_benchmark_v8's, preferred while it runs
+static std::mutex g_mutex;
+
+// Opt-in RandomX cache files under <storage path>/randomx
+static RxCacheStore g_rx_cache;
+
+// Mining history in <storage path>/history.bin, one sample every 10 s
+static HistoryStore g_history;
+
+// Next-epoch cache: built into the store on a detached low-priority thread
+// while hashing goes on, so the seed switch only has to load it
+static constexpr size_t kSeedSize = 32;
+
+static std::mutex g_precompute_mutex;
+static std::condition_variable g_precompute_cv;
+static uint8_t g_precompute_seed[kSeedSize]; // last seed handed to the thread
+static bool g_precompute_busy = false;
+static uint8_t g_next_seed[kSeedSize];       // loop thread, from the job being parsed
+static bool g_next_seed_valid = false;
+static thread_local bool t_precompute = false;
+
+// Stats: owned by the loop thread, published to readers through a seqlock
+static constexpr uint64_t kStatsInterval = 1000;
+static constexpr size_t kMaxHashSlots = 1 + 64; // backend total + worker threads
+static constexpr size_t kEnergyHistory = 15 * 60 + 1; // one sample per stats tick
+
+struct EnergySample {
+    uint64_t ms;            // steady clock
+    uint64_t hashes;
+    uint64_t energy_uj;
+};
+
+static struct {
+    uint64_t counts[kMaxHashSlots]; // last cumulative count reported per slot
+    uint64_t base[kMaxHashSlots];   // hashes carried over from restarted workers
+    double hashrate[3];
+    double thread_hashrate[XMRIG_STATS_PAGE_THREADS];
+    double thread_hashrate_60s[XMRIG_STATS_PAGE_THREADS];
+    uint64_t accepted;
+    uint64_t rejected;
+    uint64_t diff;
+    uint64_t height;
+    bool donate;
+    int threads;
+    EnergySample energy[kEnergyHistory]; // ring, contiguous samples only
+    size_t energy_head;
+    size_t energy_count;
+    double power_w;
+    double hashes_per_joule[3];
+} g_core;
+
+static SeqLock<XMRigStats> g_stats;
+static uv_timer_t g_stats_timer;
+
+// Shared stats page: same single writer, read in place by the host. The
+// header words (magic..sequence) are fixed, the rest is rewritten per update.
+static constexpr size_t kPageHeaderSize = offsetof(XMRigStatsPage, updated_ms);
+static_assert(kPageHeaderSize % sizeof(uint64_t) == 0 && sizeof(XMRigStatsPage) % sizeof(uint64_t) == 0,
+              "XMRigStatsPage must be made of whole 64-bit words");
+
+static XMRigStatsPage make_page() {
+    XMRigStatsPage page = {};
+    page.magic = XMRIG_STATS_PAGE_MAGIC;
+    page.version = XMRIG_STATS_PAGE_VERSION;
+    page.size = sizeof(XMRigStatsPage);
+    return page;
+}
+
+alignas(64) static XMRigStatsPage g_page = make_page();
+
+// Latest energy meter reading, for the benchmark on the host thread
+struct EnergyReading {
+    uint64_t ms;
+    uint64_t energy_uj;
+    bool valid;
+};
+
+static SeqLock<EnergyReading> g_energy;
+
+// Donation switch timing, measured on the loop thread from the moment
+// DonateStrategy decides to switch until the other side's first job
+static XMRigDonateStats g_donate;
+static uint64_t g_donate_switch_ms = 0; // steady clock, 0 when no switch is pending
+static bool g_donate_switch_in = false;
+static SeqLock<XMRigDonateStats> g_donate_stats;
+
+// Hash ledger for donation accounting, kept across starts so restarts do
+// not forgive the debt
+static struct {
+    uint64_t user;
+    uint64_t donated;
+    uint64_t last_total;    // total_hashes() at the last credit, reset per start
+} g_ledger;
+
+// Job switch timing: the loop thread stamps receive, parse and dispatch;
+// worker threads clear their bit in g_switch_pending with their first
+// hash on the dispatched job, the last one closes the switch
+static constexpr uint64_t kSwitchLogInterval = 10 * 60 * 1000; // ms
+
+static struct {
+    uint64_t received_us;   // last line from any pool
+    uint64_t parsed_us;     // inside a JobNotify scope, else 0
+    uint64_t logged_jobs;   // jobs at the last summary line
+    uint64_t logged_ms;
+    std::string job_id;     // job the Miner is on
+} g_switch;
+static std::atomic<uint64_t> g_switch_dispatched{0};    // us
+static std::atomic<uint64_t> g_switch_received{0};      // us, 0 when not straight from a pool line
+static std::atomic<uint64_t> g_switch_pending{0};       // workers yet to hash the dispatched job
+static std::atomic<uint64_t> g_switch_consumed{0};      // of those, the ones that picked it up
+static std::atomic<uint64_t> g_switch_jobs{0};
+static std::atomic<uint64_t> g_switch_shares{0};
+static std::atomic<uint64_t> g_switch_stale{0};
+static LatencyHistogram g_parse_latency;
+static LatencyHistogram g_dispatch_latency;
+static LatencyHistogram g_first_hash_latency;
+static LatencyHistogram g_switch_latency;
+
+// Startup timeline: steady us of xmrig_start_v8, then each mark as an
+// offset from it, set from whichever thread reaches the milestone
+static std::atomic<uint64_t> g_startup_begin{0};
+static std::atomic<uint64_t> g_startup[XMRIG_STARTUP_PHASES];
+static std::atomic<uint32_t> g_startup_attempts{0};
+static std::atomic<uint32_t> g_startup_threads{0};
+static std::atomic<bool> g_startup_tls{false};
+static std::atomic<bool> g_startup_disk{false};
+
+static const char* const kStartupPhaseNames[XMRIG_STARTUP_PHASES] = {
+    "config", "init", "dns", "connect", "tls", "login", "job", "rx cache", "rx dataset", "threads", "first hash", "first share"
+};
+
+// Events: queued and delivered on the loop thread, one callback per batch
+static constexpr uint32_t kDefaultEventInterval = 250;
+static constexpr size_t kEventBatch = 64;
+
+static XMRigEvent g_events[kEventBatch];
+static size_t g_event_count = 0;
+static uint8_t g_last_seed[32];
+static std::mutex g_event_mutex; // guards callback + context against the host thread
+static std::atomic<bool> g_events_enabled{false};
+static xmrig_event_callback_t g_event_callback = nullptr;
+static void* g_event_context = nullptr;
+static uint32_t g_event_interval = kDefaultEventInterval;
+static uv_timer_t g_event_timer;
+
+// Commands from host threads, executed on the loop thread that owns the Controller
+static constexpr uint32_t kCommandPause = 1; // apply g_paused
+static constexpr uint32_t kCommandStop = 2;
+
+static std::atomic<uint32_t> g_commands{0};
+static std::mutex g_command_mutex; // guards g_command_ready against the handle closing
+static bool g_command_ready = false;
+static uv_async_t g_command_async;
+
+// Pause/resume: worker bitmasks are written from the CpuWorker threads
+static std::atomic<bool> g_paused{false};
+static std::atomic<uint64_t> g_workers{0};        // started CpuWorker threads
+static std::atomic<uint64_t> g_busy_workers{0};   // workers not parked in the pause loop
+static std::atomic<uint64_t> g_pause_requested{0};  // us, 0 when nothing is pending
+static std::atomic<uint64_t> g_resume_requested{0};
+static std::atomic<uint64_t> g_pause_latency{0};
+static std::atomic<uint64_t> g_resume_latency{0};
+static std::mutex g_wake_mutex;
+static std::condition_variable g_wake_cv;
+static uint64_t g_wake_generation = 0;
+static std::atomic<bool> g_stopping{false};
+
+// Benchmark: one xmrig_benchmark_v8 call at a time, results from the bench hooks
+static std::mutex g_bench_call_mutex;   // serializes xmrig_benchmark_v8
+static std::mutex g_bench_mutex;        // guards the fields below
+static std::condition_variable g_bench_cv;
+static std::atomic<bool> g_bench_active{false}; // read lock-free by the hash loop
+static bool g_bench_done = false;
+static uint64_t g_bench_ready_ms = 0;
+static XMRigBenchmarkResult g_bench_result;
+static EnergyReading g_bench_energy;    // when the workers became ready
+static std::atomic<uint64_t> g_bench_first_hash{0}; // us, steady clock
+
+// Park masks: the host's thread count and the governor's share, combined
+// into bridge::parkedWorkers
+static std::mutex g_park_mutex;
+static uint64_t g_user_parked = 0;
+static uint64_t g_governor_parked = 0;
+
+// Governor: limits and host readings come from any thread, decisions are
+// made on the loop thread and published through a seqlock
+static constexpr uint64_t kGovernorTick = 100;        // ms, duty-cycle resolution
+static constexpr uint32_t kGovernorDutySlots = 10;    // ticks per duty period
+static constexpr uint32_t kDefaultGovernorInterval = 2000;
+static constexpr double kDefaultHysteresis = 3.0;
+static constexpr double kBudgetDown = 0.10;           // per poll while over a limit
+static constexpr double kBudgetUp = 0.05;             // per poll once cooled down
+static constexpr int kBatteryHysteresis = 2;          // percent
+
+static XMRigSensors unknown_sensors() {
+    XMRigSensors sensors = {};
+    sensors.soc_temp_c = XMRIG_TEMP_UNKNOWN;
+    sensors.battery_temp_c = XMRIG_TEMP_UNKNOWN;
+    sensors.battery_level = -1;
+    return sensors;
+}
+
+static std::mutex g_governor_mutex;     // guards the options and reported sensors
+static std::atomic<bool> g_governor_enabled{false};
+static XMRigGovernorOptions g_governor_options = {};
+static XMRigSensors g_reported_sensors = unknown_sensors();
+static SeqLock<XMRigGovernorState> g_governor_state;
+static uv_timer_t g_governor_timer;
+
+static struct {
+    uint64_t next_poll;         // steady ms
+    uint32_t tick;
+    double thermal;             // share the temperature loop allows, 0..1
+    uint32_t thermal_limits;    // sensors that pushed it below 1
+    bool low_battery;
+    bool active;                // enabled as of the last tick
+    XMRigSensors sensors;
+} g_governor;
+
+// Thread accounting: workers register their kernel tid, the loop thread
+// samples /proc with the stats tick
+struct ThreadSampler {
+    xmrig::bridge::platform::ThreadProbe probe;
+    uint64_t ticks;
+    uint64_t sampled_ms;
+    uint64_t migrations;    // counted from core changes when the kernel has none
+    uint64_t last_migrations;
+    uint64_t migrated_ms;   // last sample that saw the migration count grow
+    int cpu;
+};
+
+// A thread is slow below these shares of its own 60s rate or of the fastest
+// busy peer; a core is throttled below this share of its maximum clock
+static constexpr double kSlowRatio = 0.8;
+static constexpr double kPeerRatio = 0.6;
+static constexpr double kThrottleRatio = 0.9;
+static constexpr uint64_t kMigrationWindow = 10000; // ms
+
+struct ThreadStatsSnapshot {
+    uint32_t count;
+    XMRigThreadStats threads[XMRIG_THREAD_STATS_MAX];
+};
+
+static std::atomic<int> g_worker_tids[XMRIG_THREAD_STATS_MAX];
+static ThreadSampler g_samplers[XMRIG_THREAD_STATS_MAX];
+static SeqLock<ThreadStatsSnapshot> g_thread_stats;
+
+// Logs: XMRig's logger and the stdout pipe feed a ring drained by one consumer thread
+static constexpr size_t kLogLineSize = 240;
+static constexpr size_t kLogBatch = 64;
+static constexpr uint32_t kDefaultLogInterval = 250;
+
+struct LogEntry {
+    uint64_t timestamp;
+    int32_t level;
+    uint32_t length;
+    char text[kLogLineSize];
+};
+
+static MpscRing<LogEntry, 256> g_log_ring;
+static std::atomic<uint64_t> g_log_dropped{0};
+static std::atomic<uint32_t> g_log_interval{kDefaultLogInterval};
+static std::mutex g_log_mutex; // guards the callbacks and the consumer wake-up
+static std::condition_variable g_log_cv;
+static bool g_log_stop = false;
+static std::thread g_log_consumer;
+static xmrig_log_callback_t g_log_callback = nullptr;
+static xmrig_log_batch_callback_t g_log_batch_callback = nullptr;
+static void* g_log_batch_context = nullptr;
+
+// Pipe for capturing stdout/stderr, kept across restarts until xmrig_cleanup_v8
+static int g_pipe_fd[2] = {-1, -1};
+static int g_saved_stdout = -1;
+static int g_saved_stderr = -1;
+
+// Never blocks: lines are dropped and counted when the consumer falls behind
+static void log_line(int level, const char* text, size_t length, uint64_t timestamp) {
+    if (!xmrig::bridge::isLogEnabled(level)) return;
+
+    const bool queued = g_log_ring.push([&](LogEntry& entry) {
+        entry.timestamp = timestamp;
+        entry.level = level;
+        entry.length = static_cast<uint32_t>(std::min(length, kLogLineSize - 1));
+        memcpy(entry.text, text, entry.length);
+        entry.text[entry.length] = '\0';
+    });
+
+    if (!queued) {
+        g_log_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void bridge_log(int level, const char* text) {
+    log_line(level, text, strlen(text), Chrono::currentMSecsSinceEpoch());
+}
+
+// Receives every line XMRig logs, after the level gate in Log::print()
+class LogSink : public ILogBackend {
+public:
+    void print(uint64_t timestamp, int level, const char* line, size_t, size_t size, bool colors) override {
+        // Log hands each backend the line twice, with and without colors
+        if (colors) return;
+
+        while (size > 0 && (line[size - 1] == '\n' || line[size - 1] == '\r')) {
+            --size;
+        }
+        log_line(level, line, size, timestamp);
+    }
+};
+
+static void deliver_logs(const LogEntry* entries, size_t count) {
+    if (count == 0) return;
+
+    XMRigLogLine lines[kLogBatch];
+    std::string console;
+
+    for (size_t i = 0; i < count; ++i) {
+        lines[i].level = entries[i].level;
+        lines[i].length = entries[i].length;
+        lines[i].timestamp_ms = entries[i].timestamp;
+        lines[i].text = entries[i].text;
+
+        xmrig::bridge::platform::log(entries[i].level, entries[i].text, entries[i].length);
+
+        // Mirror to the original stdout when the platform captures it
+        if (g_saved_stdout != -1) {
+            console.append("[XMRIG] ").append(entries[i].text, entries[i].length).append(1, '\n');
+        }
+    }
+
+    if (!console.empty()) {
+        (void)write(g_saved_stdout, console.data(), console.size());
+    }
+
+    std::lock_guard<std::mutex> lock(g_log_mutex);
+    if (g_log_batch_callback) {
+        g_log_batch_callback(lines, count, g_log_batch_context);
+    }
+    if (g_log_callback) {
+        for (size_t i = 0; i < count; ++i) {
+            g_log_callback(lines[i].text);
+        }
+    }
+}
+
+static void consume_logs() {
+    static LogEntry batch[kLogBatch]; // this thread only
+    bool stop = false;
+
+    while (!stop) {
+        {
+            std::unique_lock<std::mutex> lock(g_log_mutex);
+            g_log_cv.wait_for(lock, std::chrono::milliseconds(g_log_interval.load()), [] { return g_log_stop; });
+            stop = g_log_stop;
+        }
+
+        size_t count = 0;
+        while (g_log_ring.pop([&](const LogEntry& entry) { memcpy(&batch[count], &entry, sizeof(LogEntry)); })) {
+            if (++count == kLogBatch) {
+                deliver_logs(batch, count);
+                count = 0;
+            }
+        }
+
+        const uint64_t dropped = g_log_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped) {
+            if (count == kLogBatch) {
+                deliver_logs(batch, count);
+                count = 0;
+            }
+
+            LogEntry& entry = batch[count++];
+            entry.timestamp = Chrono::currentMSecsSinceEpoch();
+            entry.level = XMRIG_LOG_WARNING;
+            entry.length = static_cast<uint32_t>(snprintf(entry.text, sizeof(entry.text), "[BRIDGE] %" PRIu64 " log lines dropped", dropped));
+        }
+
+        deliver_logs(batch, count);
+    }
+}
+
+// Frames lines across reads; owns and closes the read end on EOF
+static void capture_pipe(int fd) {
+    char buffer[4096];
+    std::string pending;
+
+    for (;;) {
+        const ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+
+        pending.append(buffer, static_cast<size_t>(n));
+
+        size_t start = 0;
+        size_t end;
+        while ((end = pending.find('\n', start)) != std::string::npos) {
+            log_line(XMRIG_LOG_INFO, pending.data() + start, end - start, Chrono::currentMSecsSinceEpoch());
+            start = end + 1;
+        }
+        pending.erase(0, start);
+
+        // A line longer than a ring slot is passed on in slot sized pieces
+        if (pending.size() >= kLogLineSize - 1) {
+            log_line(XMRIG_LOG_INFO, pending.data(), pending.size(), Chrono::currentMSecsSinceEpoch());
+            pending.clear();
+        }
+    }
+
+    if (!pending.empty()) {
+        log_line(XMRIG_LOG_INFO, pending.data(), pending.size(), Chrono::currentMSecsSinceEpoch());
+    }
+    close(fd);
+}
+
+static void flush_events() {
+    if (g_event_count == 0) return;
+
+    std::lock_guard<std::mutex> lock(g_event_mutex);
+    if (g_event_callback) {
+        g_event_callback(g_events, g_event_count, g_event_context);
+    }
+    g_event_count = 0;
+}
+
+// Returns a zeroed slot to fill in, or nullptr when nobody listens
+static XMRigEvent* push_event(uint32_t type, uint32_t flags) {
+    if (!g_events_enabled.load(std::memory_order_relaxed)) return nullptr;
+
+    if (g_event_count == kEventBatch) {
+        flush_events();
+    }
+
+    XMRigEvent* event = &g_events[g_event_count++];
+    memset(event, 0, sizeof(XMRigEvent));
+    event->type = type;
+    event->flags = flags;
+    event->timestamp_ms = Chrono::steadyMSecs();
+
+    return event;
+}
+
+static void on_event_timer(uv_timer_t*) {
+    flush_events();
+}
+
+static uint64_t cpu_time_us() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+    return static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+           static_cast<uint64_t>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+// Seqlock write of the stats page; payload words go out as relaxed atomic
+// stores between the two sequence bumps, like SeqLock::store.
+static void publish_page(bool mining, uint64_t total_hashes) {
+    XMRigStatsPage next = g_page;
+    next.updated_ms = Chrono::currentMSecsSinceEpoch();
+    next.hashrate_10s = g_core.hashrate[0];
+    next.hashrate_60s = g_core.hashrate[1];
+    next.hashrate_15m = g_core.hashrate[2];
+    next.total_hashes = total_hashes;
+    next.accepted_shares = g_core.accepted;
+    next.rejected_shares = g_core.rejected;
+    next.diff = g_core.diff;
+    next.height = g_core.height;
+    next.cpu_time_us = cpu_time_us();
+    next.flags = (mining ? XMRIG_STATS_PAGE_MINING : 0) |
+                 (g_paused.load() ? XMRIG_STATS_PAGE_PAUSED : 0) |
+                 (g_core.donate ? XMRIG_STATS_PAGE_DONATE : 0);
+    next.threads = static_cast<uint32_t>(std::max(g_core.threads, 0));
+    memcpy(next.thread_hashrate, g_core.thread_hashrate, sizeof(next.thread_hashrate));
+
+    constexpr size_t words = (sizeof(XMRigStatsPage) - kPageHeaderSize) / sizeof(uint64_t);
+    uint64_t payload[words];
+    memcpy(payload, reinterpret_cast<const uint8_t*>(&next) + kPageHeaderSize, sizeof(payload));
+    uint64_t* target = reinterpret_cast<uint64_t*>(reinterpret_cast<uint8_t*>(&g_page) + kPageHeaderSize);
+
+    const uint32_t seq = __atomic_load_n(&g_page.sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_page.sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (size_t i = 0; i < words; ++i) {
+        __atomic_store_n(&target[i], payload[i], __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&g_page.sequence, seq + 2, __ATOMIC_RELEASE);
+}
+
+// Seqlock read of the stats page, for host threads inside the bridge
+static XMRigStatsPage read_page() {
+    constexpr size_t words = (sizeof(XMRigStatsPage) - kPageHeaderSize) / sizeof(uint64_t);
+    const uint64_t* source = reinterpret_cast<const uint64_t*>(reinterpret_cast<const uint8_t*>(&g_page) + kPageHeaderSize);
+    XMRigStatsPage page = make_page();
+    uint64_t payload[words];
+    uint32_t before;
+
+    do {
+        before = __atomic_load_n(&g_page.sequence, __ATOMIC_ACQUIRE);
+        for (size_t i = 0; i < words; ++i) {
+            payload[i] = __atomic_load_n(&source[i], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((before & 1) || before != __atomic_load_n(&g_page.sequence, __ATOMIC_RELAXED));
+
+    memcpy(reinterpret_cast<uint8_t*>(&page) + kPageHeaderSize, payload, sizeof(payload));
+    page.sequence = before;
+    return page;
+}
+
+static void sample_threads() {
+    ThreadStatsSnapshot snapshot = {};
+    const uint64_t now = Chrono::steadyMSecs();
+    const double ticks_per_ms = xmrig::bridge::platform::clockTicks() / 1000.0;
+    const uint64_t workers = g_workers.load();
+    const uint64_t idle = ~g_busy_workers.load();
+    const uint32_t fastest_khz = xmrig::bridge::platform::fastestCpuKHz();
+
+    double fastest_peer = 0.0;
+    for (size_t id = 0; id < XMRIG_THREAD_STATS_MAX; ++id) {
+        if ((workers & ~idle) & (1ULL << id)) {
+            fastest_peer = std::max(fastest_peer, g_core.thread_hashrate[id]);
+        }
+    }
+
+    for (size_t id = 0; id < XMRIG_THREAD_STATS_MAX; ++id) {
+        ThreadSampler& sampler = g_samplers[id];
+        const uint64_t bit = 1ULL << id;
+        const int tid = (workers & bit) ? g_worker_tids[id].load() : 0;
+
+        // New or restarted worker: fresh files and counters
+        if (tid != sampler.probe.tid()) {
+            sampler.probe.close();
+            sampler.ticks = 0;
+            sampler.sampled_ms = 0;
+            sampler.migrations = 0;
+            sampler.last_migrations = 0;
+            sampler.migrated_ms = 0;
+            sampler.cpu = -1;
+            if (tid) sampler.probe.open(tid);
+        }
+
+        xmrig::bridge::platform::ThreadCounters counters;
+        if (!sampler.probe.tid() || !sampler.probe.read(counters)) continue;
+
+        if (!counters.hasMigrations && sampler.sampled_ms && counters.cpu != sampler.cpu) {
+            ++sampler.migrations;
+        }
+
+        XMRigThreadStats& thread = snapshot.threads[snapshot.count++];
+        thread.worker = static_cast<int32_t>(id);
+        thread.tid = tid;
+        thread.cpu = counters.cpu;
+        thread.parked = (idle & bit) != 0;
+        if (sampler.sampled_ms && now > sampler.sampled_ms) {
+            thread.usage = (counters.cpuTicks - sampler.ticks) / ticks_per_ms / (now - sampler.sampled_ms) * 100.0;
+        }
+        thread.cpu_time_ms = static_cast<uint64_t>(counters.cpuTicks / ticks_per_ms);
+        thread.runqueue_wait_ms = counters.runqueueWaitNs / 1000000;
+        thread.voluntary_switches = counters.voluntarySwitches;
+        thread.involuntary_switches = counters.involuntarySwitches;
+        thread.migrations = counters.hasMigrations ? counters.migrations : sampler.migrations;
+        thread.hashes = g_core.base[id + 1] + g_core.counts[id + 1]; // like total_hashes(), across restarts
+        thread.hashrate_10s = g_core.thread_hashrate[id];
+        thread.hashrate_60s = g_core.thread_hashrate_60s[id];
+        xmrig::bridge::platform::cpuFrequency(counters.cpu, thread.freq_khz, thread.max_freq_khz);
+
+        if (sampler.sampled_ms && thread.migrations > sampler.last_migrations) {
+            sampler.migrated_ms = now;
+        }
+        sampler.last_migrations = thread.migrations;
+
+        if (!thread.parked && (thread.hashrate_60s > 0.0 || fastest_peer > 0.0) &&
+            (thread.hashrate_10s < thread.hashrate_60s * kSlowRatio || thread.hashrate_10s < fastest_peer * kPeerRatio)) {
+            thread.flags |= XMRIG_THREAD_SLOW;
+        }
+        if (thread.freq_khz && thread.max_freq_khz && thread.freq_khz < thread.max_freq_khz * kThrottleRatio) {
+            thread.flags |= XMRIG_THREAD_THROTTLED;
+        }
+        if (sampler.migrated_ms && now - sampler.migrated_ms < kMigrationWindow) {
+            thread.flags |= XMRIG_THREAD_MIGRATED;
+        }
+        if (thread.max_freq_khz && thread.max_freq_khz < fastest_khz) {
+            thread.flags |= XMRIG_THREAD_LITTLE_CORE;
+        }
+
+        sampler.ticks = counters.cpuTicks;
+        sampler.sampled_ms = now;
+        sampler.cpu = counters.cpu;
+    }
+
+    g_thread_stats.store(snapshot);
+}
+
+static void reset_thread_stats() {
+    for (ThreadSampler& sampler : g_samplers) {
+        sampler.probe.close();
+    }
+    g_thread_stats.store(ThreadStatsSnapshot{});
+}
+
+static uint64_t total_hashes() {
+    uint64_t total = 0;
+    for (size_t i = 1; i < kMaxHashSlots; ++i) {
+        total += g_core.base[i] + g_core.counts[i];
+    }
+    return total;
+}
+
+// Hashes per joule over the stats windows, from one meter sample per tick.
+// A gap in the readings (no meter, charging) starts the history over.
+static void sample_energy(uint64_t now) {
+    uint64_t energy_uj = 0;
+    if (!xmrig::bridge::platform::readEnergy(energy_uj)) {
+        g_core.energy_count = 0;
+        g_core.power_w = 0.0;
+        memset(g_core.hashes_per_joule, 0, sizeof(g_core.hashes_per_joule));
+        g_energy.store(EnergyReading{});
+        return;
+    }
+
+    g_core.energy_head = (g_core.energy_head + 1) % kEnergyHistory;
+    g_core.energy_count = std::min(g_core.energy_count + 1, kEnergyHistory);
+    const EnergySample& latest = g_core.energy[g_core.energy_head] = { now, total_hashes(), energy_uj };
+    g_energy.store(EnergyReading{ now, energy_uj, true });
+
+    const auto sample = [](size_t age) -> const EnergySample& {
+        return g_core.energy[(g_core.energy_head + kEnergyHistory - age) % kEnergyHistory];
+    };
+
+    // Windows shorter than the history so far use what there is
+    static const size_t windows[3] = { 10, 60, kEnergyHistory - 1 };
+    for (size_t i = 0; i < 3; ++i) {
+        const EnergySample& oldest = sample(std::min(windows[i], g_core.energy_count - 1));
+        const uint64_t joules_uj = latest.energy_uj - oldest.energy_uj;
+        g_core.hashes_per_joule[i] = joules_uj > 0 ? (latest.hashes - oldest.hashes) * 1e6 / joules_uj : 0.0;
+    }
+
+    const EnergySample& previous = sample(std::min<size_t>(1, g_core.energy_count - 1));
+    g_core.power_w = latest.ms > previous.ms ? (latest.energy_uj - previous.energy_uj) / 1000.0 / (latest.ms - previous.ms) : 0.0;
+}
+
+// Builds the snapshot from loop-thread state. Only call on the loop thread.
+static void publish_stats() {
+    XMRigStats stats = {};
+    stats.hashrate_10s = g_core.hashrate[0];
+    stats.hashrate_60s = g_core.hashrate[1];
+    stats.hashrate_15m = g_core.hashrate[2];
+    stats.accepted_shares = g_core.accepted;
+    stats.rejected_shares = g_core.rejected;
+    stats.is_mining = true;
+    stats.threads = g_core.threads;
+    stats.total_hashes = total_hashes();
+    stats.power_w = g_core.power_w;
+    stats.hashes_per_joule_10s = g_core.hashes_per_joule[0];
+    stats.hashes_per_joule_60s = g_core.hashes_per_joule[1];
+    stats.hashes_per_joule_15m = g_core.hashes_per_joule[2];
+
+    g_stats.store(stats);
+    publish_page(true, stats.total_hashes);
+}
+
+// Called before the core starts, while no worker can record
+static void reset_job_switches() {
+    g_switch.received_us = 0;
+    g_switch.parsed_us = 0;
+    g_switch.logged_jobs = 0;
+    g_switch.logged_ms = Chrono::steadyMSecs();
+    g_switch.job_id.clear();
+    g_switch_dispatched = 0;
+    g_switch_received = 0;
+    g_switch_pending = 0;
+    g_switch_consumed = 0;
+    g_switch_jobs = 0;
+    g_switch_shares = 0;
+    g_switch_stale = 0;
+    g_parse_latency.reset();
+    g_dispatch_latency.reset();
+    g_first_hash_latency.reset();
+    g_switch_latency.reset();
+}
+
+static void read_latency(const LatencyHistogram& histogram, XMRigLatency* latency) {
+    latency->p50_us = histogram.percentile(0.50);
+    latency->p95_us = histogram.percentile(0.95);
+    latency->p99_us = histogram.percentile(0.99);
+    latency->max_us = histogram.max();
+    latency->samples = histogram.count();
+}
+
+// One summary line per interval while jobs keep coming
+static void log_job_switches(uint64_t now) {
+    if (now - g_switch.logged_ms < kSwitchLogInterval) return;
+
+    const uint64_t jobs = g_switch_jobs;
+    if (jobs == g_switch.logged_jobs) return;
+
+    g_switch.logged_ms = now;
+    g_switch.logged_jobs = jobs;
+
+    char text[256];
+    snprintf(text, sizeof(text),
+             "[XMRIG BRIDGE] Job switch p50/p95/p99 %.1f/%.1f/%.1f ms (parse %.1f, dispatch %.1f, first hash %.1f ms p95) over %" PRIu64
+             " jobs, %" PRIu64 " of %" PRIu64 " shares stale",
+             g_switch_latency.percentile(0.50) / 1000.0, g_switch_latency.percentile(0.95) / 1000.0, g_switch_latency.percentile(0.99) / 1000.0,
+             g_parse_latency.percentile(0.95) / 1000.0, g_dispatch_latency.percentile(0.95) / 1000.0, g_first_hash_latency.percentile(0.95) / 1000.0,
+             jobs, g_switch_stale.load(), g_switch_shares.load());
+    bridge_log(XMRIG_LOG_INFO, text);
+}
+
+static constexpr uint32_t kHistoryTicks = 10; // stats ticks per history sample
+
+// Loop-thread state between history samples
+static struct {
+    uint32_t ticks;
+    uint64_t hashes;
+    uint64_t accepted;
+    uint64_t rejected;
+    uint64_t cpu_us;
+    uint64_t ms;            // steady
+} g_history_state;
+
+static void reset_history_state() {
+    g_history_state = {};
+    g_history_state.cpu_us = cpu_time_us();
+    g_history_state.ms = Chrono::steadyMSecs();
+}
+
+// Deltas since the previous sample; benchmarks stay out of the history
+static void sample_history(uint64_t now) {
+    if (++g_history_state.ticks < kHistoryTicks) return;
+
+    const uint64_t hashes = total_hashes();
+    const uint64_t cpu_us = cpu_time_us();
+    const uint64_t elapsed_ms = now - g_history_state.ms;
+
+    if (!g_bench_active && elapsed_ms > 0) {
+        XMRigSensors sensors;
+        {
+            std::lock_guard<std::mutex> lock(g_governor_mutex);
+            sensors = g_reported_sensors;
+        }
+        xmrig::bridge::platform::readSensors(sensors);
+
+        XMRigHistorySample sample = {};
+        sample.timestamp_ms = Chrono::currentMSecsSinceEpoch();
+        sample.hashes = hashes - std::min(hashes, g_history_state.hashes);
+        sample.diff = g_core.diff;
+        sample.hashrate_10s = static_cast<float>(g_core.hashrate[0]);
+        sample.hashrate_60s = static_cast<float>(g_core.hashrate[1]);
+        sample.hashrate_15m = static_cast<float>(g_core.hashrate[2]);
+        sample.accepted = static_cast<uint32_t>(g_core.accepted - std::min(g_core.accepted, g_history_state.accepted));
+        sample.rejected = static_cast<uint32_t>(g_core.rejected - std::min(g_core.rejected, g_history_state.rejected));
+        sample.soc_temp_c = static_cast<float>(sensors.soc_temp_c);
+        sample.battery_temp_c = static_cast<float>(sensors.battery_temp_c);
+        sample.cpu_usage = static_cast<float>((cpu_us - std::min(cpu_us, g_history_state.cpu_us)) / 10.0 / elapsed_ms);
+        sample.power_w = static_cast<float>(g_core.power_w);
+        sample.flags = static_cast<uint16_t>(XMRIG_STATS_PAGE_MINING |
+                                             (g_paused.load() ? XMRIG_STATS_PAGE_PAUSED : 0) |
+                                             (g_core.donate ? XMRIG_STATS_PAGE_DONATE : 0));
+        g_history.append(sample);
+    }
+
+    g_history_state.ticks = 0;
+    g_history_state.hashes = hashes;
+    g_history_state.accepted = g_core.accepted;
+    g_history_state.rejected = g_core.rejected;
+    g_history_state.cpu_us = cpu_us;
+    g_history_state.ms = now;
+}
+
+static void on_stats_timer(uv_timer_t*) {
+    Miner* miner = g_controller ? g_controller->miner() : nullptr;
+    if (!miner) return;
+
+    static const size_t intervals[3] = { Hashrate::ShortInterval, Hashrate::MediumInterval, Hashrate::LargeInterval };
+    double hashrate[3] = { 0.0, 0.0, 0.0 };
+    int threads = 0;
+
+    memset(g_core.thread_hashrate, 0, sizeof(g_core.thread_hashrate));
+    memset(g_core.thread_hashrate_60s, 0, sizeof(g_core.thread_hashrate_60s));
+
+    for (IBackend* backend : miner->backends()) {
+        const Hashrate* rate = backend->hashrate();
+        if (!backend->isEnabled() || !rate) continue;
+
+        for (size_t i = 0; i < 3; ++i) {
+            const auto value = rate->calc(intervals[i]);
+            if (value.first) hashrate[i] += value.second;
+        }
+
+        for (size_t id = 0; id < rate->threads(); ++id) {
+            const size_t slot = static_cast<size_t>(threads) + id;
+            if (slot >= XMRIG_STATS_PAGE_THREADS) break;
+
+            const auto value = rate->calc(id, Hashrate::ShortInterval);
+            g_core.thread_hashrate[slot] = value.first ? value.second : 0.0;
+
+            const auto medium = rate->calc(id, Hashrate::MediumInterval);
+            g_core.thread_hashrate_60s[slot] = medium.first ? medium.second : 0.0;
+        }
+        threads += static_cast<int>(rate->threads());
+    }
+
+    // Parked workers still count in Hashrate::threads()
+    threads -= __builtin_popcountll(g_workers.load() & xmrig::bridge::parkedWorkers.load());
+
+    memcpy(g_core.hashrate, hashrate, sizeof(hashrate));
+    g_core.threads = threads;
+    sample_energy(Chrono::steadyMSecs());
+    publish_stats();
+    sample_threads();
+    log_job_switches(Chrono::steadyMSecs());
+    sample_history(Chrono::steadyMSecs());
+
+    if (XMRigEvent* event = push_event(XMRIG_EVENT_HASHRATE, 0)) {
+        event->hashrate.hashrate_10s = hashrate[0];
+        event->hashrate.hashrate_60s = hashrate[1];
+        event->hashrate.hashrate_15m = hashrate[2];
+        event->hashrate.total_hashes = g_stats.load().total_hashes;
+    }
+}
+
+static uint64_t now_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Called under g_mutex before the core thread exists
+static void reset_startup() {
+    for (auto& mark : g_startup) {
+        mark = 0;
+    }
+    g_startup_attempts = 0;
+    g_startup_threads = 0;
+    g_startup_tls = false;
+    g_startup_disk = false;
+    g_startup_begin = now_us();
+}
+
+static uint64_t startup_offset() {
+    return std::max<uint64_t>(now_us() - g_startup_begin.load(), 1); // 0 means not reached
+}
+
+// First time only
+static bool mark_startup(int phase) {
+    uint64_t expected = 0;
+    return g_startup[phase].compare_exchange_strong(expected, startup_offset());
+}
+
+// Connection marks follow each attempt until a login goes through
+static void mark_connect(int phase) {
+    if (g_startup[XMRIG_STARTUP_LOGIN].load() == 0) {
+        g_startup[phase] = startup_offset();
+    }
+}
+
+static void log_startup() {
+    std::string text = "[XMRIG BRIDGE] Startup timeline (ms since start):";
+    char part[48];
+    for (int phase = 0; phase < XMRIG_STARTUP_PHASES; ++phase) {
+        const uint64_t mark = g_startup[phase].load();
+        if (!mark) continue;
+
+        snprintf(part, sizeof(part), " %s %" PRIu64 ",", kStartupPhaseNames[phase], mark / 1000);
+        text += part;
+    }
+    text.pop_back();
+
+    snprintf(part, sizeof(part), "; %u connect attempt(s)", g_startup_attempts.load());
+    text += part;
+    if (g_startup_disk) {
+        text += ", RandomX cache from disk";
+    }
+    bridge_log(XMRIG_LOG_INFO, text.c_str());
+}
+
+static bool parse_seed(const char* hex, uint8_t* seed) {
+    if (!hex || strlen(hex) != kSeedSize * 2) return false;
+
+    for (size_t i = 0; i < kSeedSize * 2; ++i) {
+        const char c = hex[i];
+        const int nibble = (c >= '0' && c <= '9') ? c - '0' :
+                           (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                           (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (nibble < 0) return false;
+
+        seed[i / 2] = static_cast<uint8_t>((i % 2) ? (seed[i / 2] | nibble) : (nibble << 4));
+    }
+    return true;
+}
+
+// Runs XMRig's own cache init for the seed; the loadRxCache/storeRxCache
+// hooks on that path put the result into the store. The Argon2 salt is the
+// current algorithm's, which the next epoch keeps.
+static void precompute_cache(const uint8_t* seed) {
+    {
+        std::lock_guard<std::mutex> lock(g_precompute_mutex);
+        if (g_precompute_busy || memcmp(seed, g_precompute_seed, kSeedSize) == 0) return;
+
+        memcpy(g_precompute_seed, seed, kSeedSize);
+        g_precompute_busy = true;
+    }
+    bridge_log(XMRIG_LOG_INFO, "[XMRIG BRIDGE] Next RandomX seed announced, building its cache in the background");
+
+    std::thread([] {
+        bridge::platform::setBackgroundPriority();
+        t_precompute = true;
+
+        uint8_t seed[kSeedSize];
+        {
+            std::lock_guard<std::mutex> lock(g_precompute_mutex);
+            memcpy(seed, g_precompute_seed, kSeedSize);
+        }
+
+        const uint64_t start = now_us();
+        {
+            RxCache cache(false, 0);
+            cache.init(Buffer(reinterpret_cast<const char*>(seed), kSeedSize));
+        }
+
+        char text[128];
+        snprintf(text, sizeof(text), "[XMRIG BRIDGE] Next RandomX cache built in %" PRIu64 " ms", (now_us() - start) / 1000);
+        bridge_log(XMRIG_LOG_INFO, text);
+
+        {
+            std::lock_guard<std::mutex> lock(g_precompute_mutex);
+            g_precompute_busy = false;
+        }
+        g_precompute_cv.notify_all();
+    }).detach();
+}
+
+// XMRig reached a seed the background thread is still on: finishing it
+// beats starting over, and the idle workers leave it the whole CPU
+static void wait_precompute(const void* key, size_t keySize) {
+    if (t_precompute || keySize != kSeedSize) return;
+
+    std::unique_lock<std::mutex> lock(g_precompute_mutex);
+    if (!g_precompute_busy || memcmp(key, g_precompute_seed, kSeedSize) != 0) return;
+
+    bridge_log(XMRIG_LOG_INFO, "[XMRIG BRIDGE] Waiting for the RandomX cache being built in the background");
+    g_precompute_cv.wait(lock, [] { return !g_precompute_busy; });
+}
+
+static void wake_workers() {
+    {
+        std::lock_guard<std::mutex> lock(g_wake_mutex);
+        ++g_wake_generation;
+    }
+    g_wake_cv.notify_all();
+}
+
+// Publishes the union of both park masks. Call with g_park_mutex held.
+static void apply_parked() {
+    const uint64_t parked = g_user_parked | g_governor_parked;
+    const uint64_t previous = xmrig::bridge::parkedWorkers.exchange(parked);
+
+    if (previous & ~parked) {
+        wake_workers();
+    }
+}
+
+static void reset_governor() {
+    g_governor = {};
+    g_governor.thermal = 1.0;
+    g_governor.sensors = unknown_sensors();
+
+    std::lock_guard<std::mutex> lock(g_park_mutex);
+    g_governor_parked = 0;
+    apply_parked();
+}
+
+// Temperature loop with hysteresis: shrink while any sensor is at its
+// limit, grow back only once every sensor is clear of it by the margin.
+static void poll_governor(const XMRigGovernorOptions& options, const XMRigSensors& reported) {
+    XMRigSensors sensors = reported; // own readings win, host reports fill the gaps
+    xmrig::bridge::platform::readSensors(sensors);
+    g_governor.sensors = sensors;
+
+    const double hysteresis = options.hysteresis_c > 0 ? options.hysteresis_c : kDefaultHysteresis;
+    uint32_t hot = 0;
+    bool cool = true;
+    const auto check = [&](double temp, double limit, uint32_t bit) {
+        if (limit <= 0 || temp <= XMRIG_TEMP_UNKNOWN) return;
+        if (temp >= limit) hot |= bit;
+        if (temp > limit - hysteresis) cool = false;
+    };
+    check(sensors.soc_temp_c, options.target_temp_c, XMRIG_GOVERNOR_SOC_TEMP);
+    check(sensors.battery_temp_c, options.max_battery_temp_c, XMRIG_GOVERNOR_BATTERY_TEMP);
+
+    if (hot) {
+        g_governor.thermal = std::max(0.0, g_governor.thermal - kBudgetDown);
+        g_governor.thermal_limits |= hot;
+    } else if (cool) {
+        g_governor.thermal = std::min(1.0, g_governor.thermal + kBudgetUp);
+    }
+    if (g_governor.thermal >= 1.0) {
+        g_governor.thermal_limits = 0;
+    }
+
+    if (options.min_battery <= 0 || sensors.charging || sensors.battery_level < 0) {
+        g_governor.low_battery = false;
+    } else if (sensors.battery_level < options.min_battery) {
+        g_governor.low_battery = true;
+    } else if (sensors.battery_level >= options.min_battery + kBatteryHysteresis) {
+        g_governor.low_battery = false;
+    }
+}
+
+// Turns the budget into parked workers: the lowest active ids hash full
+// time, the next one runs for part of every duty period, the rest park.
+static void apply_governor(const XMRigGovernorOptions& options, bool publish) {
+    uint64_t active;
+    {
+        std::lock_guard<std::mutex> lock(g_park_mutex);
+        active = g_workers.load() & ~g_user_parked;
+    }
+    const int workers = __builtin_popcountll(active);
+
+    uint32_t limits = g_governor.thermal_limits;
+    double budget = g_governor.thermal;
+
+    // Workers are CPU bound, so each running one is a full core of usage
+    if (options.max_cpu_usage > 0 && workers > 0) {
+        const double cpus = std::max(1u, std::thread::hardware_concurrency());
+        const double ceiling = std::min(1.0, options.max_cpu_usage / 100.0 * cpus / workers);
+        if (ceiling < budget) {
+            budget = ceiling;
+            limits |= XMRIG_GOVERNOR_CPU_USAGE;
+        }
+    }
+    if (g_governor.low_battery) {
+        budget = 0.0;
+        limits |= XMRIG_GOVERNOR_LOW_BATTERY;
+    }
+
+    const double share = budget * workers;
+    uint32_t running = static_cast<uint32_t>(share);
+    uint32_t slots = static_cast<uint32_t>((share - running) * kGovernorDutySlots + 0.5);
+    if (slots == kGovernorDutySlots) {
+        ++running;
+        slots = 0;
+    }
+
+    const bool duty_on = (g_governor.tick % kGovernorDutySlots) < slots;
+    uint64_t parked = 0;
+    uint32_t index = 0;
+    for (uint64_t rest = active; rest; rest &= rest - 1, ++index) {
+        const uint64_t bit = rest & ~(rest - 1);
+        if (index < running || (index == running && duty_on)) continue;
+        parked |= bit;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_park_mutex);
+        if (parked != g_governor_parked) {
+            g_governor_parked = parked;
+            apply_parked();
+        }
+    }
+
+    if (publish) {
+        XMRigGovernorState state = {};
+        state.enabled = true;
+        state.sensors = g_governor.sensors;
+        state.budget = budget;
+        state.running = running;
+        state.duty_percent = slots * 100 / kGovernorDutySlots;
+        state.limits = limits;
+        g_governor_state.store(state);
+    }
+}
+
+static void on_governor_timer(uv_timer_t*) {
+    XMRigGovernorOptions options;
+    XMRigSensors reported;
+    {
+        std::lock_guard<std::mutex> lock(g_governor_mutex);
+        options = g_governor_options;
+        reported = g_reported_sensors;
+    }
+
+    if (!g_governor_enabled) {
+        if (g_governor.active) {
+            reset_governor();
+            g_governor_state.store(XMRigGovernorState{});
+        }
+        return;
+    }
+
+    const uint64_t now = Chrono::steadyMSecs();
+    const bool poll = !g_governor.active || now >= g_governor.next_poll;
+    if (poll) {
+        g_governor.next_poll = now + (options.interval_ms > 0 ? options.interval_ms : kDefaultGovernorInterval);
+        poll_governor(options, reported);
+    }
+
+    g_governor.active = true;
+    apply_governor(options, poll);
+    ++g_governor.tick;
+}
+
+// Host side of the command channel. Commands posted before the loop runs are
+// picked up by the mining thread once the channel opens.
+static void post_command(uint32_t command) {
+    g_commands.fetch_or(command);
+
+    std::lock_guard<std::mutex> lock(g_command_mutex);
+    if (g_command_ready) {
+        uv_async_send(&g_command_async);
+    }
+}
+
+static void close_handle(uv_handle_t* handle) {
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, nullptr);
+    }
+}
+
+static void close_loop_handles() {
+    {
+        std::lock_guard<std::mutex> lock(g_command_mutex);
+        g_command_ready = false;
+    }
+    close_handle(reinterpret_cast<uv_handle_t*>(&g_command_async));
+    close_handle(reinterpret_cast<uv_handle_t*>(&g_stats_timer));
+    close_handle(reinterpret_cast<uv_handle_t*>(&g_event_timer));
+    close_handle(reinterpret_cast<uv_handle_t*>(&g_governor_timer));
+}
+
+static void on_command(uv_async_t*) {
+    const uint32_t commands = g_commands.exchange(0);
+
+    if (commands & kCommandStop) {
+        // Same teardown as App::close(); uv_run returns once the handles are gone.
+        // Paused workers poll every millisecond so Miner::stop() joins them quickly.
+        g_stopping = true;
+        wake_workers();
+        g_controller->stop();
+        close_loop_handles();
+        return;
+    }
+
+    Miner* miner = g_controller->miner();
+    if ((commands & kCommandPause) && miner) {
+        const bool paused = g_paused.load();
+        miner->setEnabled(!paused);
+        if (!paused) {
+            wake_workers();
+        }
+        publish_stats();
+    }
+}
+
+namespace xmrig {
+namespace bridge {
+
+std::atomic<uint64_t> firstHashPending{0};
+std::atomic<uint64_t> parkedWorkers{0};
+std::atomic<int> logLevel{XMRIG_LOG_INFO};
+
+void loadConfig(JsonChain& chain) {
+    // A benchmark never touches g_config, so xmrig_init_v8 can update it meanwhile
+    const rapidjson::Document& config = g_bench_active ? g_bench_config : g_config;
+    if (!config.IsObject()) return;
+
+    rapidjson::Document doc;
+    doc.CopyFrom(config, doc.GetAllocator());
+    chain.add(std::move(doc));
+}
+
+bool loadRxCache(const void* key, size_t keySize, const void* salt, size_t saltSize, uint8_t* memory, size_t size) {
+    if (!g_rx_cache.isEnabled()) return false;
+
+    wait_precompute(key, keySize);
+
+    const uint64_t start = now_us();
+    if (!g_rx_cache.load(key, keySize, salt, saltSize, memory, size)) return false;
+
+    if (!t_precompute && mark_startup(XMRIG_STARTUP_RX_CACHE)) {
+        g_startup_disk = true;
+    }
+
+    char text[128];
+    snprintf(text, sizeof(text), "[XMRIG BRIDGE] RandomX cache loaded from disk in %" PRIu64 " ms", (now_us() - start) / 1000);
+    bridge_log(XMRIG_LOG_INFO, text);
+    return true;
+}
+
+void storeRxCache(const void* key, size_t keySize, const void* salt, size_t saltSize, const uint8_t* memory, size_t size) {
+    // Right after the Argon2 fill, store or not
+    if (!t_precompute) {
+        mark_startup(XMRIG_STARTUP_RX_CACHE);
+    }
+    if (!g_rx_cache.isEnabled()) return;
+
+    const uint64_t start = now_us();
+    char text[128];
+    if (g_rx_cache.store(key, keySize, salt, saltSize, memory, size)) {
+        snprintf(text, sizeof(text), "[XMRIG BRIDGE] RandomX cache saved in %" PRIu64 " ms", (now_us() - start) / 1000);
+        bridge_log(XMRIG_LOG_INFO, text);
+    } else {
+        bridge_log(XMRIG_LOG_WARNING, "[XMRIG BRIDGE] RandomX cache not saved (budget or storage)");
+    }
+}
+
+std::atomic<uint32_t> donateLeadMs{XMRIG_DONATE_DEFAULT_LEAD_MS};
+std::atomic<bool> donateAccounting{false};
+std::atomic<uint32_t> donateRoundMs{XMRIG_DONATE_DEFAULT_ROUND_MS};
+
+double donateDebt(bool donating, double fraction) {
+    const uint64_t total = total_hashes();
+    const uint64_t hashes = total >= g_ledger.last_total ? total - g_ledger.last_total : total;
+    g_ledger.last_total = total;
+
+    (donating ? g_ledger.donated : g_ledger.user) += hashes;
+
+    g_donate.user_hashes = g_ledger.user;
+    g_donate.donated_hashes = g_ledger.donated;
+    g_donate_stats.store(g_donate);
+
+    return fraction * static_cast<double>(g_ledger.user + g_ledger.donated) - static_cast<double>(g_ledger.donated);
+}
+
+double currentHashrate() {
+    return g_core.hashrate[0];
+}
+
+void onDonateSwitch(bool donate) {
+    g_donate_switch_ms = Chrono::steadyMSecs();
+    g_donate_switch_in = donate;
+}
+
+void onNextSeed(const char* hex) {
+    g_next_seed_valid = parse_seed(hex, g_next_seed);
+}
+
+void onHashrateData(size_t index, uint64_t count, uint64_t) {
+    if (index >= kMaxHashSlots) return;
+
+    // Worker counters restart from zero when XMRig recreates its threads
+    if (count < g_core.counts[index]) {
+        g_core.base[index] += g_core.counts[index];
+    }
+    g_core.counts[index] = count;
+}
+
+void onResult(bool accepted, bool donate, uint64_t diff, uint64_t elapsed) {
+    // Same numbers as XMRig's "accepted (a/r)" log: donation shares don't count
+    if (!donate) {
+        if (accepted) {
+            ++g_core.accepted;
+            if (mark_startup(XMRIG_STARTUP_FIRST_SHARE)) {
+                log_startup();
+            }
+        } else {
+            ++g_core.rejected;
+        }
+        publish_stats();
+    }
+
+    const uint32_t type = accepted ? XMRIG_EVENT_SHARE_ACCEPTED : XMRIG_EVENT_SHARE_REJECTED;
+    if (XMRigEvent* event = push_event(type, donate ? XMRIG_EVENT_FLAG_DONATE : 0)) {
+        event->share.diff = diff;
+        event->share.latency_ms = elapsed;
+        event->share.accepted = g_core.accepted;
+        event->share.rejected = g_core.rejected;
+    }
+}
+
+void onJob(uint64_t height, uint64_t diff, const uint8_t* seed, size_t seedSize, bool donate) {
+    uint8_t current[sizeof(g_last_seed)] = {};
+    memcpy(current, seed, std::min(seedSize, sizeof(current)));
+
+    uint32_t flags = donate ? XMRIG_EVENT_FLAG_DONATE : 0;
+    if (memcmp(current, g_last_seed, sizeof(current)) != 0) {
+        memcpy(g_last_seed, current, sizeof(current));
+        flags |= XMRIG_EVENT_FLAG_SEED_CHANGED;
+    }
+
+    g_core.diff = diff;
+    g_core.height = height;
+    g_core.donate = donate;
+    publish_stats();
+
+    if (!donate) {
+        mark_startup(XMRIG_STARTUP_JOB);
+    }
+
+    // Pools send next_seed_hash during the last 64 blocks of an epoch. The
+    // result only lands in the disk store, so without one there is nothing to do.
+    if (g_next_seed_valid && !donate && memcmp(g_next_seed, current, sizeof(current)) != 0 && g_rx_cache.isEnabled()) {
+        precompute_cache(g_next_seed);
+    }
+    g_next_seed_valid = false;
 
-static std::thread g_mining_thread;
-static std::thread g_log_thread;
-static std::atomic<bool> g_is_running{false};
-static Process* g_process = nullptr;
-static App* g_app = nullptr;
-static std::string g_storage_path = "";
-static std::string g_config_path = "";
-static std::mutex g_mutex;
-static xmrig_log_callback_t g_log_callback = nullptr;
+    if (g_donate_switch_ms && donate == g_donate_switch_in) {
+        const uint64_t gap = Chrono::steadyMSecs() - g_donate_switch_ms;
+        if (donate) {
+            ++g_donate.rounds;
+            g_donate.switch_in_ms = gap;
+            g_donate.max_switch_in_ms = std::max(g_donate.max_switch_in_ms, gap);
+        } else {
+            g_donate.switch_out_ms = gap;
+            g_donate.max_switch_out_ms = std::max(g_donate.max_switch_out_ms, gap);
+        }
+        g_donate_switch_ms = 0;
+        g_donate_stats.store(g_donate);
+    }
 
-// Stats globals
-static XMRigStats g_stats = {0};
-static std::mutex g_stats_mutex;
+    if (XMRigEvent* event = push_event(XMRIG_EVENT_JOB, flags)) {
+        event->job.height = height;
+        event->job.diff = diff;
+        memcpy(event->job.seed, current, sizeof(current));
+    }
+}
 
-// Pipe for capturing stdout/stderr
-static int g_pipe_fd[2] = {-1, -1};
-static int g_saved_stdout = -1;
-static int g_saved_stderr = -1;
+void onLine() {
+    g_switch.received_us = now_us();
+}
+
+JobNotify::JobNotify() {
+    g_switch.parsed_us = now_us();
+    g_parse_latency.add(g_switch.parsed_us - g_switch.received_us);
+}
+
+JobNotify::~JobNotify() {
+    g_switch.parsed_us = 0;
+}
+
+void onJobDispatched(const char* jobId) {
+    const uint64_t now = now_us();
+    const bool fresh = g_switch.parsed_us != 0;
+
+    g_switch.job_id = jobId ? jobId : "";
+    ++g_switch_jobs;
+    if (fresh) {
+        g_dispatch_latency.add(now - g_switch.parsed_us);
+    }
+
+    // Workers hashing right now; paused and parked ones pick the job up
+    // on resume, which xmrig_get_pause_stats_v8 already times. An earlier
+    // switch still in progress is dropped.
+    const uint64_t workers = g_busy_workers.load() & ~parkedWorkers.load();
+    g_switch_consumed = 0;
+    g_switch_received = fresh ? g_switch.received_us : 0;
+    g_switch_dispatched = now;
+    g_switch_pending = workers;
+}
+
+void onSubmit(const char* jobId) {
+    ++g_switch_shares;
+    if (!jobId || g_switch.job_id != jobId) {
+        ++g_switch_stale;
+    }
+}
+
+void onJobConsumed(size_t id) {
+    if (id >= 64) return;
+
+    const uint64_t bit = 1ULL << id;
+    if (g_switch_pending.load() & bit) {
+        g_switch_consumed.fetch_or(bit);
+        firstHashPending.fetch_or(bit);
+    }
+}
+
+void onResolved() {
+    if (g_startup[XMRIG_STARTUP_LOGIN].load() != 0) return;
+
+    ++g_startup_attempts;
+    g_startup[XMRIG_STARTUP_CONNECT] = 0;
+    g_startup[XMRIG_STARTUP_TLS] = 0;
+    mark_connect(XMRIG_STARTUP_DNS);
+}
+
+void onConnected() {
+    mark_connect(XMRIG_STARTUP_CONNECT);
+}
+
+void onLoginSent(bool tls) {
+    if (tls) {
+        mark_connect(XMRIG_STARTUP_TLS);
+    }
+    if (g_startup[XMRIG_STARTUP_LOGIN].load() == 0) {
+        g_startup_tls = tls;
+    }
+}
+
+void onLoginReply() {
+    mark_startup(XMRIG_STARTUP_LOGIN);
+}
+
+void onDatasetReady() {
+    mark_startup(XMRIG_STARTUP_RX_DATASET);
+}
+
+void onPoolActive(bool donate, const char* host, uint16_t port, bool tls) {
+    uint32_t flags = (donate ? XMRIG_EVENT_FLAG_DONATE : 0) | (tls ? XMRIG_EVENT_FLAG_TLS : 0);
+    if (XMRigEvent* event = push_event(XMRIG_EVENT_POOL_CONNECTED, flags)) {
+        snprintf(event->pool.host, sizeof(event->pool.host), "%s", host ? host : "");
+        event->pool.port = port;
+    }
+}
+
+void onPoolPaused(bool donate) {
+    push_event(XMRIG_EVENT_POOL_DISCONNECTED, donate ? XMRIG_EVENT_FLAG_DONATE : 0);
+}
+
+void onWorkerStart(size_t id) {
+    if (id >= 64) return;
+
+    g_worker_tids[id] = platform::threadId();
+    g_workers.fetch_or(1ULL << id);
+    g_busy_workers.fetch_or(1ULL << id);
+
+    if (g_startup[XMRIG_STARTUP_FIRST_HASH].load() == 0) {
+        ++g_startup_threads;
+        g_startup[XMRIG_STARTUP_THREADS] = startup_offset();
+    }
+}
+
+void onWorkerStop(size_t id) {
+    if (id >= 64) return;
+
+    g_workers.fetch_and(~(1ULL << id));
+    g_busy_workers.fetch_and(~(1ULL << id));
+    g_worker_tids[id] = 0;
+    firstHashPending.fetch_and(~(1ULL << id));
+    g_switch_consumed.fetch_and(~(1ULL << id));
+    g_switch_pending.fetch_and(~(1ULL << id));
+}
+
+void onWorkerIdle(size_t id) {
+    if (id >= 64) return;
+
+    const uint64_t busy = g_busy_workers.fetch_and(~(1ULL << id)) & ~(1ULL << id);
+    if (busy != 0) return;
+
+    // Last worker out completes the pending pause
+    const uint64_t requested = g_pause_requested.exchange(0);
+    if (requested) {
+        g_pause_latency = now_us() - requested;
+    }
+}
+
+void onWorkerBusy(size_t id) {
+    if (id >= 64) return;
+
+    g_busy_workers.fetch_or(1ULL << id);
+}
+
+void waitPaused(uint64_t timeoutMs) {
+    if (g_stopping) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(g_wake_mutex);
+    const uint64_t generation = g_wake_generation;
+    g_wake_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [generation] { return g_wake_generation != generation; });
+}
+
+void onBenchReady(uint64_t ts, uint32_t threads) {
+    {
+        std::lock_guard<std::mutex> lock(g_bench_mutex);
+        g_bench_ready_ms = ts;
+        g_bench_result.threads = threads;
+        g_bench_energy = g_energy.load();
+    }
+    g_bench_cv.notify_all();
+}
+
+void onBenchDone(uint64_t hash, uint64_t reference, uint64_t ts) {
+    XMRigBenchmarkResult result = {};
+    size_t slot = 0;
+
+    // Average over the whole run: the large window outlasts any benchmark
+    if (Miner* miner = g_controller ? g_controller->miner() : nullptr) {
+        for (IBackend* backend : miner->backends()) {
+            const Hashrate* rate = backend->hashrate();
+            if (!backend->isEnabled() || !rate) continue;
+
+            for (size_t id = 0; id < rate->threads() && slot < XMRIG_BENCHMARK_THREADS; ++id, ++slot) {
+                const auto value = rate->calc(id, Hashrate::LargeInterval);
+                result.thread_hashrate[slot] = value.first ? value.second : 0.0;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_bench_mutex);
+        memcpy(g_bench_result.thread_hashrate, result.thread_hashrate, sizeof(result.thread_hashrate));
+        g_bench_result.duration_ms = ts > g_bench_ready_ms ? ts - g_bench_ready_ms : 0;
+        g_bench_result.hash = hash;
+        g_bench_result.reference = reference;
+        g_bench_result.verified = reference != 0 && hash == reference;
+        g_bench_done = true;
+    }
+    g_bench_cv.notify_all();
+}
+
+void onFirstHash(size_t id) {
+    uint64_t expected = 0;
+    if (g_bench_active) {
+        g_bench_first_hash.compare_exchange_strong(expected, now_us());
+    }
+    mark_startup(XMRIG_STARTUP_FIRST_HASH);
+
+    const uint64_t bit = 1ULL << id;
+    if (g_switch_consumed.fetch_and(~bit) & bit) {
+        const uint64_t now = now_us();
+        g_first_hash_latency.add(now - g_switch_dispatched.load());
+
+        // Last thread on the new job closes the switch
+        const uint64_t received = g_switch_received.load();
+        if ((g_switch_pending.fetch_and(~bit) & ~bit) == 0 && received) {
+            g_switch_latency.add(now - received);
+        }
+    }
+
+    const uint64_t pending = firstHashPending.fetch_and(~bit) & ~bit;
+    if (pending != 0) return;
+
+    const uint64_t requested = g_resume_requested.exchange(0);
+    if (requested) {
+        g_resume_latency = now_us() - requested;
+    }
+}
+
+} // namespace bridge
+} // namespace xmrig
 
 extern "C" {
 
@@ -48,163 +1586,362 @@ void xmrig_set_storage_path_v8(const char* path) {
     if (path) {
         std::lock_guard<std::mutex> lock(g_mutex);
         g_storage_path = path;
-        os_log(g_ios_log, "[XMRIG BRIDGE vFINAL_PROBE] Storage path set to: %{public}s", path);
+        g_rx_cache.setDirectory(g_storage_path + "/randomx");
+        g_history.open(g_storage_path + "/history.bin");
+        bridge_log(XMRIG_LOG_INFO, (std::string("[XMRIG BRIDGE] Storage path set to: ") + path).c_str());
+    }
+}
+
+void xmrig_set_rx_cache_v8(uint64_t budget_bytes) {
+    g_rx_cache.setBudget(budget_bytes);
+    if (budget_bytes == 0) {
+        g_rx_cache.clear();
     }
 }
 
 void xmrig_set_log_callback_v8(xmrig_log_callback_t callback) {
+    std::lock_guard<std::mutex> lock(g_log_mutex);
     g_log_callback = callback;
 }
 
+void xmrig_set_log_batch_callback_v8(xmrig_log_batch_callback_t callback, void* context) {
+    std::lock_guard<std::mutex> lock(g_log_mutex);
+    g_log_batch_callback = callback;
+    g_log_batch_context = context;
+}
+
+void xmrig_set_log_options_v8(int max_level, uint32_t batch_interval_ms) {
+    xmrig::bridge::logLevel = max_level;
+    g_log_interval = batch_interval_ms > 0 ? batch_interval_ms : kDefaultLogInterval;
+}
+
+void xmrig_set_event_callback_v8(xmrig_event_callback_t callback, void* context, uint32_t batch_interval_ms) {
+    std::lock_guard<std::mutex> lock(g_event_mutex);
+    g_event_callback = callback;
+    g_event_context = context;
+    g_event_interval = batch_interval_ms > 0 ? batch_interval_ms : kDefaultEventInterval;
+    g_events_enabled = callback != nullptr;
+}
+
 void xmrig_get_stats_v8(XMRigStats* stats) {
     if (!stats) return;
-    
-    std::lock_guard<std::mutex> lock(g_stats_mutex);
-    stats->hashrate_10s = g_stats.hashrate_10s;
-    stats->hashrate_60s = g_stats.hashrate_60s;
-    stats->hashrate_15m = g_stats.hashrate_15m;
-    stats->total_hashes = g_stats.total_hashes;
-    stats->accepted_shares = g_stats.accepted_shares;
-    stats->rejected_shares = g_stats.rejected_shares;
+
+    *stats = g_stats.load();
     stats->is_mining = g_is_running;
-    stats->threads = g_stats.threads;
 }
 
-void xmrig_update_stats_v8(double hr10s, double hr60s, double hr15m, 
-                         uint64_t accepted, uint64_t rejected, int threads) {
-    std::lock_guard<std::mutex> lock(g_stats_mutex);
-    g_stats.hashrate_10s = hr10s;
-    g_stats.hashrate_60s = hr60s;
-    g_stats.hashrate_15m = hr15m;
-    g_stats.total_hashes += (uint64_t)(hr10s * 10); // Rough estimate for update
-    g_stats.accepted_shares = accepted;
-    g_stats.rejected_shares = rejected;
-    g_stats.threads = threads;
+const XMRigStatsPage* xmrig_get_stats_page_v8(void) {
+    return &g_page;
 }
 
 double xmrig_get_hashrate_v8(void) {
-    std::lock_guard<std::mutex> lock(g_stats_mutex);
-    return g_stats.hashrate_10s;
+    return g_stats.load().hashrate_10s;
+}
+
+void xmrig_get_pause_stats_v8(XMRigPauseStats* stats) {
+    if (!stats) return;
+
+    stats->paused = g_paused;
+    stats->pause_latency_us = g_pause_latency;
+    stats->resume_latency_us = g_resume_latency;
+}
+
+void xmrig_get_job_switch_stats_v8(XMRigJobSwitchStats* stats) {
+    if (!stats) return;
+
+    read_latency(g_parse_latency, &stats->parse);
+    read_latency(g_dispatch_latency, &stats->dispatch);
+    read_latency(g_first_hash_latency, &stats->first_hash);
+    read_latency(g_switch_latency, &stats->total);
+    stats->jobs = g_switch_jobs;
+    stats->shares = g_switch_shares;
+    stats->stale_shares = g_switch_stale;
+}
+
+void xmrig_get_startup_report_v8(XMRigStartupReport* report) {
+    if (!report) return;
+
+    for (int phase = 0; phase < XMRIG_STARTUP_PHASES; ++phase) {
+        report->phase_us[phase] = g_startup[phase];
+    }
+    report->connect_attempts = g_startup_attempts;
+    report->threads = g_startup_threads;
+    report->tls = g_startup_tls;
+    report->rx_cache_from_disk = g_startup_disk;
+}
+
+const char* xmrig_startup_phase_name_v8(int phase) {
+    return phase >= 0 && phase < XMRIG_STARTUP_PHASES ? kStartupPhaseNames[phase] : "";
+}
+
+int xmrig_get_history_v8(int tier, uint64_t from_ms, uint64_t to_ms, XMRigHistorySample* samples, int capacity) {
+    return g_history.query(tier, from_ms, to_ms, samples, capacity);
+}
+
+void xmrig_clear_history_v8(void) {
+    g_history.clear();
 }
 
 void xmrig_set_threads_v8(int threads) {
-    // Not implemented for real core yet, config controls this
+    // Workers beyond the count park in the pause loop; ids are 0-based and
+    // the core never has more workers than it was started with.
+    std::lock_guard<std::mutex> lock(g_park_mutex);
+    g_user_parked = (threads <= 0 || threads >= 64) ? 0 : ~((1ULL << threads) - 1);
+    apply_parked();
+}
+
+int xmrig_set_governor_v8(const XMRigGovernorOptions* options) {
+    if (!options) {
+        g_governor_enabled = false;
+        return 0;
+    }
+
+    const auto temp_ok = [](double temp) { return temp >= 0 && temp <= 150; };
+    if (!temp_ok(options->target_temp_c) || !temp_ok(options->max_battery_temp_c) ||
+        options->hysteresis_c < 0 || options->hysteresis_c > 50 ||
+        options->max_cpu_usage < 0 || options->max_cpu_usage > 100 ||
+        options->min_battery < 0 || options->min_battery > 100) {
+        return -1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_governor_mutex);
+        g_governor_options = *options;
+    }
+    g_governor_enabled = true;
+    return 0;
+}
+
+void xmrig_report_sensors_v8(const XMRigSensors* sensors) {
+    std::lock_guard<std::mutex> lock(g_governor_mutex);
+
+    if (!sensors) {
+        g_reported_sensors = unknown_sensors();
+        return;
+    }
+    if (sensors->soc_temp_c > XMRIG_TEMP_UNKNOWN) g_reported_sensors.soc_temp_c = sensors->soc_temp_c;
+    if (sensors->battery_temp_c > XMRIG_TEMP_UNKNOWN) g_reported_sensors.battery_temp_c = sensors->battery_temp_c;
+    if (sensors->battery_level >= 0) g_reported_sensors.battery_level = sensors->battery_level;
+    g_reported_sensors.charging = sensors->charging;
+}
+
+void xmrig_get_governor_state_v8(XMRigGovernorState* state) {
+    if (!state) return;
+
+    *state = g_governor_state.load();
+    state->enabled = g_governor_enabled;
+}
+
+int xmrig_set_donate_options_v8(const XMRigDonateOptions* options) {
+    if (options && (options->lead_ms > 10 * 60 * 1000 || options->round_ms > 24 * 60 * 60 * 1000)) {
+        return -1;
+    }
+
+    xmrig::bridge::donateLeadMs = options ? options->lead_ms : XMRIG_DONATE_DEFAULT_LEAD_MS;
+    xmrig::bridge::donateAccounting = options && options->hash_accounting;
+    xmrig::bridge::donateRoundMs = (options && options->round_ms) ? options->round_ms : XMRIG_DONATE_DEFAULT_ROUND_MS;
+    return 0;
+}
+
+void xmrig_get_donate_stats_v8(XMRigDonateStats* stats) {
+    if (stats) {
+        *stats = g_donate_stats.load();
+    }
+}
+
+int xmrig_get_thread_stats_v8(XMRigThreadStats* threads, int capacity) {
+    const ThreadStatsSnapshot snapshot = g_thread_stats.load();
+    const int count = static_cast<int>(snapshot.count);
+
+    if (threads && capacity > 0) {
+        memcpy(threads, snapshot.threads, sizeof(XMRigThreadStats) * static_cast<size_t>(std::min(count, capacity)));
+    }
+    return count;
 }
 
 const char* xmrig_version_v8(void) {
     return "6.25.0";
 }
 
+static void set_member(rapidjson::Document& doc, const char* key, bool value) {
+    if (doc.HasMember(key)) {
+        doc[key] = value;
+    } else {
+        doc.AddMember(rapidjson::StringRef(key), value, doc.GetAllocator());
+    }
+}
+
 int xmrig_init_v8(const char* config_json) {
     std::lock_guard<std::mutex> lock(g_mutex);
 
     if (g_is_running) return -1;
+    if (!config_json) return -2;
 
-    // Get the app container root from storage path
-    std::string base_path = g_storage_path.empty() ? "/tmp" : g_storage_path;
+    // Parsed once here; every start hands XMRig a copy via bridge::loadConfig
+    rapidjson::Document doc;
+    doc.Parse(config_json);
+    if (doc.HasParseError() || !doc.IsObject()) {
+        char message[160];
+        snprintf(message, sizeof(message), "[XMRIG BRIDGE] Invalid config JSON at offset %zu: %s",
+                 doc.GetErrorOffset(), rapidjson::GetParseError_En(doc.GetParseError()));
+        bridge_log(XMRIG_LOG_ERR, message);
+        return -2;
+    }
 
-    fprintf(stderr, "[INIT v14] base_path: %s\n", base_path.c_str());
-    os_log(g_ios_log, "[XMRIG BRIDGE v14] base_path: %{public}s", base_path.c_str());
+    // No config file backs this document, so there is nothing to watch.
+    // Background skips ConsoleLog; the bridge's LogSink receives every line.
+    set_member(doc, "watch", false);
+    set_member(doc, "background", true);
 
-    // Find the container root (go up from Documents/Library/Caches to the container)
-    std::string container_root = base_path;
-    size_t pos = container_root.rfind("/Library/");
-    if (pos != std::string::npos) {
-        container_root = container_root.substr(0, pos);
-    } else {
-        pos = container_root.rfind("/Documents");
-        if (pos != std::string::npos) {
-            container_root = container_root.substr(0, pos);
-        }
+    g_config.Swap(doc);
+    return 0;
+}
+
+// XMRig's benchmark sizes: 250K, 500K or 1M..10M
+static bool bench_size(uint32_t size, char* out, size_t length) {
+    if (size == 250000 || size == 500000) {
+        snprintf(out, length, "%uK", size / 1000);
+        return true;
     }
+    if (size % 1000000 == 0 && size >= 1000000 && size <= 10000000) {
+        snprintf(out, length, "%uM", size / 1000000);
+        return true;
+    }
+    return false;
+}
 
-    fprintf(stderr, "[INIT v14] container_root: %s\n", container_root.c_str());
-    os_log(g_ios_log, "[XMRIG BRIDGE v14] Container root: %{public}s", container_root.c_str());
+static bool bench_config(const XMRigBenchmarkOptions* options, rapidjson::Document& doc) {
+    char size[16];
+    if (!bench_size(options->size, size, sizeof(size))) return false;
 
-    // Try writing to container root first
-    g_config_path = container_root + "/.xmrig.json";
-    fprintf(stderr, "[INIT v14] Trying path: %s\n", g_config_path.c_str());
-    os_log(g_ios_log, "[XMRIG BRIDGE v14] Trying primary path: %{public}s", g_config_path.c_str());
+    // The algorithm name is spliced into JSON below, keep it to plain names
+    const char* algo = options->algo ? options->algo : "rx/0";
+    if (!*algo || strspn(algo, "abcdefghijklmnopqrstuvwxyz0123456789/-_") != strlen(algo)) return false;
 
-    std::ofstream out(g_config_path);
-    if (!out.is_open()) {
-        fprintf(stderr, "[INIT v14] Failed primary, errno=%d\n", errno);
-        os_log_error(g_ios_log, "[XMRIG BRIDGE v14] Failed primary path, errno=%d", errno);
+    static const char* modes[] = { "auto", "fast", "light" };
+    if (options->mode < XMRIG_BENCHMARK_MODE_AUTO || options->mode > XMRIG_BENCHMARK_MODE_LIGHT) return false;
+    if (options->priority < -1 || options->priority > 5) return false;
 
-        // Fallback: try writing to base_path directory instead
-        g_config_path = base_path + "/.xmrig.json";
-        fprintf(stderr, "[INIT v14] Fallback path: %s\n", g_config_path.c_str());
-        os_log(g_ios_log, "[XMRIG BRIDGE v14] Trying fallback path: %{public}s", g_config_path.c_str());
+    char priority[32] = "";
+    if (options->priority >= 0) {
+        snprintf(priority, sizeof(priority), ", \"priority\": %d", options->priority);
+    }
 
-        out.open(g_config_path);
-        if (!out.is_open()) {
-            fprintf(stderr, "[INIT v14] Fallback ALSO failed, errno=%d\n", errno);
-            os_log_error(g_ios_log, "[XMRIG BRIDGE v14] Fallback also failed, errno=%d", errno);
-            return -2;
-        }
+    // "*" is XMRig's fallback profile, so it covers every benchmark algorithm
+    char profile[128] = "";
+    if (options->threads > 0 || options->affinity != -1) {
+        const unsigned threads = options->threads > 0 ? static_cast<unsigned>(options->threads) : std::max(1u, std::thread::hardware_concurrency());
+        snprintf(profile, sizeof(profile), ", \"*\": { \"intensity\": 1, \"threads\": %u, \"affinity\": %" PRId64 " }",
+                 threads, options->affinity);
     }
 
-    out << config_json;
-    out.flush();
-    out.close();
-    // Force sync to disk
-    int fd = open(g_config_path.c_str(), O_RDONLY);
-    if (fd >= 0) {
-        fsync(fd);
-        close(fd);
+    char json[1024];
+    snprintf(json, sizeof(json),
+             "{ \"autosave\": false, \"background\": true, \"watch\": false,"
+             " \"cpu\": { \"enabled\": true, \"huge-pages\": %s%s%s },"
+             " \"randomx\": { \"mode\": \"%s\", \"1gb-pages\": false },"
+             " \"benchmark\": { \"size\": \"%s\", \"algo\": \"%s\" } }",
+             options->huge_pages ? "true" : "false", priority, profile, modes[options->mode], size, algo);
+
+    return !doc.Parse(json).HasParseError();
+}
+
+int xmrig_benchmark_v8(const XMRigBenchmarkOptions* options, XMRigBenchmarkResult* result) {
+    if (!options || !result) return -1;
+
+    std::lock_guard<std::mutex> call_lock(g_bench_call_mutex);
+
+    rapidjson::Document doc;
+    if (!bench_config(options, doc)) return -1;
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_is_running) return -1;
+        g_bench_config.Swap(doc);
     }
-    fprintf(stderr, "[INIT v14] SUCCESS written to: %s\n", g_config_path.c_str());
-    fprintf(stderr, "[INIT v14] Config content:\n%s\n", config_json);
-    os_log(g_ios_log, "[XMRIG BRIDGE v14] Written to: %{public}s", g_config_path.c_str());
 
-    // Also create .config directory and write there (in same base as successful write)
-    std::string config_base = g_config_path.substr(0, g_config_path.rfind('/'));
-    std::string config_dir = config_base + "/.config";
-    mkdir(config_dir.c_str(), 0755);
-    std::string alt_path = config_dir + "/xmrig.json";
-    std::ofstream out2(alt_path);
-    if (out2.is_open()) {
-        out2 << config_json;
-        out2.close();
-        fprintf(stderr, "[INIT v14] Also wrote .config: %s\n", alt_path.c_str());
-        os_log(g_ios_log, "[XMRIG BRIDGE v14] Also wrote to %{public}s", alt_path.c_str());
+    uint64_t parked;
+    {
+        std::lock_guard<std::mutex> lock(g_park_mutex);
+        parked = g_user_parked;
+        g_user_parked = 0;
+        apply_parked();
     }
+    const uint64_t start_us = now_us();
+    {
+        std::lock_guard<std::mutex> lock(g_bench_mutex);
+        g_bench_result = {};
+        g_bench_result.size = options->size;
+        g_bench_ready_ms = 0;
+        g_bench_energy = {};
+        g_bench_done = false;
+    }
+    g_bench_active = true;
+    g_bench_first_hash = 0;
+    xmrig::bridge::firstHashPending = ~0ULL;
 
-    return 0;
-}
+    int rc = xmrig_start_v8();
+    if (rc == 0) {
+        std::unique_lock<std::mutex> lock(g_bench_mutex);
+        const uint64_t start_ms = start_us / 1000;
+        const uint64_t deadline = options->timeout_ms > 0 ? start_ms + options->timeout_ms : UINT64_MAX;
+        const auto trial_over = [options] {
+            return options->trial_ms > 0 && g_bench_ready_ms > 0 && Chrono::steadyMSecs() >= g_bench_ready_ms + options->trial_ms;
+        };
 
-static void capture_logs() {
-    char buffer[2048];
-    while (true) {
-        ssize_t n = read(g_pipe_fd[0], buffer, sizeof(buffer) - 1);
-        if (n > 0) {
-            buffer[n] = '\0';
-            // Split by lines
-            char* start = buffer;
-            for (int i = 0; i < n; ++i) {
-                if (buffer[i] == '\n') {
-                    buffer[i] = '\0';
-                    // Write to original stdout so it shows in devicectl --console
-                    if (g_saved_stdout != -1) {
-                        dprintf(g_saved_stdout, "[XMRIG] %s\n", start);
-                    }
-                    os_log(g_ios_log, "%{public}s", start);
-                    if (g_log_callback) g_log_callback(start);
-                    start = buffer + i + 1;
-                }
+        // The core can exit without a result (bad algo, no memory); poll for that
+        while (!g_bench_done && g_is_running && !trial_over() && Chrono::steadyMSecs() < deadline) {
+            g_bench_cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+
+        const bool trial = !g_bench_done && g_is_running && trial_over();
+        rc = (g_bench_done || trial) ? 0 : (g_is_running ? -3 : -2);
+        if (rc == 0) {
+            *result = g_bench_result;
+            result->init_ms = g_bench_ready_ms > start_ms ? g_bench_ready_ms - start_ms : 0;
+
+            if (trial) {
+                // Cut short: XMRig's own 10s averages, no hash sum to verify
+                const XMRigStatsPage page = read_page();
+                result->duration_ms = Chrono::steadyMSecs() - g_bench_ready_ms;
+                result->hashrate = page.hashrate_10s;
+                memcpy(result->thread_hashrate, page.thread_hashrate, sizeof(result->thread_hashrate));
             }
-            if (start < buffer + n) {
-                if (g_saved_stdout != -1) {
-                    dprintf(g_saved_stdout, "[XMRIG] %s\n", start);
-                }
-                os_log(g_ios_log, "%{public}s", start);
-                if (g_log_callback) g_log_callback(start);
+            else {
+                result->hashrate = result->duration_ms > 0 ? result->size * 1000.0 / result->duration_ms : 0.0;
             }
-            if (g_saved_stdout != -1) fsync(g_saved_stdout);
-        } else {
-            break;
+
+            // Meter readings come once per second, so the span is the
+            // sampled one rather than the exact benchmark duration
+            const EnergyReading end = g_energy.load();
+            if (g_bench_energy.valid && end.valid && end.ms > g_bench_energy.ms && end.energy_uj > g_bench_energy.energy_uj) {
+                result->power_w = (end.energy_uj - g_bench_energy.energy_uj) / 1000.0 / (end.ms - g_bench_energy.ms);
+                result->hashes_per_joule = result->hashrate / result->power_w;
+            }
+
+            const uint64_t first_hash = g_bench_first_hash.load();
+            result->first_hash_ms = first_hash > start_us ? (first_hash - start_us) / 1000 : 0;
         }
     }
+
+    xmrig_stop_v8();
+    while (g_is_running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    g_bench_active = false;
+    xmrig::bridge::firstHashPending = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_park_mutex);
+        g_user_parked = parked;
+        apply_parked();
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        rapidjson::Document().Swap(g_bench_config); // frees its allocator too
+    }
+
+    return rc;
 }
 
 int xmrig_start_v8(void) {
@@ -212,79 +1949,133 @@ int xmrig_start_v8(void) {
     
     if (g_is_running) return -1;
     g_is_running = true;
-    
-    if (pipe(g_pipe_fd) == -1) {
-        g_is_running = false;
-        return -2;
+    reset_startup();
+
+    // Redirect stdout/stderr once; restarts keep the pipe and the log threads
+    if (xmrig::bridge::platform::captureStdio() && g_pipe_fd[0] == -1) {
+        if (pipe(g_pipe_fd) == -1) {
+            g_is_running = false;
+            return -2;
+        }
+
+        g_saved_stdout = dup(STDOUT_FILENO);
+        g_saved_stderr = dup(STDERR_FILENO);
+        dup2(g_pipe_fd[1], STDOUT_FILENO);
+        dup2(g_pipe_fd[1], STDERR_FILENO);
+
+        std::thread(capture_pipe, g_pipe_fd[0]).detach();
+    }
+
+    if (!g_log_consumer.joinable()) {
+        g_log_stop = false;
+        g_log_consumer = std::thread(consume_logs);
     }
-    
-    // Save original stdout/stderr
-    g_saved_stdout = dup(STDOUT_FILENO);
-    g_saved_stderr = dup(STDERR_FILENO);
-    
-    // Redirect stdout/stderr to pipe
-    dup2(g_pipe_fd[1], STDOUT_FILENO);
-    dup2(g_pipe_fd[1], STDERR_FILENO);
-    
-    // Start log capture thread
-    g_log_thread = std::thread(capture_logs);
-    g_log_thread.detach();
 
     // Start mining thread
     g_mining_thread = std::thread([]() {
-        if (g_log_callback) g_log_callback("[XMRIG BRIDGE v15] Starting XMRig core...");
+        bridge_log(XMRIG_LOG_INFO, "[XMRIG BRIDGE] Starting XMRig core...");
 
-        fprintf(stderr, "[START v15] Using config path: %s\n", g_config_path.c_str());
-        if (g_saved_stdout != -1) {
-            dprintf(g_saved_stdout, "[START v15] Config path: %s\n", g_config_path.c_str());
-            fsync(g_saved_stdout);
-        }
-
-        // Pass config path explicitly with --config=<path> format
+        // No options: the config comes from xmrig_init_v8 through bridge::loadConfig
         static std::string arg_prog = "xmrig";
-        static std::string arg_config_opt = std::string("--config=") + g_config_path;
-        const char* argv[] = { arg_prog.c_str(), arg_config_opt.c_str(), nullptr };
-        int argc = 2;
-
-        fprintf(stderr, "[START v16] XMRig args: %s %s\n", argv[0], argv[1]);
-        if (g_saved_stdout != -1) {
-            dprintf(g_saved_stdout, "[START v16] XMRig args: %s %s\n", argv[0], argv[1]);
-            fsync(g_saved_stdout);
-        }
+        const char* argv[] = { arg_prog.c_str(), nullptr };
+        int argc = 1;
 
-        // Reset ALL getopt state for re-entry (critical for library usage)
-        optind = 1;
-        opterr = 1;
-        optopt = 0;
-#ifdef __APPLE__
-        optreset = 1;
-#endif
+        // XMRig parses argv with getopt on every start
+        xmrig::bridge::platform::resetGetopt();
 
-        // Set XMRIG_CONFIG_PATH environment variable for our patched Base.cpp
-        setenv("XMRIG_CONFIG_PATH", g_config_path.c_str(), 1);
-        fprintf(stderr, "[START v17] Set XMRIG_CONFIG_PATH=%s\n", g_config_path.c_str());
-        if (g_saved_stdout != -1) {
-            dprintf(g_saved_stdout, "[START v17] Set XMRIG_CONFIG_PATH=%s\n", g_config_path.c_str());
-            fsync(g_saved_stdout);
-        }
+        g_core = {};
+        g_stats.store(XMRigStats{});
+        g_energy.store(EnergyReading{});
+        g_donate = {};
+        g_donate.user_hashes = g_ledger.user;
+        g_donate.donated_hashes = g_ledger.donated;
+        g_ledger.last_total = 0;
+        g_donate_switch_ms = 0;
+        g_donate_stats.store(g_donate);
+        reset_job_switches();
+        reset_history_state();
+        xmrig::bridge::firstHashPending = ~0ULL; // each thread's first hash, for the startup timeline
+        g_paused = false;
+        publish_page(true, 0);
+        reset_governor();
+        g_stopping = false;
+        g_pause_requested = 0;
+        g_resume_requested = 0;
+        g_event_count = 0;
+        memset(g_last_seed, 0, sizeof(g_last_seed));
 
         try {
+            // Drive the Controller ourselves instead of App so the bridge can
+            // read the Miner directly; App has no console or signals to offer here.
             g_process = new Process(argc, (char**)argv);
-            g_app = new App(g_process);
-            g_app->exec();
-        } catch (const std::exception& e) {
-            os_log_error(g_ios_log, "[BRIDGE v10] XMRig exception: %{public}s", e.what());
-            if (g_saved_stdout != -1) {
-                dprintf(g_saved_stdout, "[BRIDGE v10] Exception: %s\n", e.what());
+            g_controller = new Controller(g_process);
+            Log::add(new LogSink());
+            mark_startup(XMRIG_STARTUP_CONFIG);
+
+            if (!g_controller->isReady()) {
+                bridge_log(XMRIG_LOG_ERR, "[XMRIG BRIDGE] No valid configuration found");
+            } else if (g_controller->init() == 0) {
+                mark_startup(XMRIG_STARTUP_INIT);
+                Summary::print(g_controller);
+                g_controller->start();
+
+                uv_timer_init(uv_default_loop(), &g_stats_timer);
+                uv_timer_start(&g_stats_timer, on_stats_timer, kStatsInterval, kStatsInterval);
+                uv_unref(reinterpret_cast<uv_handle_t*>(&g_stats_timer));
+
+                uint32_t event_interval;
+                {
+                    std::lock_guard<std::mutex> lock(g_event_mutex);
+                    event_interval = g_event_interval;
+                }
+                uv_timer_init(uv_default_loop(), &g_event_timer);
+                uv_timer_start(&g_event_timer, on_event_timer, event_interval, event_interval);
+                uv_unref(reinterpret_cast<uv_handle_t*>(&g_event_timer));
+
+                // Benchmarks measure the device unthrottled
+                uv_timer_init(uv_default_loop(), &g_governor_timer);
+                if (!g_bench_active) {
+                    uv_timer_start(&g_governor_timer, on_governor_timer, kGovernorTick, kGovernorTick);
+                }
+                uv_unref(reinterpret_cast<uv_handle_t*>(&g_governor_timer));
+
+                uv_async_init(uv_default_loop(), &g_command_async, on_command);
+                {
+                    std::lock_guard<std::mutex> lock(g_command_mutex);
+                    g_command_ready = true;
+                }
+                // Pause/stop requested while the core was starting
+                on_command(&g_command_async);
+
+                uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+                flush_events();
+                close_loop_handles();
+                uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+                uv_loop_close(uv_default_loop());
             }
+        } catch (const std::exception& e) {
+            bridge_log(XMRIG_LOG_ERR, (std::string("[XMRIG BRIDGE] XMRig exception: ") + e.what()).c_str());
         }
 
-        delete g_app;
+        delete g_controller;
         delete g_process;
-        g_app = nullptr;
+        g_controller = nullptr;
         g_process = nullptr;
+        g_commands = 0;
 
-        if (g_log_callback) g_log_callback("[XMRIG BRIDGE v10] XMRig core stopped.");
+        // Base::init() registers new backends on every start
+        Log::destroy();
+
+        // Workers are gone; the next start governs from full speed
+        reset_governor();
+        g_governor_state.store(XMRigGovernorState{});
+        reset_thread_stats();
+
+        // Last numbers stay readable, only the mining flag drops
+        publish_page(false, g_stats.load().total_hashes);
+
+        bridge_log(XMRIG_LOG_INFO, "[XMRIG BRIDGE] XMRig core stopped.");
         g_is_running = false;
     });
     g_mining_thread.detach();
@@ -295,12 +2086,41 @@ int xmrig_start_v8(void) {
 void xmrig_stop_v8(void) {
     if (!g_is_running) return;
     
-    if (g_log_callback) g_log_callback("[XMRIG BRIDGE] Stopping...");
+    bridge_log(XMRIG_LOG_INFO, "[XMRIG BRIDGE] Stopping...");
     
-    if (g_app) {
-         // g_app->exit(); // Error: no member named exit
-         os_log(g_ios_log, "[XMRIG BRIDGE vFINAL_PROBE] Stop requested but App::exit missing");
+    post_command(kCommandStop);
+}
+
+int xmrig_pause_v8(void) {
+    if (!g_is_running) return -1;
+    if (g_paused.exchange(true)) return 0;
+
+    g_resume_requested = 0;
+    if (g_busy_workers.load() == 0) {
+        g_pause_latency = 0;
+    } else {
+        g_pause_requested = now_us();
+    }
+
+    post_command(kCommandPause);
+    return 0;
+}
+
+int xmrig_resume_v8(void) {
+    if (!g_is_running) return -1;
+    if (!g_paused.exchange(false)) return 0;
+
+    g_pause_requested = 0;
+    const uint64_t workers = g_workers.load() & ~xmrig::bridge::parkedWorkers.load();
+    if (workers == 0) {
+        g_resume_latency = 0;
+    } else {
+        g_resume_requested = now_us();
+        xmrig::bridge::firstHashPending = workers;
     }
+
+    post_command(kCommandPause);
+    return 0;
 }
 
 bool xmrig_is_running_v8(void) {
@@ -312,26 +2132,45 @@ void xmrig_cleanup_v8(void) {
         xmrig_stop_v8();
     }
     
-    // Close pipe ends
-    if (g_pipe_fd[0] != -1) close(g_pipe_fd[0]);
-    if (g_pipe_fd[1] != -1) close(g_pipe_fd[1]);
-    
-    if (g_saved_stdout != -1) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    // Restoring stdout/stderr and closing the write end gives the pipe reader
+    // EOF; it closes the read end itself.
+    if (g_pipe_fd[1] != -1) {
         dup2(g_saved_stdout, STDOUT_FILENO);
+        dup2(g_saved_stderr, STDERR_FILENO);
+        close(g_pipe_fd[1]);
+        g_pipe_fd[0] = -1;
+        g_pipe_fd[1] = -1;
+    }
+
+    // Last batch still mirrors to the saved stdout, close it afterwards
+    if (g_log_consumer.joinable()) {
+        {
+            std::lock_guard<std::mutex> log_lock(g_log_mutex);
+            g_log_stop = true;
+        }
+        g_log_cv.notify_one();
+        g_log_consumer.join();
+    }
+
+    if (g_saved_stdout != -1) {
         close(g_saved_stdout);
+        g_saved_stdout = -1;
     }
     if (g_saved_stderr != -1) {
-        dup2(g_saved_stderr, STDERR_FILENO);
         close(g_saved_stderr);
+        g_saved_stderr = -1;
     }
-    
-    if (!g_config_path.empty()) {
-        unlink(g_config_path.c_str());
-        g_config_path.clear();
+
+    // The loop thread is the only writer while the core runs
+    if (!g_is_running) {
+        g_stats.store(XMRigStats{});
     }
-    
-    std::lock_guard<std::mutex> lock(g_stats_mutex);
-    g_stats = {0};
+
+    // The detached next-epoch build uses XMRig's RandomX globals
+    std::unique_lock<std::mutex> precompute_lock(g_precompute_mutex);
+    g_precompute_cv.wait(precompute_lock, [] { return !g_precompute_busy; });
 }
 
 } // extern "C"
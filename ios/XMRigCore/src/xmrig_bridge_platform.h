@@ -0,0 +1,127 @@
+/**
+ * XMRig Bridge - platform shims
+ *
+ * The bridge core is platform neutral; everything it needs from the host OS
+ * goes through these functions. Exactly one implementation is compiled in:
+ * xmrig_bridge_platform_apple.cpp, _android.cpp or _linux.cpp, with the
+ * sensors and thread counters of the latter two shared in _sysfs.cpp and
+ * _procfs.cpp.
+ */
+
+#ifndef XMRIG_BRIDGE_PLATFORM_H
+#define XMRIG_BRIDGE_PLATFORM_H
+
+#include "xmrig_bridge.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xmrig {
+namespace bridge {
+namespace platform {
+
+
+/**
+ * Hands one delivered log line to the system log (os_log, logcat).
+ * Called on the bridge's log thread, never on a hashing thread.
+ */
+void log(int level, const char *text, size_t length);
+
+/**
+ * Rewinds getopt so XMRig can parse a fresh argv on every start.
+ */
+void resetGetopt();
+
+/**
+ * Whether the bridge should redirect stdout/stderr into its log pipe and
+ * mirror captured lines to the original stdout.
+ */
+bool captureStdio();
+
+/**
+ * Reads SoC and battery temperature and the battery state for the governor.
+ * Called on the loop thread every few seconds; fields it cannot read are
+ * left untouched, so the caller presets them to unknown.
+ */
+void readSensors(XMRigSensors& sensors);
+
+/**
+ * Energy drawn so far in microjoules, for hashes per joule. Called on the
+ * loop thread once per second: package energy counters are read as they
+ * are, battery current x voltage is integrated between calls. Returns
+ * false while no meter is usable, e.g. on a charging battery whose current
+ * is the charge rate rather than the draw.
+ */
+bool readEnergy(uint64_t& microjoules);
+
+/**
+ * Current and maximum clock of one core in kHz, 0 where unknown. Loop
+ * thread only; the current-frequency files stay open between calls.
+ */
+void cpuFrequency(int cpu, uint32_t& currentKHz, uint32_t& maxKHz);
+
+/**
+ * Highest maximum clock of any core in kHz (the big cluster), 0 if unknown.
+ */
+uint32_t fastestCpuKHz();
+
+/**
+ * Kernel id of the calling thread, 0 where the platform has none to offer.
+ */
+int threadId();
+
+/**
+ * Scheduler counters of one thread, cumulative since it started.
+ */
+struct ThreadCounters {
+    uint64_t cpuTicks;          // user + system, in clockTicks() units
+    uint64_t runqueueWaitNs;    // runnable but not on a core, 0 if unknown
+    uint64_t voluntarySwitches;
+    uint64_t involuntarySwitches;
+    uint64_t migrations;        // 0 if the kernel does not count them
+    int cpu;                    // core it last ran on
+    bool hasMigrations;
+};
+
+/**
+ * Reads one thread's counters. The files stay open between samples so a
+ * read costs a few preads; only use it on the loop thread.
+ */
+class ThreadProbe {
+public:
+    ThreadProbe() = default;
+    ThreadProbe(const ThreadProbe&) = delete;
+    ThreadProbe& operator=(const ThreadProbe&) = delete;
+    ~ThreadProbe() { close(); }
+
+    bool open(int tid);
+    void close();
+    bool read(ThreadCounters& counters) const;
+
+    int tid() const { return m_tid; }
+
+private:
+    int m_tid = 0;
+    int m_stat = -1;
+    int m_status = -1;
+    int m_sched = -1;
+    int m_schedstat = -1;
+};
+
+/**
+ * Units of ThreadCounters::cpuTicks per second (sysconf(_SC_CLK_TCK)).
+ */
+long clockTicks();
+
+/**
+ * Drops the calling thread to the lowest scheduling priority, so it only
+ * gets CPU time the hashing threads leave over. Cannot be undone.
+ */
+void setBackgroundPriority();
+
+
+} // namespace platform
+} // namespace bridge
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_PLATFORM_H */
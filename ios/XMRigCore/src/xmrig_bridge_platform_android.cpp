@@ -0,0 +1,43 @@
+#ifdef __ANDROID__
+
+#include "xmrig_bridge_platform.h"
+#include "xmrig_bridge.h"
+
+#include <android/log.h>
+#include <getopt.h>
+
+namespace xmrig {
+namespace bridge {
+namespace platform {
+
+void log(int level, const char* text, size_t) {
+    int priority = ANDROID_LOG_INFO;
+    if (level <= XMRIG_LOG_ERR) {
+        priority = ANDROID_LOG_ERROR;
+    } else if (level == XMRIG_LOG_WARNING) {
+        priority = ANDROID_LOG_WARN;
+    } else if (level == XMRIG_LOG_DEBUG) {
+        priority = ANDROID_LOG_DEBUG;
+    }
+
+    __android_log_write(priority, "XMRig", text);
+}
+
+// bionic takes the BSD reset flag
+void resetGetopt() {
+    optind = 1;
+    opterr = 1;
+    optopt = 0;
+    optreset = 1;
+}
+
+// App stdout goes to /dev/null; every XMRig line already reaches logcat
+bool captureStdio() {
+    return false;
+}
+
+} // namespace platform
+} // namespace bridge
+} // namespace xmrig
+
+#endif /* __ANDROID__ */
@@ -0,0 +1,79 @@
+#ifdef __APPLE__
+
+#include "xmrig_bridge_platform.h"
+#include "xmrig_bridge.h"
+
+#include <getopt.h>
+#include <os/log.h>
+#include <pthread/qos.h>
+
+static os_log_t g_ios_log = os_log_create("com.iml1s.xmrigminer", "XMRigCore");
+
+namespace xmrig {
+namespace bridge {
+namespace platform {
+
+void log(int level, const char* text, size_t) {
+    os_log_with_type(g_ios_log, level <= XMRIG_LOG_ERR ? OS_LOG_TYPE_ERROR : OS_LOG_TYPE_DEFAULT, "%{public}s", text);
+}
+
+void resetGetopt() {
+    optind = 1;
+    opterr = 1;
+    optopt = 0;
+    optreset = 1;
+}
+
+// stdout shows up in devicectl --console, keep mirroring it there
+bool captureStdio() {
+    return true;
+}
+
+// No sysfs here; iOS apps report what they see via xmrig_report_sensors_v8
+void readSensors(XMRigSensors&) {
+}
+
+// IOKit's battery numbers are not available to iOS apps
+bool readEnergy(uint64_t&) {
+    return false;
+}
+
+// No cpufreq either; frequency-based throttling flags stay clear
+void cpuFrequency(int, uint32_t& currentKHz, uint32_t& maxKHz) {
+    currentKHz = 0;
+    maxKHz = 0;
+}
+
+uint32_t fastestCpuKHz() {
+    return 0;
+}
+
+// No /proc; per-thread accounting stays empty on Apple platforms
+int threadId() {
+    return 0;
+}
+
+bool ThreadProbe::open(int) {
+    return false;
+}
+
+void ThreadProbe::close() {
+}
+
+bool ThreadProbe::read(ThreadCounters&) const {
+    return false;
+}
+
+long clockTicks() {
+    return 100;
+}
+
+void setBackgroundPriority() {
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+}
+
+} // namespace platform
+} // namespace bridge
+} // namespace xmrig
+
+#endif /* __APPLE__ */
@@ -0,0 +1,31 @@
+#if defined(__linux__) && !defined(__ANDROID__)
+
+#include "xmrig_bridge_platform.h"
+
+#include <getopt.h>
+
+namespace xmrig {
+namespace bridge {
+namespace platform {
+
+// Hosts get lines through the log callbacks; there is no system log to feed
+void log(int, const char*, size_t) {
+}
+
+// glibc re-initializes its scanner when optind is 0
+void resetGetopt() {
+    optind = 0;
+    opterr = 1;
+    optopt = 0;
+}
+
+// Leave the host's terminal alone
+bool captureStdio() {
+    return false;
+}
+
+} // namespace platform
+} // namespace bridge
+} // namespace xmrig
+
+#endif
@@ -0,0 +1,136 @@
+#ifdef __linux__
+
+#include "xmrig_bridge_platform.h"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace xmrig {
+namespace bridge {
+namespace platform {
+
+int threadId() {
+    return static_cast<int>(syscall(SYS_gettid));
+}
+
+long clockTicks() {
+    static const long ticks = [] {
+        const long value = sysconf(_SC_CLK_TCK);
+        return value > 0 ? value : 100L;
+    }();
+    return ticks;
+}
+
+// Linux niceness is per thread; 19 weighs 15 against a worker's 1024
+void setBackgroundPriority() {
+    setpriority(PRIO_PROCESS, static_cast<id_t>(threadId()), 19);
+}
+
+static int open_task_file(int tid, const char* name) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/%s", tid, name);
+    return ::open(path, O_RDONLY | O_CLOEXEC);
+}
+
+// Files under /proc regenerate their content on every read from offset 0
+static bool read_fd(int fd, char* out, size_t length) {
+    if (fd < 0) return false;
+
+    const ssize_t size = pread(fd, out, length - 1, 0);
+    if (size <= 0) return false;
+
+    out[size] = '\0';
+    return true;
+}
+
+static bool find_field(const char* text, const char* key, uint64_t& value) {
+    const char* line = strstr(text, key);
+    if (!line) return false;
+
+    line += strlen(key);
+    while (*line == ' ' || *line == '\t' || *line == ':') ++line;
+    value = strtoull(line, nullptr, 10);
+    return true;
+}
+
+bool ThreadProbe::open(int tid) {
+    close();
+    if (tid <= 0) return false;
+
+    m_stat = open_task_file(tid, "stat");
+    if (m_stat < 0) return false;
+
+    // Optional: sched needs CONFIG_SCHED_DEBUG, schedstat CONFIG_SCHED_INFO
+    m_status = open_task_file(tid, "status");
+    m_sched = open_task_file(tid, "sched");
+    m_schedstat = open_task_file(tid, "schedstat");
+    m_tid = tid;
+    return true;
+}
+
+void ThreadProbe::close() {
+    int* fds[] = { &m_stat, &m_status, &m_sched, &m_schedstat };
+    for (int* fd : fds) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    m_tid = 0;
+}
+
+bool ThreadProbe::read(ThreadCounters& counters) const {
+    char text[2048];
+    if (!read_fd(m_stat, text, sizeof(text))) return false;
+
+    // The name in parentheses may hold spaces; fields 14/15 (utime, stime)
+    // and 39 (processor) are counted from the state after it, field 3
+    const char* field = strrchr(text, ')');
+    if (!field) return false;
+
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    int cpu = -1;
+    int index = 2;
+    for (const char* p = field + 1; *p && index < 39; ) {
+        while (*p == ' ') ++p;
+        ++index;
+        if (index == 14) utime = strtoull(p, nullptr, 10);
+        else if (index == 15) stime = strtoull(p, nullptr, 10);
+        else if (index == 39) cpu = atoi(p);
+        while (*p && *p != ' ') ++p;
+    }
+
+    counters = {};
+    counters.cpuTicks = utime + stime;
+    counters.cpu = cpu;
+
+    if (read_fd(m_status, text, sizeof(text))) {
+        find_field(text, "\nvoluntary_ctxt_switches", counters.voluntarySwitches);
+        find_field(text, "nonvoluntary_ctxt_switches", counters.involuntarySwitches);
+    }
+    if (read_fd(m_sched, text, sizeof(text))) {
+        counters.hasMigrations = find_field(text, "se.nr_migrations", counters.migrations);
+    }
+    if (read_fd(m_schedstat, text, sizeof(text))) {
+        uint64_t run = 0;
+        uint64_t wait = 0;
+        if (sscanf(text, "%" SCNu64 " %" SCNu64, &run, &wait) == 2) {
+            counters.runqueueWaitNs = wait;
+        }
+    }
+
+    return true;
+}
+
+} // namespace platform
+} // namespace bridge
+} // namespace xmrig
+
+#endif /* __linux__ */
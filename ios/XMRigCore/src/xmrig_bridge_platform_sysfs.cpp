@@ -0,0 +1,279 @@
+#ifdef __linux__
+
+#include "xmrig_bridge_platform.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace xmrig {
+namespace bridge {
+namespace platform {
+
+static bool read_text(const std::string& path, char* out, size_t length) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    const ssize_t size = read(fd, out, length - 1);
+    close(fd);
+    if (size <= 0) return false;
+
+    out[size] = '\0';
+    out[strcspn(out, "\n")] = '\0';
+    return true;
+}
+
+static bool read_long(const std::string& path, long& value) {
+    char text[32];
+    if (!read_text(path, text, sizeof(text))) return false;
+
+    char* end = nullptr;
+    value = strtol(text, &end, 10);
+    return end != text;
+}
+
+static std::vector<std::string> list_dir(const char* path, const char* prefix) {
+    std::vector<std::string> entries;
+    DIR* dir = opendir(path);
+    if (!dir) return entries;
+
+    while (const dirent* entry = readdir(dir)) {
+        if (strncmp(entry->d_name, prefix, strlen(prefix)) == 0) {
+            entries.push_back(std::string(path) + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    return entries;
+}
+
+static bool contains_any(const char* text, const char* const* words) {
+    for (; *words; ++words) {
+        if (strstr(text, *words)) return true;
+    }
+    return false;
+}
+
+// Zone names differ per vendor: cpu-1-0-usr, cpuss-0, soc_thermal,
+// mtktscpu, tsens_tz_sensor3... Zones that are clearly not the SoC
+// (battery, skin, modem, charger) never count.
+static const std::vector<std::string>& soc_zones() {
+    static const std::vector<std::string> zones = [] {
+        static const char* const cpu[] = { "cpu", "soc", "tsens", "cluster", "apc", "big", "little", "x86_pkg", nullptr };
+        static const char* const other[] = { "batt", "bms", "skin", "usb", "charger", "pa_therm", "modem", "xo", "wlan", nullptr };
+
+        std::vector<std::string> matched;
+        std::vector<std::string> fallback;
+        for (const std::string& zone : list_dir("/sys/class/thermal", "thermal_zone")) {
+            char type[64];
+            if (!read_text(zone + "/type", type, sizeof(type))) continue;
+
+            for (char* c = type; *c; ++c) *c = static_cast<char>(tolower(*c));
+            if (contains_any(type, cpu)) {
+                matched.push_back(zone + "/temp");
+            } else if (!contains_any(type, other)) {
+                fallback.push_back(zone + "/temp");
+            }
+        }
+        return matched.empty() ? fallback : matched;
+    }();
+    return zones;
+}
+
+// Most zones report millidegrees, a few older drivers whole degrees
+static double to_celsius(long value) {
+    return (value > 1000 || value < -1000) ? value / 1000.0 : static_cast<double>(value);
+}
+
+static const std::string& battery_dir() {
+    static const std::string dir = [] {
+        for (const std::string& supply : list_dir("/sys/class/power_supply", "")) {
+            char type[32];
+            if (read_text(supply + "/type", type, sizeof(type)) && strcmp(type, "Battery") == 0) {
+                return supply;
+            }
+        }
+        return std::string();
+    }();
+    return dir;
+}
+
+void readSensors(XMRigSensors& sensors) {
+    bool found = false;
+    double hottest = 0.0;
+    for (const std::string& zone : soc_zones()) {
+        long value;
+        if (!read_long(zone, value)) continue;
+
+        const double celsius = to_celsius(value);
+        if (!found || celsius > hottest) hottest = celsius;
+        found = true;
+    }
+    if (found) {
+        sensors.soc_temp_c = hottest;
+    }
+
+    const std::string& battery = battery_dir();
+    if (battery.empty()) return;
+
+    long value;
+    if (read_long(battery + "/capacity", value)) {
+        sensors.battery_level = static_cast<int>(value);
+    }
+    // power_supply reports tenths of a degree
+    if (read_long(battery + "/temp", value)) {
+        sensors.battery_temp_c = value / 10.0;
+    }
+
+    char status[32];
+    if (read_text(battery + "/status", status, sizeof(status))) {
+        sensors.charging = strcmp(status, "Charging") == 0 || strcmp(status, "Full") == 0;
+    }
+}
+
+// Package domains only (intel-rapl:0); their subzones (intel-rapl:0:0) are
+// already included. Usually root-only since the RAPL side channel fixes.
+static const std::vector<std::string>& rapl_domains() {
+    static const std::vector<std::string> domains = [] {
+        std::vector<std::string> packages;
+        for (const std::string& domain : list_dir("/sys/class/powercap", "intel-rapl:")) {
+            if (domain.find(':') == domain.rfind(':')) {
+                packages.push_back(domain);
+            }
+        }
+        return packages;
+    }();
+    return domains;
+}
+
+static bool read_rapl(uint64_t& microjoules) {
+    static std::vector<long> last;
+    static uint64_t total = 0;
+
+    const std::vector<std::string>& domains = rapl_domains();
+    if (domains.empty()) return false;
+    last.resize(domains.size(), -1);
+
+    for (size_t i = 0; i < domains.size(); ++i) {
+        long energy;
+        if (!read_long(domains[i] + "/energy_uj", energy)) return false;
+
+        if (last[i] >= 0) {
+            long range = 0;
+            if (energy >= last[i]) {
+                total += static_cast<uint64_t>(energy - last[i]);
+            } else if (read_long(domains[i] + "/max_energy_range_uj", range) && range > last[i]) {
+                total += static_cast<uint64_t>(range - last[i] + energy); // counter wrapped
+            }
+        }
+        last[i] = energy;
+    }
+
+    microjoules = total;
+    return true;
+}
+
+static uint64_t monotonic_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+// Whole-device draw from the battery side, trapezoid-integrated. Drivers
+// disagree on sign and some report mA / mV instead of uA / uV.
+static bool read_battery_energy(uint64_t& microjoules) {
+    static uint64_t total = 0;
+    static uint64_t last_us = 0;
+    static double last_w = -1.0;
+
+    const std::string& battery = battery_dir();
+    char status[32];
+    long current;
+    long voltage;
+    if (battery.empty() ||
+        !read_long(battery + "/current_now", current) || !read_long(battery + "/voltage_now", voltage) ||
+        (read_text(battery + "/status", status, sizeof(status)) && (strcmp(status, "Charging") == 0 || strcmp(status, "Full") == 0))) {
+        last_w = -1.0;
+        return false;
+    }
+
+    double amps = (current < 0 ? -current : current) / 1e6;
+    if (amps > 0 && amps < 0.01) amps *= 1000.0;
+    double volts = voltage / 1e6;
+    if (volts > 0 && volts < 0.1) volts *= 1000.0;
+
+    const double watts = amps * volts;
+    const uint64_t now = monotonic_us();
+    if (last_w >= 0.0 && now > last_us) {
+        total += static_cast<uint64_t>((last_w + watts) / 2.0 * static_cast<double>(now - last_us));
+    }
+    last_w = watts;
+    last_us = now;
+
+    microjoules = total;
+    return true;
+}
+
+static std::string cpufreq_path(int cpu, const char* name) {
+    return "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/" + name;
+}
+
+static uint32_t max_freq(int cpu) {
+    static std::vector<long> cache; // -1 = not read yet
+    if (cpu < 0) return 0;
+    if (static_cast<size_t>(cpu) >= cache.size()) cache.resize(cpu + 1, -1);
+
+    long& value = cache[cpu];
+    if (value < 0 && !read_long(cpufreq_path(cpu, "cpuinfo_max_freq"), value)) {
+        value = 0;
+    }
+    return static_cast<uint32_t>(value);
+}
+
+void cpuFrequency(int cpu, uint32_t& currentKHz, uint32_t& maxKHz) {
+    static std::vector<int> fds; // -2 = not opened yet, -1 = unavailable
+    currentKHz = 0;
+    maxKHz = max_freq(cpu);
+    if (cpu < 0) return;
+    if (static_cast<size_t>(cpu) >= fds.size()) fds.resize(cpu + 1, -2);
+
+    int& fd = fds[cpu];
+    if (fd == -2) {
+        fd = open(cpufreq_path(cpu, "scaling_cur_freq").c_str(), O_RDONLY | O_CLOEXEC);
+    }
+
+    char text[32];
+    const ssize_t size = fd >= 0 ? pread(fd, text, sizeof(text) - 1, 0) : -1;
+    if (size > 0) {
+        text[size] = '\0';
+        currentKHz = static_cast<uint32_t>(strtoul(text, nullptr, 10));
+    }
+}
+
+uint32_t fastestCpuKHz() {
+    static const uint32_t fastest = [] {
+        uint32_t best = 0;
+        for (long cpu = 0, count = sysconf(_SC_NPROCESSORS_CONF); cpu < count; ++cpu) {
+            best = std::max(best, max_freq(static_cast<int>(cpu)));
+        }
+        return best;
+    }();
+    return fastest;
+}
+
+bool readEnergy(uint64_t& microjoules) {
+    return read_rapl(microjoules) || read_battery_energy(microjoules);
+}
+
+} // namespace platform
+} // namespace bridge
+} // namespace xmrig
+
+#endif /* __linux__ */
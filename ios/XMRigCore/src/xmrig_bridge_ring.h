@@ -0,0 +1,98 @@
+/**
+ * XMRig Bridge - bounded multi-producer, single-consumer ring
+ *
+ * Producers (XMRig's logger, the stdout pipe reader) claim a cell with one
+ * CAS and never wait: when the ring is full the item is dropped and push()
+ * returns false. The single consumer drains cells in order.
+ *
+ * Each cell carries a sequence number that tells producers and the consumer
+ * whose turn it is (Vyukov's bounded queue).
+ */
+
+#ifndef XMRIG_BRIDGE_RING_H
+#define XMRIG_BRIDGE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xmrig {
+
+
+template<typename T, size_t N>
+class MpscRing
+{
+public:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRing size must be a power of two");
+
+    MpscRing()
+    {
+        for (size_t i = 0; i < N; ++i) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    // fill(T &) writes the claimed cell; keep it short, the cell is not
+    // visible to the consumer until it returns.
+    template<typename F>
+    bool push(F &&fill)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Cell &cell          = m_cells[pos & (N - 1)];
+            const size_t seq    = cell.seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only.
+    template<typename F>
+    bool pop(F &&consume)
+    {
+        Cell &cell = m_cells[m_tail & (N - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+
+        consume(cell.value);
+        cell.seq.store(m_tail + N, std::memory_order_release);
+        ++m_tail;
+
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    Cell m_cells[N];
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) size_t m_tail = 0;
+};
+
+
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_RING_H */
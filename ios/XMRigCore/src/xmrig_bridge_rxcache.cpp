@@ -0,0 +1,319 @@
+#include "xmrig_bridge_rxcache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace xmrig {
+
+
+static constexpr uint32_t kMagic = 0x31435852; // "RXC1"
+static constexpr uint32_t kVersion = 1;
+static constexpr size_t kHeaderSize = 4096;     // keeps the payload page aligned for mmap
+static constexpr size_t kChunk = 4 * 1024 * 1024;
+static const char kSuffix[] = ".rxc";
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;          // payload bytes
+    uint64_t checksum;
+    uint32_t key_size;
+    uint32_t salt_size;
+    uint8_t key[RxCacheStore::kMaxKeySize];
+    uint8_t salt[RxCacheStore::kMaxSaltSize];
+};
+
+static_assert(sizeof(FileHeader) <= kHeaderSize, "FileHeader must fit the header block");
+
+
+// Four independent multiply-xor lanes so the loop runs at memory speed;
+// this only has to catch torn writes and bit rot, not tampering.
+class Checksum
+{
+public:
+    void update(const uint8_t *data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int lane = 0; lane < 4; ++lane) {
+                uint64_t word;
+                memcpy(&word, data + i + lane * 8, sizeof(word));
+                m_lanes[lane] = mix(m_lanes[lane] ^ word);
+            }
+        }
+        for (; i < size; ++i) {
+            m_lanes[0] = mix(m_lanes[0] ^ data[i]);
+        }
+        m_size += size;
+    }
+
+    uint64_t value() const
+    {
+        uint64_t h = m_size;
+        for (uint64_t lane : m_lanes) {
+            h = mix(h ^ lane);
+        }
+        return h;
+    }
+
+private:
+    static uint64_t mix(uint64_t h)
+    {
+        h *= 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 29);
+    }
+
+    uint64_t m_lanes[4] = { 1, 2, 3, 4 };
+    uint64_t m_size = 0;
+};
+
+
+static bool has_suffix(const char *name)
+{
+    const size_t length = strlen(name);
+    return length > sizeof(kSuffix) - 1 && strcmp(name + length - (sizeof(kSuffix) - 1), kSuffix) == 0;
+}
+
+
+static bool write_all(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+
+void RxCacheStore::setDirectory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+}
+
+
+void RxCacheStore::setBudget(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = bytes;
+}
+
+
+bool RxCacheStore::isEnabled()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_directory.empty() && m_budget > 0;
+}
+
+
+bool RxCacheStore::load(const void *key, size_t keySize, const void *salt, size_t saltSize, uint8_t *memory, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty() || m_budget == 0 || keySize > kMaxKeySize || saltSize > kMaxSaltSize) {
+        return false;
+    }
+
+    const std::string file = path(key, keySize, salt, saltSize);
+    const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    FileHeader header = {};
+    struct stat st = {};
+    bool valid = fstat(fd, &st) == 0 &&
+                 static_cast<uint64_t>(st.st_size) == kHeaderSize + size &&
+                 pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                 header.magic == kMagic && header.version == kVersion && header.size == size &&
+                 header.key_size == keySize && memcmp(header.key, key, keySize) == 0 &&
+                 header.salt_size == saltSize && memcmp(header.salt, salt, saltSize) == 0;
+
+    if (valid) {
+        void *map = mmap(nullptr, kHeaderSize + size, PROT_READ, MAP_PRIVATE, fd, 0);
+        valid = map != MAP_FAILED;
+
+        if (valid) {
+            madvise(map, kHeaderSize + size, MADV_SEQUENTIAL);
+
+            // Copy and verify in one pass, chunked so the check reads from cache
+            const uint8_t *payload = static_cast<const uint8_t *>(map) + kHeaderSize;
+            Checksum checksum;
+            for (size_t offset = 0; offset < size; offset += kChunk) {
+                const size_t length = std::min(kChunk, size - offset);
+                memcpy(memory + offset, payload + offset, length);
+                checksum.update(memory + offset, length);
+            }
+            munmap(map, kHeaderSize + size);
+
+            valid = checksum.value() == header.checksum;
+        }
+    }
+
+    if (valid) {
+        futimens(fd, nullptr); // most recently used
+    }
+    ::close(fd);
+
+    if (!valid) {
+        unlink(file.c_str());
+    }
+    return valid;
+}
+
+
+bool RxCacheStore::store(const void *key, size_t keySize, const void *salt, size_t saltSize, const uint8_t *memory, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty() || m_budget == 0 || keySize > kMaxKeySize || saltSize > kMaxSaltSize ||
+        kHeaderSize + size > m_budget) {
+        return false;
+    }
+
+    if (mkdir(m_directory.c_str(), 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+    evict(kHeaderSize + size);
+
+    const std::string file = path(key, keySize, salt, saltSize);
+    const std::string temp = file + ".tmp";
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    FileHeader header = {};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.size = size;
+    header.key_size = static_cast<uint32_t>(keySize);
+    header.salt_size = static_cast<uint32_t>(saltSize);
+    memcpy(header.key, key, keySize);
+    memcpy(header.salt, salt, saltSize);
+
+    // Payload first, the header with its checksum last
+    bool ok = lseek(fd, kHeaderSize, SEEK_SET) == static_cast<off_t>(kHeaderSize);
+    Checksum checksum;
+    for (size_t offset = 0; ok && offset < size; offset += kChunk) {
+        const size_t length = std::min(kChunk, size - offset);
+        checksum.update(memory + offset, length);
+        ok = write_all(fd, memory + offset, length);
+    }
+
+    if (ok) {
+        header.checksum = checksum.value();
+        std::vector<uint8_t> block(kHeaderSize, 0);
+        memcpy(block.data(), &header, sizeof(header));
+        ok = pwrite(fd, block.data(), block.size(), 0) == static_cast<ssize_t>(block.size());
+    }
+
+    ok = ::close(fd) == 0 && ok;
+    ok = ok && rename(temp.c_str(), file.c_str()) == 0;
+    if (!ok) {
+        unlink(temp.c_str());
+    }
+    return ok;
+}
+
+
+void RxCacheStore::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty()) {
+        return;
+    }
+
+    DIR *dir = opendir(m_directory.c_str());
+    if (!dir) {
+        return;
+    }
+
+    while (const dirent *entry = readdir(dir)) {
+        if (has_suffix(entry->d_name) || strstr(entry->d_name, ".rxc.tmp")) {
+            unlink((m_directory + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+}
+
+
+// <seed hex>-<salt hex>.rxc: the seed is a block hash already, the salt
+// tells rx/0 from rx/wow and friends
+std::string RxCacheStore::path(const void *key, size_t keySize, const void *salt, size_t saltSize) const
+{
+    std::string name = m_directory + "/";
+    char hex[3];
+
+    for (size_t i = 0; i < keySize; ++i) {
+        snprintf(hex, sizeof(hex), "%02x", static_cast<const uint8_t *>(key)[i]);
+        name += hex;
+    }
+    name += '-';
+    for (size_t i = 0; i < saltSize; ++i) {
+        snprintf(hex, sizeof(hex), "%02x", static_cast<const uint8_t *>(salt)[i]);
+        name += hex;
+    }
+
+    return name + kSuffix;
+}
+
+
+// Oldest files go first until `needed` more bytes fit the budget.
+// Leftover temporary files are from interrupted writes and always go.
+void RxCacheStore::evict(uint64_t needed)
+{
+    struct Entry {
+        std::string path;
+        time_t mtime;
+        uint64_t size;
+    };
+
+    DIR *dir = opendir(m_directory.c_str());
+    if (!dir) {
+        return;
+    }
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    while (const dirent *entry = readdir(dir)) {
+        const std::string file = m_directory + "/" + entry->d_name;
+        if (strstr(entry->d_name, ".rxc.tmp")) {
+            unlink(file.c_str());
+            continue;
+        }
+
+        struct stat st = {};
+        if (!has_suffix(entry->d_name) || stat(file.c_str(), &st) != 0) {
+            continue;
+        }
+
+        entries.push_back({ file, st.st_mtime, static_cast<uint64_t>(st.st_size) });
+        total += static_cast<uint64_t>(st.st_size);
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.mtime < b.mtime; });
+
+    for (const Entry &entry : entries) {
+        if (total + needed <= m_budget) {
+            break;
+        }
+        if (unlink(entry.path.c_str()) == 0) {
+            total -= entry.size;
+        }
+    }
+}
+
+
+} // namespace xmrig
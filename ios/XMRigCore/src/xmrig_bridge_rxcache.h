@@ -0,0 +1,77 @@
+/**
+ * XMRig Bridge - on-disk RandomX cache store
+ *
+ * Building the 256 MB RandomX cache is one Argon2d pass over the seed and
+ * takes seconds of full CPU on a phone, while the seed only changes every
+ * 2048 blocks. The store keeps initialised caches as files named by seed
+ * hash and hands them back on the next start, so restarts skip Argon2.
+ *
+ * File layout: a FileHeader padded to kHeaderSize, then the raw cache
+ * memory. The header carries the full key and Argon2 salt (the salt
+ * differs per RandomX variant) and a checksum of the payload; a file that
+ * fails any check is deleted and the cache is computed as usual.
+ *
+ * Files are written without fsync and renamed into place, so a crash can
+ * at worst leave a file the checksum rejects. Least recently used files
+ * (by mtime, refreshed on every load) are evicted to stay in the budget.
+ *
+ * Thread safe: XMRig initialises caches on its RandomX thread, the host
+ * configures the store from its own.
+ */
+
+#ifndef XMRIG_BRIDGE_RXCACHE_H
+#define XMRIG_BRIDGE_RXCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace xmrig {
+
+
+class RxCacheStore
+{
+public:
+    static constexpr size_t kMaxKeySize = 64;
+    static constexpr size_t kMaxSaltSize = 32;
+
+    /**
+     * Directory for the cache files, created on the first store.
+     * Empty disables the store, as does a budget of 0 bytes.
+     */
+    void setDirectory(const std::string &directory);
+    void setBudget(uint64_t bytes);
+    bool isEnabled();
+
+    /**
+     * Fills memory with the stored cache for key + salt.
+     * Returns false when there is none or it failed verification.
+     */
+    bool load(const void *key, size_t keySize, const void *salt, size_t saltSize, uint8_t *memory, size_t size);
+
+    /**
+     * Writes an initialised cache, evicting older files to make room.
+     * Returns false when the cache does not fit the budget or the write
+     * failed; the store is only an accelerator, so nothing else happens.
+     */
+    bool store(const void *key, size_t keySize, const void *salt, size_t saltSize, const uint8_t *memory, size_t size);
+
+    /**
+     * Deletes every cache file.
+     */
+    void clear();
+
+private:
+    std::string path(const void *key, size_t keySize, const void *salt, size_t saltSize) const;
+    void evict(uint64_t needed);
+
+    std::mutex m_mutex;
+    std::string m_directory;
+    uint64_t m_budget = 0;
+};
+
+
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_RXCACHE_H */
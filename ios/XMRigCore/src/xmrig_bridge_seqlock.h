@@ -0,0 +1,83 @@
+/**
+ * XMRig Bridge - single writer sequence lock
+ *
+ * Publishes a trivially copyable value from one writer thread (the libuv loop
+ * that owns the Controller) to any number of readers without a mutex. Readers
+ * retry while a write is in flight, writers never wait.
+ *
+ * The payload is stored as relaxed atomic words so concurrent reads are not a
+ * data race; ordering comes from the fences around the sequence counter.
+ */
+
+#ifndef XMRIG_BRIDGE_SEQLOCK_H
+#define XMRIG_BRIDGE_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace xmrig {
+
+
+template<typename T>
+class SeqLock
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+
+    SeqLock() { store(T{}); }
+
+    SeqLock(const SeqLock &) = delete;
+    SeqLock &operator=(const SeqLock &) = delete;
+
+    void store(const T &value)
+    {
+        uint64_t words[kWords] = {};
+        memcpy(words, &value, sizeof(T));
+
+        const uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < kWords; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        uint64_t words[kWords];
+        uint32_t before;
+        uint32_t after;
+
+        do {
+            before = m_seq.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        memcpy(&value, words, sizeof(T));
+
+        return value;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> m_seq{0};
+    std::atomic<uint64_t> m_words[kWords];
+};
+
+
+} // namespace xmrig
+
+#endif /* XMRIG_BRIDGE_SEQLOCK_H */
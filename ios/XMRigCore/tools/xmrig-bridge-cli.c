@@ -0,0 +1,221 @@
+/**
+ * xmrig-bridge-cli - minimal Linux host for the xmrig_bridge C API
+ *
+ * Drives the in-process core exactly like the mobile apps do: one config
+ * document, start, poll the stats snapshot, stop on Ctrl+C.
+ *
+ * Usage: xmrig-bridge-cli <config.json> [seconds]
+ *        xmrig-bridge-cli --bench <hashes> [threads] [fast|light]
+ *        xmrig-bridge-cli --history <storage dir> [10s|1m|1h]
+ *
+ * --bench runs the offline benchmark and exits non-zero when the hash sum
+ * does not match XMRig's reference, so CI machines need no pool access.
+ * --history prints the mining history kept under a storage path as CSV.
+ */
+
+#include "xmrig_bridge.h"
+
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t g_interrupted = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_interrupted = 1;
+}
+
+static void on_logs(const XMRigLogLine* lines, size_t count, void* context) {
+    (void)context;
+    for (size_t i = 0; i < count; ++i) {
+        printf("%s\n", lines[i].text);
+    }
+    fflush(stdout);
+}
+
+static char* read_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* data = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (data && fread(data, 1, (size_t)size, file) == (size_t)size) {
+        data[size] = '\0';
+    } else {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    return data;
+}
+
+static int run_benchmark(int argc, char** argv) {
+    XMRigBenchmarkOptions options = {0};
+    options.size = (uint32_t)strtoul(argv[2], NULL, 10);
+    options.threads = argc > 3 ? atoi(argv[3]) : 0;
+    options.affinity = -1;
+    options.mode = XMRIG_BENCHMARK_MODE_AUTO;
+    options.priority = -1;
+    if (argc > 4) {
+        options.mode = strcmp(argv[4], "light") == 0 ? XMRIG_BENCHMARK_MODE_LIGHT : XMRIG_BENCHMARK_MODE_FAST;
+    }
+
+    xmrig_set_log_batch_callback_v8(on_logs, NULL);
+
+    XMRigBenchmarkResult result;
+    const int rc = xmrig_benchmark_v8(&options, &result);
+    xmrig_cleanup_v8();
+
+    if (rc != 0) {
+        fprintf(stderr, "xmrig_benchmark_v8 failed: %d\n", rc);
+        return 1;
+    }
+
+    printf("[bench] %u hashes, %u threads: %.1f H/s in %" PRIu64 " ms\n",
+           result.size, result.threads, result.hashrate, result.duration_ms);
+    printf("[bench] init %" PRIu64 " ms, first hash %" PRIu64 " ms\n", result.init_ms, result.first_hash_ms);
+    if (result.power_w > 0) {
+        printf("[bench] %.2f W, %.2f H/J\n", result.power_w, result.hashes_per_joule);
+    }
+    for (uint32_t i = 0; i < result.threads && i < XMRIG_BENCHMARK_THREADS; ++i) {
+        printf("[bench] thread %u: %.1f H/s\n", i, result.thread_hashrate[i]);
+    }
+    printf("[bench] hash %016" PRIX64 " reference %016" PRIX64 " %s\n",
+           result.hash, result.reference, result.verified ? "OK" : "MISMATCH");
+
+    return result.verified ? 0 : 2;
+}
+
+static int dump_history(int argc, char** argv) {
+    int tier = XMRIG_HISTORY_10S;
+    if (argc > 3) {
+        tier = strcmp(argv[3], "1h") == 0 ? XMRIG_HISTORY_1H : strcmp(argv[3], "1m") == 0 ? XMRIG_HISTORY_1M : XMRIG_HISTORY_10S;
+    }
+
+    xmrig_set_storage_path_v8(argv[2]);
+
+    printf("timestamp_ms,samples,hashes,hashrate_10s,hashrate_60s,hashrate_15m,accepted,rejected,diff,soc_temp_c,battery_temp_c,cpu_usage,power_w,flags\n");
+
+    XMRigHistorySample samples[256];
+    uint64_t from = 0;
+    int count;
+    do {
+        count = xmrig_get_history_v8(tier, from, UINT64_MAX, samples, 256);
+        for (int i = 0; i < count; ++i) {
+            const XMRigHistorySample* s = &samples[i];
+            printf("%" PRIu64 ",%u,%" PRIu64 ",%.1f,%.1f,%.1f,%u,%u,%" PRIu64 ",%.1f,%.1f,%.1f,%.2f,%u\n",
+                   s->timestamp_ms, s->samples, s->hashes, s->hashrate_10s, s->hashrate_60s, s->hashrate_15m,
+                   s->accepted, s->rejected, s->diff, s->soc_temp_c, s->battery_temp_c, s->cpu_usage, s->power_w, s->flags);
+        }
+        if (count > 0) from = samples[count - 1].timestamp_ms + 1;
+    } while (count == 256);
+
+    xmrig_cleanup_v8();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+        return run_benchmark(argc, argv);
+    }
+    if (argc > 2 && strcmp(argv[1], "--history") == 0) {
+        return dump_history(argc, argv);
+    }
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <config.json> [seconds]\n", argv[0]);
+        fprintf(stderr, "       %s --bench <hashes> [threads] [fast|light]\n", argv[0]);
+        fprintf(stderr, "       %s --history <storage dir> [10s|1m|1h]\n", argv[0]);
+        return 1;
+    }
+
+    const int duration = argc > 2 ? atoi(argv[2]) : 0;
+    char* config = read_file(argv[1]);
+    if (!config) {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    xmrig_set_log_batch_callback_v8(on_logs, NULL);
+
+    int rc = xmrig_init_v8(config);
+    free(config);
+    if (rc != 0) {
+        fprintf(stderr, "xmrig_init_v8 failed: %d\n", rc);
+        return 1;
+    }
+
+    rc = xmrig_start_v8();
+    if (rc != 0) {
+        fprintf(stderr, "xmrig_start_v8 failed: %d\n", rc);
+        return 1;
+    }
+
+    for (int elapsed = 0; !g_interrupted && (duration == 0 || elapsed < duration); ++elapsed) {
+        sleep(1);
+        if (!xmrig_is_running_v8()) break;
+
+        XMRigStats stats;
+        xmrig_get_stats_v8(&stats);
+        printf("[cli] %.1f H/s (60s %.1f) threads %d hashes %llu shares %llu/%llu\n",
+               stats.hashrate_10s, stats.hashrate_60s, stats.threads,
+               (unsigned long long)stats.total_hashes,
+               (unsigned long long)stats.accepted_shares,
+               (unsigned long long)stats.rejected_shares);
+        if (stats.power_w > 0) {
+            printf("[cli] %.2f W, %.2f H/J (60s %.2f)\n", stats.power_w, stats.hashes_per_joule_10s, stats.hashes_per_joule_60s);
+        }
+
+        XMRigDonateStats donate;
+        xmrig_get_donate_stats_v8(&donate);
+        if (donate.rounds > 0) {
+            printf("[cli] donation rounds %u, switch in %llu ms / out %llu ms\n", donate.rounds,
+                   (unsigned long long)donate.switch_in_ms, (unsigned long long)donate.switch_out_ms);
+        }
+        if (donate.donated_hashes > 0) {
+            printf("[cli] donated %.2f%% of %llu hashes\n",
+                   100.0 * donate.donated_hashes / (donate.user_hashes + donate.donated_hashes),
+                   (unsigned long long)(donate.user_hashes + donate.donated_hashes));
+        }
+
+        XMRigJobSwitchStats jobs;
+        xmrig_get_job_switch_stats_v8(&jobs);
+        if (jobs.total.samples > 0) {
+            printf("[cli] job switch p50/p95/p99 %.1f/%.1f/%.1f ms over %llu jobs, stale shares %llu/%llu\n",
+                   jobs.total.p50_us / 1000.0, jobs.total.p95_us / 1000.0, jobs.total.p99_us / 1000.0,
+                   (unsigned long long)jobs.jobs, (unsigned long long)jobs.stale_shares, (unsigned long long)jobs.shares);
+        }
+        fflush(stdout);
+    }
+
+    xmrig_stop_v8();
+    while (xmrig_is_running_v8()) {
+        usleep(50 * 1000);
+    }
+
+    XMRigStartupReport startup;
+    xmrig_get_startup_report_v8(&startup);
+    printf("[cli] startup (ms since start):");
+    for (int phase = 0; phase < XMRIG_STARTUP_PHASES; ++phase) {
+        if (startup.phase_us[phase] > 0) {
+            printf(" %s %.1f", xmrig_startup_phase_name_v8(phase), startup.phase_us[phase] / 1000.0);
+        } else {
+            printf(" %s -", xmrig_startup_phase_name_v8(phase));
+        }
+    }
+    printf(", %u connect attempt(s)\n", startup.connect_attempts);
+
+    xmrig_cleanup_v8();
+    return 0;
+}
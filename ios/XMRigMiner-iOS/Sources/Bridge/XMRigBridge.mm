@@ -1,48 +1,59 @@
 #import <Foundation/Foundation.h>
 #include "xmrig_bridge.h"
 
-// Define the XMRigStats struct to match the header
-typedef struct {
-    double hashrate_10s;
-    double hashrate_60s;
-    double hashrate_15m;
-    uint64_t total_hashes;
-    uint64_t accepted_shares;
-    uint64_t rejected_shares;
-    bool is_mining;
-    int threads;
-} XMRigStatsData;
-
 // Objective-C Bridge Class
 @interface XMRigBridge : NSObject
 
 @property (nonatomic, copy, nullable) void (^logCallback)(NSString * _Nonnull);
+/// Called on the miner thread with each event batch; the array is only valid during the call
+@property (nonatomic, copy, nullable) void (^eventCallback)(const XMRigEvent * _Nonnull events, NSUInteger count);
 
 + (instancetype _Nonnull)shared;
 - (void)setStoragePath:(NSString * _Nonnull)path;
 - (BOOL)initializeWithConfig:(NSString * _Nonnull)jsonConfig;
 - (BOOL)startMining;
 - (void)stopMining;
+- (BOOL)pauseMining;
+- (BOOL)resumeMining;
 - (BOOL)isRunning;
 - (NSDictionary * _Nonnull)getStats;
+/// Startup timeline: phase name to ms since start, for the phases reached so far
+- (NSDictionary * _Nonnull)getStartupReport;
 - (double)getCurrentHashrate;
 - (void)setThreads:(int)count;
 - (NSString * _Nonnull)getVersion;
 - (void)cleanup;
-- (void)updateStatsFromLogLine:(NSString * _Nonnull)line;
 
 @end
 
-// C callback for logs
-static void on_xmrig_log(const char* line) {
-    if (line == NULL) return;
-    
-    NSString *logLine = [NSString stringWithUTF8String:line];
-    if (logLine) {
-        // Dispatch to main thread for UI/stat updates
-        dispatch_async(dispatch_get_main_queue(), ^{
-            [[XMRigBridge shared] updateStatsFromLogLine:logLine];
-        });
+// C callback for log batches
+static void on_xmrig_logs(const XMRigLogLine* lines, size_t count, void* context) {
+    NSMutableArray<NSString *> *logLines = [NSMutableArray arrayWithCapacity:count];
+    for (size_t i = 0; i < count; ++i) {
+        NSString *logLine = [[NSString alloc] initWithBytes:lines[i].text length:lines[i].length encoding:NSUTF8StringEncoding];
+        if (logLine) {
+            [logLines addObject:logLine];
+        }
+    }
+    if (logLines.count == 0) return;
+
+    // Stats come from xmrig_get_stats_v8, lines are only for display
+    XMRigBridge *bridge = (__bridge XMRigBridge *)context;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        void (^callback)(NSString *) = bridge.logCallback;
+        if (!callback) return;
+        for (NSString *logLine in logLines) {
+            callback(logLine);
+        }
+    });
+}
+
+// C callback for event batches
+static void on_xmrig_events(const XMRigEvent* events, size_t count, void* context) {
+    XMRigBridge *bridge = (__bridge XMRigBridge *)context;
+    void (^callback)(const XMRigEvent *, NSUInteger) = bridge.eventCallback;
+    if (callback) {
+        callback(events, count);
     }
 }
 
@@ -54,8 +65,9 @@ static void on_xmrig_log(const char* line) {
     dispatch_once(&onceToken, ^{
         instance = [[XMRigBridge alloc] init];
         
-        // Register the log callback as soon as shared instance is created
-        xmrig_set_log_callback_v8(on_xmrig_log);
+        // Register the callbacks as soon as shared instance is created
+        xmrig_set_log_batch_callback_v8(on_xmrig_logs, (__bridge void *)instance);
+        xmrig_set_event_callback_v8(on_xmrig_events, (__bridge void *)instance, 0);
     });
     return instance;
 }
@@ -94,13 +106,25 @@ static void on_xmrig_log(const char* line) {
     xmrig_stop_v8();
 }
 
+- (BOOL)pauseMining {
+    return xmrig_pause_v8() == 0;
+}
+
+- (BOOL)resumeMining {
+    return xmrig_resume_v8() == 0;
+}
+
 - (BOOL)isRunning {
     return xmrig_is_running_v8();
 }
 
 - (NSDictionary *)getStats {
-    XMRigStatsData stats;
-    xmrig_get_stats_v8((XMRigStats*)&stats);
+    XMRigStats stats;
+    xmrig_get_stats_v8(&stats);
+    XMRigPauseStats pause;
+    xmrig_get_pause_stats_v8(&pause);
+    XMRigJobSwitchStats jobs;
+    xmrig_get_job_switch_stats_v8(&jobs);
     
     return @{
         @"hashrate_10s": @(stats.hashrate_10s),
@@ -110,7 +134,35 @@ static void on_xmrig_log(const char* line) {
         @"accepted_shares": @(stats.accepted_shares),
         @"rejected_shares": @(stats.rejected_shares),
         @"is_mining": @(stats.is_mining),
-        @"threads": @(stats.threads)
+        @"threads": @(stats.threads),
+        @"is_paused": @(pause.paused),
+        @"pause_latency_us": @(pause.pause_latency_us),
+        @"resume_latency_us": @(pause.resume_latency_us),
+        @"job_switch_p50_us": @(jobs.total.p50_us),
+        @"job_switch_p95_us": @(jobs.total.p95_us),
+        @"job_switch_p99_us": @(jobs.total.p99_us),
+        @"first_hash_p95_us": @(jobs.first_hash.p95_us),
+        @"stale_shares": @(jobs.stale_shares)
+    };
+}
+
+- (NSDictionary *)getStartupReport {
+    XMRigStartupReport report;
+    xmrig_get_startup_report_v8(&report);
+
+    NSMutableDictionary *phases = [NSMutableDictionary dictionaryWithCapacity:XMRIG_STARTUP_PHASES];
+    for (int phase = 0; phase < XMRIG_STARTUP_PHASES; ++phase) {
+        if (report.phase_us[phase] > 0) {
+            phases[@(xmrig_startup_phase_name_v8(phase))] = @(report.phase_us[phase] / 1000.0);
+        }
+    }
+
+    return @{
+        @"phases_ms": phases,
+        @"connect_attempts": @(report.connect_attempts),
+        @"threads": @(report.threads),
+        @"tls": @(report.tls),
+        @"rx_cache_from_disk": @(report.rx_cache_from_disk)
     };
 }
 
@@ -131,61 +183,4 @@ static void on_xmrig_log(const char* line) {
     xmrig_cleanup_v8();
 }
 
-// Parse XMRig log line and update stats
-- (void)updateStatsFromLogLine:(NSString *)line {
-    // Forward to callback first to show in UI
-    if (self.logCallback) {
-        self.logCallback(line);
-    }
-
-    // Parse hashrate line: "speed 10s/60s/15m 150.0 140.0 130.0 H/s"
-    NSRegularExpression *hashrateRegex = [NSRegularExpression 
-        regularExpressionWithPattern:@"speed\\s+\\S+\\s+([\\d.]+)\\s+([\\d.]+)\\s+([\\d.]+)"
-        options:0 
-        error:nil];
-    
-    NSTextCheckingResult *hashrateMatch = [hashrateRegex 
-        firstMatchInString:line 
-        options:0 
-        range:NSMakeRange(0, line.length)];
-    
-    if (hashrateMatch && hashrateMatch.numberOfRanges >= 4) {
-        double hr10s = [[line substringWithRange:[hashrateMatch rangeAtIndex:1]] doubleValue];
-        double hr60s = [[line substringWithRange:[hashrateMatch rangeAtIndex:2]] doubleValue];
-        double hr15m = [[line substringWithRange:[hashrateMatch rangeAtIndex:3]] doubleValue];
-        
-        NSDictionary *currentStats = [self getStats];
-        uint64_t accepted = [currentStats[@"accepted_shares"] unsignedLongLongValue];
-        uint64_t rejected = [currentStats[@"rejected_shares"] unsignedLongLongValue];
-        int threads = [currentStats[@"threads"] intValue];
-        
-        xmrig_update_stats_v8(hr10s, hr60s, hr15m, accepted, rejected, threads);
-        return;
-    }
-    
-    // Parse accepted share line: "accepted (1/0)"
-    NSRegularExpression *acceptedRegex = [NSRegularExpression 
-        regularExpressionWithPattern:@"accepted\\s+\\((\\d+)/(\\d+)\\)"
-        options:0 
-        error:nil];
-    
-    NSTextCheckingResult *acceptedMatch = [acceptedRegex 
-        firstMatchInString:line 
-        options:0 
-        range:NSMakeRange(0, line.length)];
-    
-    if (acceptedMatch && acceptedMatch.numberOfRanges >= 3) {
-        uint64_t accepted = [[line substringWithRange:[acceptedMatch rangeAtIndex:1]] longLongValue];
-        uint64_t rejected = [[line substringWithRange:[acceptedMatch rangeAtIndex:2]] longLongValue];
-        
-        NSDictionary *currentStats = [self getStats];
-        double hr10s = [currentStats[@"hashrate_10s"] doubleValue];
-        double hr60s = [currentStats[@"hashrate_60s"] doubleValue];
-        double hr15m = [currentStats[@"hashrate_15m"] doubleValue];
-        int threads = [currentStats[@"threads"] intValue];
-        
-        xmrig_update_stats_v8(hr10s, hr60s, hr15m, accepted, rejected, threads);
-    }
-}
-
 @end
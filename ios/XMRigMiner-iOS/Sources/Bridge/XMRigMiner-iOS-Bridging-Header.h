@@ -15,19 +15,24 @@
 @interface XMRigBridge : NSObject
 
 @property (nonatomic, copy, nullable) void (^logCallback)(NSString * _Nonnull);
+/// Called on the miner thread with each event batch; the array is only valid during the call
+@property (nonatomic, copy, nullable) void (^eventCallback)(const XMRigEvent * _Nonnull events, NSUInteger count);
 
 + (instancetype _Nonnull)shared;
 - (void)setStoragePath:(NSString * _Nonnull)path;
 - (BOOL)initializeWithConfig:(NSString * _Nonnull)jsonConfig;
 - (BOOL)startMining;
 - (void)stopMining;
+- (BOOL)pauseMining;
+- (BOOL)resumeMining;
 - (BOOL)isRunning;
 - (NSDictionary * _Nonnull)getStats;
+/// Startup timeline: phase name to ms since start, for the phases reached so far
+- (NSDictionary * _Nonnull)getStartupReport;
 - (double)getCurrentHashrate;
 - (void)setThreads:(int)count;
 - (NSString * _Nonnull)getVersion;
 - (void)cleanup;
-- (void)updateStatsFromLogLine:(NSString * _Nonnull)line;
 
 @end
 
@@ -19,6 +19,9 @@ struct MiningStats: Equatable {
     var rejectedShares: UInt64 = 0
     var isMining: Bool = false
     var threads: Int = 0
+    var isPaused: Bool = false
+    var pauseLatencyUs: UInt64 = 0
+    var resumeLatencyUs: UInt64 = 0
 }
 
 /// Swift wrapper for XMRig native library
@@ -50,6 +53,7 @@ class XMRigWrapper: ObservableObject {
         }
         
         setupLogCallback()
+        setupEventCallback()
         
         // Write a test file immediately to verify devicectl access
         if let docs = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first {
@@ -99,6 +103,7 @@ class XMRigWrapper: ObservableObject {
             
             if startResult {
                 self.isRunning = true
+                self.startStatsTimer()
             }
         }
     }
@@ -125,6 +130,18 @@ class XMRigWrapper: ObservableObject {
         stopStatsTimer()
     }
     
+    /// Pause mining, keeping the RandomX dataset and pool session warm
+    func pause() {
+        guard bridge.pauseMining() else { return }
+        updateStats()
+    }
+    
+    /// Resume mining after pause()
+    func resume() {
+        guard bridge.resumeMining() else { return }
+        updateStats()
+    }
+    
     /// Set number of mining threads
     func setThreads(_ count: Int) {
         bridge.setThreads(Int32(count))
@@ -159,6 +176,29 @@ class XMRigWrapper: ObservableObject {
         }
     }
     
+    private func setupEventCallback() {
+        bridge.eventCallback = { [weak self] events, count in
+            // One main-actor hop per batch, only when something user-visible changed
+            let batch = UnsafeBufferPointer(start: events, count: Int(count))
+            let relevant = batch.contains { event in
+                switch event.type {
+                case XMRIG_EVENT_SHARE_ACCEPTED.rawValue,
+                     XMRIG_EVENT_SHARE_REJECTED.rawValue,
+                     XMRIG_EVENT_HASHRATE.rawValue,
+                     XMRIG_EVENT_POOL_DISCONNECTED.rawValue:
+                    return true
+                default:
+                    return false
+                }
+            }
+            guard relevant else { return }
+
+            Task { @MainActor in
+                self?.updateStats()
+            }
+        }
+    }
+    
     private func handleLogLine(_ line: String) {
         // Add to logs (keep limited)
         logs.append(line)
@@ -168,9 +208,6 @@ class XMRigWrapper: ObservableObject {
         
         // Export logs immediately for evidence capture
         exportLogs()
-        
-        // Parse the line for stats
-        bridge.updateStats(fromLogLine: line)
     }
     
     private func startStatsTimer() {
@@ -253,7 +290,10 @@ class XMRigWrapper: ObservableObject {
             acceptedShares: statsDict["accepted_shares"] as? UInt64 ?? 0,
             rejectedShares: statsDict["rejected_shares"] as? UInt64 ?? 0,
             isMining: statsDict["is_mining"] as? Bool ?? false,
-            threads: statsDict["threads"] as? Int ?? 0
+            threads: statsDict["threads"] as? Int ?? 0,
+            isPaused: statsDict["is_paused"] as? Bool ?? false,
+            pauseLatencyUs: statsDict["pause_latency_us"] as? UInt64 ?? 0,
+            resumeLatencyUs: statsDict["resume_latency_us"] as? UInt64 ?? 0
         )
         
         // Only update if changed to reduce UI updates
@@ -0,0 +1,291 @@
+#include "Json.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace xmrig {
+namespace proxy {
+
+
+class Json::Parser
+{
+public:
+    Parser(const char *data, size_t size) : m_pos(data), m_end(data + size) {}
+
+    bool document(Json &out)
+    {
+        return value(out, 0) && (skip(), m_pos == m_end);
+    }
+
+private:
+    void skip()
+    {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\r' || *m_pos == '\n')) {
+            ++m_pos;
+        }
+    }
+
+    bool literal(const char *word)
+    {
+        const size_t length = strlen(word);
+        if (static_cast<size_t>(m_end - m_pos) < length || memcmp(m_pos, word, length) != 0) {
+            return false;
+        }
+
+        m_pos += length;
+        return true;
+    }
+
+    bool value(Json &out, int depth)
+    {
+        skip();
+        if (m_pos == m_end || depth > kMaxDepth) {
+            return false;
+        }
+
+        switch (*m_pos) {
+        case '{':
+            return object(out, depth);
+
+        case '[':
+            return array(out, depth);
+
+        case '"':
+            out.m_type = STRING;
+            return string(out.m_text);
+
+        case 't':
+            out.m_type = BOOL;
+            out.m_bool = true;
+            return literal("true");
+
+        case 'f':
+            out.m_type = BOOL;
+            return literal("false");
+
+        case 'n':
+            out.m_type = NUL;
+            return literal("null");
+
+        default:
+            return number(out);
+        }
+    }
+
+    bool number(Json &out)
+    {
+        const char *start = m_pos;
+        while (m_pos < m_end && (strchr("+-.eE", *m_pos) || (*m_pos >= '0' && *m_pos <= '9'))) {
+            ++m_pos;
+        }
+
+        if (m_pos == start) {
+            return false;
+        }
+
+        out.m_type = NUMBER;
+        out.m_text.assign(start, m_pos);
+        return true;
+    }
+
+    bool string(std::string &out)
+    {
+        ++m_pos;
+        while (m_pos < m_end && *m_pos != '"') {
+            if (*m_pos != '\\') {
+                out += *m_pos++;
+                continue;
+            }
+
+            if (++m_pos == m_end) {
+                return false;
+            }
+
+            const char c = *m_pos++;
+            switch (c) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+
+            case 'u':
+                // Stratum strings are ASCII; anything else is kept as '?'
+                if (m_end - m_pos < 4) {
+                    return false;
+                }
+                m_pos += 4;
+                out += '?';
+                break;
+
+            default:
+                out += c;
+                break;
+            }
+        }
+
+        if (m_pos == m_end) {
+            return false;
+        }
+
+        ++m_pos;
+        return true;
+    }
+
+    bool array(Json &out, int depth)
+    {
+        out.m_type = ARRAY;
+        ++m_pos;
+        skip();
+
+        if (m_pos < m_end && *m_pos == ']') {
+            ++m_pos;
+            return true;
+        }
+
+        while (true) {
+            out.m_items.emplace_back();
+            if (!value(out.m_items.back(), depth + 1)) {
+                return false;
+            }
+
+            skip();
+            if (m_pos < m_end && *m_pos == ',') {
+                ++m_pos;
+                continue;
+            }
+            if (m_pos < m_end && *m_pos == ']') {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    bool object(Json &out, int depth)
+    {
+        out.m_type = OBJECT;
+        ++m_pos;
+        skip();
+
+        if (m_pos < m_end && *m_pos == '}') {
+            ++m_pos;
+            return true;
+        }
+
+        while (true) {
+            skip();
+            out.m_keys.emplace_back();
+            if (m_pos == m_end || *m_pos != '"' || !string(out.m_keys.back())) {
+                return false;
+            }
+
+            skip();
+            if (m_pos == m_end || *m_pos++ != ':') {
+                return false;
+            }
+
+            out.m_items.emplace_back();
+            if (!value(out.m_items.back(), depth + 1)) {
+                return false;
+            }
+
+            skip();
+            if (m_pos < m_end && *m_pos == ',') {
+                ++m_pos;
+                continue;
+            }
+            if (m_pos < m_end && *m_pos == '}') {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+    }
+
+    const char *m_pos;
+    const char *m_end;
+};
+
+
+bool Json::parse(const char *data, size_t size, Json &out)
+{
+    out = Json();
+    return Parser(data, size).document(out);
+}
+
+
+const Json *Json::get(const char *key) const
+{
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        if (m_keys[i] == key) {
+            return &m_items[i];
+        }
+    }
+
+    return nullptr;
+}
+
+
+std::string Json::string(const char *key) const
+{
+    const Json *value = get(key);
+    return value && value->isString() ? value->m_text : std::string();
+}
+
+
+uint64_t Json::uint(const char *key) const
+{
+    const Json *value = get(key);
+    if (!value || value->m_type != NUMBER || value->m_text.empty() || value->m_text[0] == '-') {
+        return 0;
+    }
+
+    return strtoull(value->m_text.c_str(), nullptr, 10);
+}
+
+
+std::string Json::raw() const
+{
+    if (m_type == NUMBER) {
+        return m_text;
+    }
+
+    std::string out;
+    if (m_type == STRING) {
+        appendString(out, m_text);
+    }
+    else {
+        out = "null";
+    }
+
+    return out;
+}
+
+
+void appendString(std::string &out, const std::string &text)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    out += '"';
+    for (const char c : text) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (u < 0x20) {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 0xf];
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+
+} // namespace proxy
+} // namespace xmrig
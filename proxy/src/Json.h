@@ -0,0 +1,73 @@
+/**
+ * LAN proxy - minimal JSON reader and writer helpers
+ *
+ * Stratum lines are small flat objects, so this is a plain recursive
+ * descent parser into a tree of Json values. Numbers keep their source
+ * text, which is what gets echoed back for request ids.
+ */
+
+#ifndef XMRIG_PROXY_JSON_H
+#define XMRIG_PROXY_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xmrig {
+namespace proxy {
+
+
+class Json
+{
+public:
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    /**
+     * Parses one complete value. Returns false on malformed input, trailing
+     * garbage or nesting deeper than kMaxDepth.
+     */
+    static bool parse(const char *data, size_t size, Json &out);
+
+    inline Type type() const                { return m_type; }
+    inline bool isNull() const              { return m_type == NUL; }
+    inline bool isObject() const            { return m_type == OBJECT; }
+    inline bool isString() const            { return m_type == STRING; }
+    inline bool isTrue() const              { return m_type == BOOL && m_bool; }
+    inline const std::string &text() const  { return m_text; }  // string contents or number source
+    inline const std::vector<Json> &items() const { return m_items; }
+
+    const Json *get(const char *key) const;
+    std::string string(const char *key) const;  // empty unless a string member
+    uint64_t uint(const char *key) const;       // 0 unless a non-negative integer member
+
+    /**
+     * The value as JSON text, for echoing ids: numbers verbatim, strings
+     * re-quoted, anything else null.
+     */
+    std::string raw() const;
+
+private:
+    static constexpr int kMaxDepth = 16;
+
+    class Parser;
+
+    Type m_type = NUL;
+    bool m_bool = false;
+    std::string m_text;
+    std::vector<Json> m_items;                          // array items, object values
+    std::vector<std::string> m_keys;                    // object keys, same order
+};
+
+
+/**
+ * Appends `text` as a quoted JSON string.
+ */
+void appendString(std::string &out, const std::string &text);
+
+
+} // namespace proxy
+} // namespace xmrig
+
+#endif /* XMRIG_PROXY_JSON_H */
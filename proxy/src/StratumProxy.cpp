@@ -0,0 +1,806 @@
+#include "StratumProxy.h"
+#include "Json.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+
+namespace xmrig {
+namespace proxy {
+
+
+static constexpr size_t kNonceOffset    = 39;   // nonce bytes in a CryptoNote hashing blob
+static constexpr size_t kSlotByte       = kNonceOffset + 3;
+static constexpr size_t kJobs           = 4;
+static constexpr uint64_t kSweepMs      = 5000;
+static constexpr size_t kMaxUpstreamLine = 256 * 1024;
+
+static const char kNotifyPrefix[] = "{\"jsonrpc\":\"2.0\",\"method\":\"job\",\"params\":";
+static const char kBlobPrefix[]   = "{\"blob\":\"";
+
+
+struct StratumProxy::Job
+{
+    uint64_t seq;
+    uint64_t session;
+    uint64_t target;
+    std::string upstreamId;
+    std::string json;           // job object for login replies, slot byte at slotPos
+    std::string notify;         // complete job notification line, slot byte at notifySlot
+    size_t slotPos;
+    size_t notifySlot;
+    std::unordered_set<uint32_t> nonces;
+};
+
+
+struct StratumProxy::Miner
+{
+    uv_tcp_t tcp;
+    StratumProxy *proxy;
+    uint64_t id;
+    uint64_t connectedAt;
+    int slot        = -1;
+    bool closing    = false;
+    std::string pendingLogin;   // login request id while there is no job to hand out
+    std::string rx;
+};
+
+
+struct StratumProxy::Upstream
+{
+    uv_tcp_t tcp;
+    uv_connect_t connect;
+    StratumProxy *proxy;
+    uint64_t lastSend = 0;
+    std::string rx;
+};
+
+
+struct Write
+{
+    uv_write_t req;
+    std::string data;
+};
+
+
+static void log(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    fputs("[proxy] ", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+
+static int unhex(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+
+static bool decode(const std::string &hex, uint8_t *out, size_t size)
+{
+    if (hex.size() != size * 2) {
+        return false;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        const int hi = unhex(hex[i * 2]);
+        const int lo = unhex(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>(hi << 4 | lo);
+    }
+
+    return true;
+}
+
+
+static uint64_t le64(const uint8_t *data, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; --i) {
+        value = value << 8 | data[i - 1];
+    }
+
+    return value;
+}
+
+
+// Same conversion as XMRig's Job::setTarget(): 4-byte targets are a
+// compact difficulty, 8-byte targets are used as they are
+static uint64_t toTarget(const std::string &hex)
+{
+    uint8_t raw[8] = {};
+    if (decode(hex, raw, 4)) {
+        const uint64_t compact = le64(raw, 4);
+        return compact ? 0xFFFFFFFFFFFFFFFFULL / (0xFFFFFFFFULL / compact) : 0;
+    }
+
+    return decode(hex, raw, 8) ? le64(raw, 8) : 0;
+}
+
+
+static void patchSlot(std::string &text, size_t pos, int slot)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    text[pos]     = hex[(slot >> 4) & 0xf];
+    text[pos + 1] = hex[slot & 0xf];
+}
+
+
+StratumProxy::StratumProxy(uv_loop_t *loop, const Options &options) :
+    m_options(options),
+    m_loop(loop)
+{
+    uv_tcp_init(m_loop, &m_server);
+    uv_timer_init(m_loop, &m_retry);
+    uv_timer_init(m_loop, &m_sweep);
+    m_server.data = this;
+    m_retry.data  = this;
+    m_sweep.data  = this;
+
+    for (size_t slot = kSlots; slot > 0; --slot) {
+        m_freeSlots.push_back(static_cast<uint16_t>(slot - 1));
+    }
+}
+
+
+StratumProxy::~StratumProxy()
+{
+    for (Job *job : m_jobs) {
+        delete job;
+    }
+}
+
+
+int StratumProxy::start()
+{
+    sockaddr_storage addr = {};
+    int rc = uv_ip4_addr(m_options.bindHost.c_str(), m_options.bindPort, reinterpret_cast<sockaddr_in *>(&addr));
+    if (rc != 0) {
+        rc = uv_ip6_addr(m_options.bindHost.c_str(), m_options.bindPort, reinterpret_cast<sockaddr_in6 *>(&addr));
+    }
+
+    if (rc == 0) {
+        rc = uv_tcp_bind(&m_server, reinterpret_cast<const sockaddr *>(&addr), 0);
+    }
+    if (rc == 0) {
+        rc = uv_listen(reinterpret_cast<uv_stream_t *>(&m_server), 1024, onConnection);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    sockaddr_storage bound = {};
+    int length = sizeof(bound);
+    uv_tcp_getsockname(&m_server, reinterpret_cast<sockaddr *>(&bound), &length);
+    m_port = ntohs(bound.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6 *>(&bound)->sin6_port
+                                               : reinterpret_cast<sockaddr_in *>(&bound)->sin_port);
+
+    uv_timer_start(&m_sweep, onSweep, kSweepMs, kSweepMs);
+    connectUpstream();
+
+    return 0;
+}
+
+
+void StratumProxy::stop()
+{
+    if (m_stopped) {
+        return;
+    }
+    m_stopped = true;
+
+    uv_close(reinterpret_cast<uv_handle_t *>(&m_server), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t *>(&m_retry), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t *>(&m_sweep), nullptr);
+
+    std::vector<Miner *> miners;
+    miners.reserve(m_miners.size());
+    for (const auto &entry : m_miners) {
+        miners.push_back(entry.second);
+    }
+    for (Miner *miner : miners) {
+        close(miner);
+    }
+
+    closeUpstream();
+}
+
+
+void StratumProxy::onConnection(uv_stream_t *server, int status)
+{
+    auto proxy = static_cast<StratumProxy *>(server->data);
+    if (status < 0) {
+        return;
+    }
+
+    auto miner   = new Miner();
+    miner->proxy = proxy;
+    miner->tcp.data = miner;
+    uv_tcp_init(proxy->m_loop, &miner->tcp);
+
+    if (uv_accept(server, reinterpret_cast<uv_stream_t *>(&miner->tcp)) != 0) {
+        uv_close(reinterpret_cast<uv_handle_t *>(&miner->tcp), [](uv_handle_t *handle) { delete static_cast<Miner *>(handle->data); });
+        return;
+    }
+
+    uv_tcp_nodelay(&miner->tcp, 1);
+    miner->id          = proxy->m_nextMiner++;
+    miner->connectedAt = uv_now(proxy->m_loop);
+    proxy->m_miners.emplace(miner->id, miner);
+    ++proxy->m_stats.connections;
+
+    uv_read_start(reinterpret_cast<uv_stream_t *>(&miner->tcp), onAlloc, onMinerRead);
+}
+
+
+// One loop, one read at a time: every stream reads into the same buffer
+// and consumes it before returning
+void StratumProxy::onAlloc(uv_handle_t *, size_t, uv_buf_t *buf)
+{
+    static thread_local char buffer[64 * 1024];
+
+    buf->base = buffer;
+    buf->len  = sizeof(buffer);
+}
+
+
+void StratumProxy::onMinerRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf)
+{
+    auto miner = static_cast<Miner *>(stream->data);
+    auto proxy = miner->proxy;
+
+    if (nread < 0) {
+        return proxy->close(miner);
+    }
+
+    miner->rx.append(buf->base, static_cast<size_t>(nread));
+
+    size_t start = 0;
+    size_t end;
+    while (!miner->closing && (end = miner->rx.find('\n', start)) != std::string::npos) {
+        proxy->onMinerLine(miner, miner->rx.data() + start, end - start);
+        start = end + 1;
+    }
+
+    if (miner->closing) {
+        return;
+    }
+
+    miner->rx.erase(0, start);
+    if (miner->rx.size() > proxy->m_options.maxLine) {
+        proxy->close(miner);
+    }
+}
+
+
+void StratumProxy::close(Miner *miner)
+{
+    if (miner->closing) {
+        return;
+    }
+
+    miner->closing = true;
+    m_miners.erase(miner->id);
+    --m_stats.connections;
+
+    if (miner->slot >= 0) {
+        m_freeSlots.push_back(static_cast<uint16_t>(miner->slot));
+        --m_stats.miners;
+    }
+
+    uv_close(reinterpret_cast<uv_handle_t *>(&miner->tcp), [](uv_handle_t *handle) { delete static_cast<Miner *>(handle->data); });
+}
+
+
+void StratumProxy::onMinerLine(Miner *miner, const char *line, size_t size)
+{
+    if (size == 0 || (size == 1 && line[0] == '\r')) {
+        return;
+    }
+
+    Json doc;
+    if (!Json::parse(line, size, doc) || !doc.isObject()) {
+        return close(miner);
+    }
+
+    const std::string method = doc.string("method");
+    const Json *value        = doc.get("id");
+    const std::string id     = value ? value->raw() : "null";
+    const Json *params       = doc.get("params");
+
+    if (method == "login") {
+        return login(miner, id);
+    }
+
+    if (method == "submit" && params && params->isObject()) {
+        return submit(miner, id, *params);
+    }
+
+    if (method == "keepalived") {
+        return send(reinterpret_cast<uv_stream_t *>(&miner->tcp),
+                    "{\"id\":" + id + ",\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"status\":\"KEEPALIVED\"}}\n");
+    }
+
+    replyError(miner, id, "Unsupported method");
+}
+
+
+void StratumProxy::login(Miner *miner, const std::string &id)
+{
+    if (miner->slot < 0) {
+        if (m_freeSlots.empty()) {
+            ++m_stats.invalid;
+            return replyError(miner, id, "Proxy is full");
+        }
+
+        miner->slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        ++m_stats.miners;
+    }
+
+    // No job since the proxy started: answer with the first one
+    if (m_jobs.empty()) {
+        miner->pendingLogin = id;
+        return;
+    }
+
+    loginReply(miner, id, *m_jobs.back());
+}
+
+
+void StratumProxy::loginReply(Miner *miner, const std::string &id, const Job &job)
+{
+    std::string json = job.json;
+    patchSlot(json, job.slotPos, miner->slot);
+
+    send(reinterpret_cast<uv_stream_t *>(&miner->tcp),
+         "{\"id\":" + id + ",\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"id\":\"" + std::to_string(miner->id) +
+         "\",\"job\":" + json + ",\"extensions\":[\"algo\",\"nicehash\",\"keepalive\"],\"status\":\"OK\"}}\n");
+}
+
+
+void StratumProxy::submit(Miner *miner, const std::string &id, const Json &params)
+{
+    if (miner->slot < 0) {
+        ++m_stats.invalid;
+        return replyError(miner, id, "Unauthenticated");
+    }
+
+    const std::string jobId  = params.string("job_id");
+    const std::string nonce  = params.string("nonce");
+    const std::string result = params.string("result");
+
+    Job *job = findJob(strtoull(jobId.c_str(), nullptr, 10));
+    uint8_t nonceBytes[4];
+    uint8_t hash[32];
+    const char *error = nullptr;
+
+    if (!job || job->session != m_session || !isUpstreamReady()) {
+        error = "Block expired";
+    }
+    else if (!decode(nonce, nonceBytes, sizeof(nonceBytes)) || nonceBytes[3] != miner->slot) {
+        error = "Invalid nonce";
+    }
+    else if (!decode(result, hash, sizeof(hash))) {
+        error = "Invalid result";
+    }
+    else if (!job->nonces.insert(static_cast<uint32_t>(le64(nonceBytes, 4))).second) {
+        error = "Duplicate share";
+    }
+    else if (le64(hash + 24, 8) >= job->target) {
+        error = "Low difficulty share";
+    }
+
+    if (error) {
+        ++m_stats.invalid;
+        return replyError(miner, id, error);
+    }
+
+    std::string forward = "{\"id\":";
+    appendString(forward, m_sessionId);
+    forward += ",\"job_id\":";
+    appendString(forward, job->upstreamId);
+    forward += ",\"nonce\":\"" + nonce + "\",\"result\":\"" + result + "\"";
+
+    const std::string algo = params.string("algo");
+    if (!algo.empty()) {
+        forward += ",\"algo\":";
+        appendString(forward, algo);
+    }
+    forward += "}";
+
+    m_pending[sendUpstream("submit", forward)] = { miner->id, id };
+}
+
+
+void StratumProxy::replyError(Miner *miner, const std::string &id, const char *message)
+{
+    std::string reply = "{\"id\":" + id + ",\"jsonrpc\":\"2.0\",\"error\":{\"code\":-1,\"message\":";
+    appendString(reply, message);
+    reply += "}}\n";
+
+    send(reinterpret_cast<uv_stream_t *>(&miner->tcp), std::move(reply));
+}
+
+
+void StratumProxy::send(uv_stream_t *stream, std::string &&data)
+{
+    auto write  = new Write();
+    write->data = std::move(data);
+
+    uv_buf_t buf = uv_buf_init(&write->data[0], static_cast<unsigned int>(write->data.size()));
+    if (uv_write(&write->req, stream, &buf, 1, [](uv_write_t *req, int) { delete reinterpret_cast<Write *>(req); }) != 0) {
+        delete write;
+    }
+}
+
+
+void StratumProxy::sendJob(Miner *miner, const Job &job)
+{
+    std::string notify = job.notify;
+    patchSlot(notify, job.notifySlot, miner->slot);
+
+    send(reinterpret_cast<uv_stream_t *>(&miner->tcp), std::move(notify));
+}
+
+
+void StratumProxy::connectUpstream()
+{
+    if (m_stopped) {
+        return;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    auto req  = new uv_getaddrinfo_t();
+    req->data = this;
+
+    const std::string port = std::to_string(m_options.poolPort);
+    if (uv_getaddrinfo(m_loop, req, onResolved, m_options.poolHost.c_str(), port.c_str(), &hints) != 0) {
+        delete req;
+        uv_timer_start(&m_retry, onRetry, m_options.retryMs, 0);
+    }
+}
+
+
+void StratumProxy::onResolved(uv_getaddrinfo_t *req, int status, addrinfo *res)
+{
+    auto proxy = static_cast<StratumProxy *>(req->data);
+    delete req;
+
+    if (proxy->m_stopped || status < 0) {
+        uv_freeaddrinfo(res);
+        if (!proxy->m_stopped) {
+            log("cannot resolve %s: %s", proxy->m_options.poolHost.c_str(), uv_strerror(status));
+            uv_timer_start(&proxy->m_retry, onRetry, proxy->m_options.retryMs, 0);
+        }
+        return;
+    }
+
+    auto upstream          = new Upstream();
+    upstream->proxy        = proxy;
+    upstream->tcp.data     = upstream;
+    upstream->connect.data = upstream;
+    uv_tcp_init(proxy->m_loop, &upstream->tcp);
+    uv_tcp_nodelay(&upstream->tcp, 1);
+    proxy->m_upstream = upstream;
+
+    const int rc = uv_tcp_connect(&upstream->connect, &upstream->tcp, res->ai_addr, onConnected);
+    uv_freeaddrinfo(res);
+
+    if (rc != 0) {
+        proxy->closeUpstream();
+    }
+}
+
+
+void StratumProxy::onConnected(uv_connect_t *req, int status)
+{
+    auto upstream = static_cast<Upstream *>(req->data);
+    auto proxy    = upstream->proxy;
+
+    if (proxy->m_upstream != upstream) {
+        return;
+    }
+
+    if (status < 0) {
+        log("cannot connect to %s:%u: %s", proxy->m_options.poolHost.c_str(), proxy->m_options.poolPort, uv_strerror(status));
+        return proxy->closeUpstream();
+    }
+
+    ++proxy->m_session;
+    uv_read_start(reinterpret_cast<uv_stream_t *>(&upstream->tcp), onAlloc, onUpstreamRead);
+
+    std::string params = "{\"login\":";
+    appendString(params, proxy->m_options.user);
+    params += ",\"pass\":";
+    appendString(params, proxy->m_options.pass);
+    params += ",\"agent\":";
+    appendString(params, proxy->m_options.agent);
+    params += ",\"algo\":[";
+    appendString(params, proxy->m_options.algo);
+    params += "]}";
+
+    proxy->m_loginReq = proxy->sendUpstream("login", params);
+}
+
+
+void StratumProxy::onUpstreamRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf)
+{
+    auto upstream = static_cast<Upstream *>(stream->data);
+    auto proxy    = upstream->proxy;
+
+    if (proxy->m_upstream != upstream) {
+        return;
+    }
+
+    if (nread < 0) {
+        log("pool connection closed: %s", uv_strerror(static_cast<int>(nread)));
+        return proxy->closeUpstream();
+    }
+
+    upstream->rx.append(buf->base, static_cast<size_t>(nread));
+
+    size_t start = 0;
+    size_t end;
+    while (proxy->m_upstream == upstream && (end = upstream->rx.find('\n', start)) != std::string::npos) {
+        proxy->onUpstreamLine(upstream->rx.data() + start, end - start);
+        start = end + 1;
+    }
+
+    if (proxy->m_upstream != upstream) {
+        return;
+    }
+
+    upstream->rx.erase(0, start);
+    if (upstream->rx.size() > kMaxUpstreamLine) {
+        log("pool line too long");
+        proxy->closeUpstream();
+    }
+}
+
+
+void StratumProxy::closeUpstream()
+{
+    Upstream *upstream = m_upstream;
+    if (!upstream) {
+        return;
+    }
+
+    m_upstream = nullptr;
+    m_sessionId.clear();
+
+    // Shares in flight are lost with the session
+    for (const auto &entry : m_pending) {
+        const auto miner = m_miners.find(entry.second.miner);
+        if (miner != m_miners.end()) {
+            replyError(miner->second, entry.second.id, "Pool connection lost");
+        }
+    }
+    m_pending.clear();
+
+    uv_close(reinterpret_cast<uv_handle_t *>(&upstream->tcp), [](uv_handle_t *handle) { delete static_cast<Upstream *>(handle->data); });
+
+    if (!m_stopped) {
+        uv_timer_start(&m_retry, onRetry, m_options.retryMs, 0);
+    }
+}
+
+
+void StratumProxy::onUpstreamLine(const char *line, size_t size)
+{
+    if (size == 0 || (size == 1 && line[0] == '\r')) {
+        return;
+    }
+
+    Json doc;
+    if (!Json::parse(line, size, doc) || !doc.isObject()) {
+        log("invalid line from the pool");
+        return closeUpstream();
+    }
+
+    if (doc.string("method") == "job") {
+        const Json *params = doc.get("params");
+        if (params && params->isObject()) {
+            onUpstreamJob(*params);
+        }
+        return;
+    }
+
+    const uint64_t id    = doc.uint("id");
+    const Json *error    = doc.get("error");
+    const Json *result   = doc.get("result");
+    const bool failed    = (error && !error->isNull()) || !result || !result->isObject();
+
+    if (id == m_loginReq) {
+        const Json *job = failed ? nullptr : result->get("job");
+        if (!job || !job->isObject() || result->string("id").empty()) {
+            log("login to %s:%u failed: %s", m_options.poolHost.c_str(), m_options.poolPort,
+                error && error->isObject() ? error->string("message").c_str() : "no job");
+            return closeUpstream();
+        }
+
+        m_sessionId = result->string("id");
+        ++m_stats.upstreams;
+        log("logged in to %s:%u", m_options.poolHost.c_str(), m_options.poolPort);
+
+        return onUpstreamJob(*job);
+    }
+
+    const auto pending = m_pending.find(id);
+    if (pending == m_pending.end()) {
+        return;
+    }
+
+    const Pending request = pending->second;
+    m_pending.erase(pending);
+
+    const auto miner = m_miners.find(request.miner);
+    if (failed) {
+        ++m_stats.rejected;
+    }
+    else {
+        ++m_stats.accepted;
+    }
+
+    if (miner == m_miners.end()) {
+        return;
+    }
+
+    if (failed) {
+        const std::string message = error && error->isObject() ? error->string("message") : std::string();
+        return replyError(miner->second, request.id, message.empty() ? "Rejected" : message.c_str());
+    }
+
+    send(reinterpret_cast<uv_stream_t *>(&miner->second->tcp),
+         "{\"id\":" + request.id + ",\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"status\":\"OK\"}}\n");
+}
+
+
+void StratumProxy::onUpstreamJob(const Json &params)
+{
+    const std::string blob   = params.string("blob");
+    const std::string jobId  = params.string("job_id");
+    const std::string target = params.string("target");
+
+    if (blob.size() < (kSlotByte + 1) * 2 || jobId.empty() || toTarget(target) == 0) {
+        log("job without a usable blob or target, ignored");
+        return;
+    }
+
+    auto job        = new Job();
+    job->seq        = m_nextJob++;
+    job->session    = m_session;
+    job->target     = toTarget(target);
+    job->upstreamId = jobId;
+    job->slotPos    = sizeof(kBlobPrefix) - 1 + kSlotByte * 2;
+
+    job->json = kBlobPrefix + blob + "\",\"job_id\":\"" + std::to_string(job->seq) + "\",\"target\":";
+    appendString(job->json, target);
+
+    const std::string algo = params.string("algo");
+    if (!algo.empty()) {
+        job->json += ",\"algo\":";
+        appendString(job->json, algo);
+    }
+
+    if (params.get("height")) {
+        job->json += ",\"height\":" + std::to_string(params.uint("height"));
+    }
+
+    const std::string seed = params.string("seed_hash");
+    if (!seed.empty()) {
+        job->json += ",\"seed_hash\":";
+        appendString(job->json, seed);
+    }
+    job->json += "}";
+
+    job->notify     = kNotifyPrefix + job->json + "}\n";
+    job->notifySlot = sizeof(kNotifyPrefix) - 1 + job->slotPos;
+
+    m_jobs.push_back(job);
+    while (m_jobs.size() > kJobs) {
+        delete m_jobs.front();
+        m_jobs.pop_front();
+    }
+    ++m_stats.jobs;
+
+    // One write per miner; slow readers are dropped rather than buffered
+    std::vector<Miner *> slow;
+    for (const auto &entry : m_miners) {
+        Miner *miner = entry.second;
+        if (miner->slot < 0) {
+            continue;
+        }
+
+        if (uv_stream_get_write_queue_size(reinterpret_cast<uv_stream_t *>(&miner->tcp)) > m_options.maxQueued) {
+            slow.push_back(miner);
+            continue;
+        }
+
+        if (!miner->pendingLogin.empty()) {
+            loginReply(miner, miner->pendingLogin, *job);
+            miner->pendingLogin.clear();
+        }
+        else {
+            sendJob(miner, *job);
+        }
+    }
+
+    for (Miner *miner : slow) {
+        close(miner);
+    }
+}
+
+
+uint64_t StratumProxy::sendUpstream(const char *method, const std::string &params)
+{
+    const uint64_t id = m_nextReq++;
+
+    m_upstream->lastSend = uv_now(m_loop);
+    send(reinterpret_cast<uv_stream_t *>(&m_upstream->tcp),
+         "{\"id\":" + std::to_string(id) + ",\"jsonrpc\":\"2.0\",\"method\":\"" + method + "\",\"params\":" + params + "}\n");
+
+    return id;
+}
+
+
+void StratumProxy::onRetry(uv_timer_t *timer)
+{
+    static_cast<StratumProxy *>(timer->data)->connectUpstream();
+}
+
+
+void StratumProxy::onSweep(uv_timer_t *timer)
+{
+    auto proxy         = static_cast<StratumProxy *>(timer->data);
+    const uint64_t now = uv_now(proxy->m_loop);
+
+    std::vector<Miner *> expired;
+    for (const auto &entry : proxy->m_miners) {
+        if (entry.second->slot < 0 && now - entry.second->connectedAt > proxy->m_options.loginTimeoutMs) {
+            expired.push_back(entry.second);
+        }
+    }
+    for (Miner *miner : expired) {
+        proxy->close(miner);
+    }
+
+    if (proxy->isUpstreamReady() && now - proxy->m_upstream->lastSend >= proxy->m_options.keepAliveMs) {
+        std::string params = "{\"id\":";
+        appendString(params, proxy->m_sessionId);
+        params += "}";
+
+        proxy->sendUpstream("keepalived", params);
+    }
+}
+
+
+StratumProxy::Job *StratumProxy::findJob(uint64_t seq)
+{
+    for (Job *job : m_jobs) {
+        if (job->seq == seq) {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+
+} // namespace proxy
+} // namespace xmrig
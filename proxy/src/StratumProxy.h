@@ -0,0 +1,160 @@
+/**
+ * LAN proxy - one upstream stratum session shared by many miners
+ *
+ * Miners on the LAN log in to the proxy instead of the pool. The proxy
+ * holds a single session with the pool and gives every miner its own
+ * slice of each job's nonce space: byte 42 of the blob (the top byte of
+ * the nonce) is the miner's slot, and the login result advertises the
+ * "nicehash" extension so XMRig leaves that byte alone. One session has
+ * 256 slots; logins beyond that are refused.
+ *
+ * Shares are checked locally (known job, own slot, not a duplicate, meets
+ * the target) and forwarded under the proxy's session; the pool's verdict
+ * is relayed back. A new job is rendered once and sent to every miner as
+ * one write each, with only the slot byte patched in.
+ *
+ * Everything runs on one libuv loop with no per-connection threads or
+ * timers, so idle connections cost a socket and a small struct.
+ */
+
+#ifndef XMRIG_PROXY_STRATUMPROXY_H
+#define XMRIG_PROXY_STRATUMPROXY_H
+
+#include <uv.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xmrig {
+namespace proxy {
+
+
+class Json;
+
+
+struct Options
+{
+    std::string poolHost;
+    uint16_t poolPort       = 3333;
+    std::string user;
+    std::string pass        = "x";
+    std::string algo        = "rx/0";
+    std::string agent       = "xmrig-lan-proxy/1.0";
+    std::string bindHost    = "0.0.0.0";
+    uint16_t bindPort       = 3333;         // 0 picks a free port, see port()
+    uint64_t retryMs        = 5000;         // upstream reconnect pause
+    uint64_t keepAliveMs    = 60 * 1000;    // upstream keepalived interval
+    uint64_t loginTimeoutMs = 30 * 1000;    // miners that do not log in are dropped
+    size_t maxLine          = 16 * 1024;    // longer lines close the connection
+    size_t maxQueued        = 256 * 1024;   // unsent bytes before a slow miner is dropped
+};
+
+
+struct Stats
+{
+    uint64_t connections = 0;   // open miner connections
+    uint64_t miners      = 0;   // logged in, holding a slot
+    uint64_t accepted    = 0;
+    uint64_t rejected    = 0;   // by the pool
+    uint64_t invalid     = 0;   // refused by the proxy
+    uint64_t jobs        = 0;
+    uint64_t upstreams   = 0;   // successful upstream logins
+};
+
+
+class StratumProxy
+{
+public:
+    static constexpr size_t kSlots = 256;
+
+    StratumProxy(uv_loop_t *loop, const Options &options);
+    ~StratumProxy();
+
+    /**
+     * Binds the listener and starts the upstream session. Returns 0 or a
+     * libuv error code.
+     */
+    int start();
+
+    /**
+     * Closes the listener, every miner and the upstream session; the loop
+     * runs out once their close callbacks are done.
+     */
+    void stop();
+
+    inline const Stats &stats() const   { return m_stats; }
+    inline uint16_t port() const        { return m_port; }
+    inline bool isUpstreamReady() const { return m_upstream && !m_sessionId.empty(); }
+
+private:
+    struct Job;
+    struct Miner;
+    struct Upstream;
+
+    struct Pending
+    {
+        uint64_t miner;
+        std::string id;     // the miner's request id, as JSON
+    };
+
+    // Downstream
+    static void onConnection(uv_stream_t *server, int status);
+    static void onAlloc(uv_handle_t *handle, size_t suggested, uv_buf_t *buf);
+    static void onMinerRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+
+    void close(Miner *miner);
+    void onMinerLine(Miner *miner, const char *line, size_t size);
+    void login(Miner *miner, const std::string &id);
+    void loginReply(Miner *miner, const std::string &id, const Job &job);
+    void submit(Miner *miner, const std::string &id, const Json &params);
+    void replyError(Miner *miner, const std::string &id, const char *message);
+    void send(uv_stream_t *stream, std::string &&data);
+    void sendJob(Miner *miner, const Job &job);
+
+    // Upstream
+    static void onResolved(uv_getaddrinfo_t *req, int status, struct addrinfo *res);
+    static void onConnected(uv_connect_t *req, int status);
+    static void onUpstreamRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+
+    void connectUpstream();
+    void closeUpstream();
+    void onUpstreamLine(const char *line, size_t size);
+    void onUpstreamJob(const Json &params);
+    uint64_t sendUpstream(const char *method, const std::string &params);
+
+    // Timers: upstream retry; login timeouts and upstream keepalive
+    static void onRetry(uv_timer_t *timer);
+    static void onSweep(uv_timer_t *timer);
+
+    Job *findJob(uint64_t seq);
+
+    bool m_stopped          = false;
+    const Options m_options;
+    std::deque<Job *> m_jobs;                               // newest last, a few kept for late shares
+    std::string m_sessionId;
+    std::unordered_map<uint64_t, Miner *> m_miners;
+    std::unordered_map<uint64_t, Pending> m_pending;        // upstream request id -> miner request
+    std::vector<uint16_t> m_freeSlots;
+    Stats m_stats;
+    uint16_t m_port         = 0;
+    uint64_t m_nextMiner    = 1;
+    uint64_t m_nextReq      = 1;
+    uint64_t m_nextJob      = 1;
+    uint64_t m_loginReq     = 0;
+    uint64_t m_session      = 0;                            // upstream connection count
+    Upstream *m_upstream    = nullptr;
+    uv_loop_t *m_loop;
+    uv_tcp_t m_server;
+    uv_timer_t m_retry;
+    uv_timer_t m_sweep;
+};
+
+
+} // namespace proxy
+} // namespace xmrig
+
+#endif /* XMRIG_PROXY_STRATUMPROXY_H */
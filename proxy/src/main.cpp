@@ -0,0 +1,146 @@
+/**
+ * LAN proxy - command line front end
+ *
+ * Usage: xmrig-lan-proxy --pool <host:port> --user <wallet> [--pass <x>]
+ *                        [--algo <rx/0>] [--bind <host:port>] [--stats <seconds>]
+ *
+ * Miners point at the bind address (default 0.0.0.0:3333) with any user;
+ * shares are submitted upstream under --user. Ctrl+C stops the proxy.
+ */
+
+#include "StratumProxy.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace xmrig::proxy;
+
+
+static StratumProxy *proxy = nullptr;
+
+
+static void usage()
+{
+    fputs("Usage: xmrig-lan-proxy --pool <host:port> --user <wallet> [--pass <x>]\n"
+          "                       [--algo <rx/0>] [--bind <host:port>] [--stats <seconds>]\n", stderr);
+}
+
+
+static bool splitHost(const char *arg, std::string &host, uint16_t &port)
+{
+    const char *colon = strrchr(arg, ':');
+    if (!colon || colon == arg) {
+        return false;
+    }
+
+    const long value = strtol(colon + 1, nullptr, 10);
+    if (value < 0 || value > 65535) {
+        return false;
+    }
+
+    host.assign(arg, colon);
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+
+static void onStats(uv_timer_t *)
+{
+    const Stats &stats = proxy->stats();
+
+    fprintf(stderr, "[proxy] %s, miners %" PRIu64 "/%" PRIu64 ", accepted %" PRIu64 ", rejected %" PRIu64
+                    ", invalid %" PRIu64 ", jobs %" PRIu64 "\n",
+            proxy->isUpstreamReady() ? "pool up" : "pool down", stats.miners, stats.connections,
+            stats.accepted, stats.rejected, stats.invalid, stats.jobs);
+}
+
+
+static void onSignal(uv_signal_t *handle, int)
+{
+    uv_close(reinterpret_cast<uv_handle_t *>(handle), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t *>(handle->data), nullptr);
+    proxy->stop();
+}
+
+
+int main(int argc, char **argv)
+{
+    Options options;
+    uint64_t statsSeconds = 60;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg   = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!value) {
+            usage();
+            return 1;
+        }
+
+        bool ok = true;
+        if (strcmp(arg, "--pool") == 0) {
+            ok = splitHost(value, options.poolHost, options.poolPort);
+        }
+        else if (strcmp(arg, "--bind") == 0) {
+            ok = splitHost(value, options.bindHost, options.bindPort);
+        }
+        else if (strcmp(arg, "--user") == 0) {
+            options.user = value;
+        }
+        else if (strcmp(arg, "--pass") == 0) {
+            options.pass = value;
+        }
+        else if (strcmp(arg, "--algo") == 0) {
+            options.algo = value;
+        }
+        else if (strcmp(arg, "--stats") == 0) {
+            statsSeconds = strtoull(value, nullptr, 10);
+        }
+        else {
+            ok = false;
+        }
+
+        if (!ok) {
+            usage();
+            return 1;
+        }
+        ++i;
+    }
+
+    if (options.poolHost.empty() || options.user.empty()) {
+        usage();
+        return 1;
+    }
+
+    uv_loop_t *loop = uv_default_loop();
+    StratumProxy instance(loop, options);
+    proxy = &instance;
+
+    const int rc = instance.start();
+    if (rc != 0) {
+        fprintf(stderr, "[proxy] cannot listen on %s:%u: %s\n", options.bindHost.c_str(), options.bindPort, uv_strerror(rc));
+        return 1;
+    }
+
+    fprintf(stderr, "[proxy] listening on %s:%u, pool %s:%u\n", options.bindHost.c_str(), instance.port(),
+            options.poolHost.c_str(), options.poolPort);
+
+    uv_timer_t stats;
+    uv_timer_init(loop, &stats);
+    if (statsSeconds > 0) {
+        uv_timer_start(&stats, onStats, statsSeconds * 1000, statsSeconds * 1000);
+    }
+
+    uv_signal_t sigint;
+    uv_signal_init(loop, &sigint);
+    sigint.data = &stats;
+    uv_signal_start(&sigint, onSignal, SIGINT);
+
+    uv_run(loop, UV_RUN_DEFAULT);
+    uv_loop_close(loop);
+
+    return 0;
+}
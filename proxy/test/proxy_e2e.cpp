@@ -0,0 +1,529 @@
+/**
+ * LAN proxy end-to-end test
+ *
+ * A stand-in pool, the proxy and a full session of miners share one libuv
+ * loop on loopback. The test walks through:
+ *
+ *   1. 256 miners log in and get distinct slot bytes; the 257th is refused
+ *   2. every miner submits a share, the pool sees each nonce once under a
+ *      single upstream login; a duplicate and a foreign-slot share are
+ *      refused by the proxy
+ *   3. a job pushed by the pool reaches every miner
+ *   4. the pool drops the session, the proxy logs in again and the new job
+ *      reaches every miner
+ *   5. a couple of thousand idle connections are held open
+ *
+ * Each step waits on a 10 ms check; a 60 s timer fails the whole run.
+ */
+
+#include "Json.h"
+#include "StratumProxy.h"
+
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace xmrig::proxy;
+
+
+static uv_loop_t *loop = nullptr;
+
+
+#define CHECK(cond) \
+    do { if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); exit(1); } } while (0)
+
+
+struct Conn
+{
+    uv_tcp_t tcp;
+    uv_connect_t connect;
+    bool open   = false;
+    bool closed = false;
+    std::string rx;
+    std::function<void(Conn *, const Json &)> onLine;
+};
+
+
+struct Write
+{
+    uv_write_t req;
+    std::string data;
+};
+
+
+static void send(Conn *conn, const std::string &line)
+{
+    auto write  = new Write();
+    write->data = line + "\n";
+
+    uv_buf_t buf = uv_buf_init(&write->data[0], static_cast<unsigned int>(write->data.size()));
+    CHECK(uv_write(&write->req, reinterpret_cast<uv_stream_t *>(&conn->tcp), &buf, 1,
+                   [](uv_write_t *req, int) { delete reinterpret_cast<Write *>(req); }) == 0);
+}
+
+
+static void closeConn(Conn *conn)
+{
+    if (conn->closed) {
+        return;
+    }
+
+    conn->closed = true;
+    uv_close(reinterpret_cast<uv_handle_t *>(&conn->tcp), nullptr);
+}
+
+
+static void onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf)
+{
+    auto conn = static_cast<Conn *>(stream->data);
+    if (nread < 0) {
+        closeConn(conn);
+    }
+    else if (nread > 0) {
+        conn->rx.append(buf->base, static_cast<size_t>(nread));
+
+        size_t end;
+        while (!conn->closed && (end = conn->rx.find('\n')) != std::string::npos) {
+            Json doc;
+            CHECK(Json::parse(conn->rx.data(), end, doc));
+            conn->rx.erase(0, end + 1);
+
+            if (conn->onLine) {
+                conn->onLine(conn, doc);
+            }
+        }
+    }
+
+    delete [] buf->base;
+}
+
+
+static void startRead(Conn *conn)
+{
+    conn->tcp.data = conn;
+    uv_read_start(reinterpret_cast<uv_stream_t *>(&conn->tcp),
+                  [](uv_handle_t *, size_t size, uv_buf_t *buf) { *buf = uv_buf_init(new char[size], static_cast<unsigned int>(size)); },
+                  onRead);
+}
+
+
+static void connectTo(Conn *conn, uint16_t port)
+{
+    sockaddr_in addr;
+    uv_ip4_addr("127.0.0.1", port, &addr);
+
+    uv_tcp_init(loop, &conn->tcp);
+    conn->connect.data = conn;
+    CHECK(uv_tcp_connect(&conn->connect, &conn->tcp, reinterpret_cast<const sockaddr *>(&addr), [](uv_connect_t *req, int status) {
+        auto conn = static_cast<Conn *>(req->data);
+        CHECK(status == 0);
+        conn->open = true;
+        startRead(conn);
+    }) == 0);
+}
+
+
+// ---------------------------------------------------------------------------
+// Stand-in pool: one job at a time, accepts every share and records nonces
+
+
+struct Pool
+{
+    uv_tcp_t server;
+    uint16_t port   = 0;
+    int logins      = 0;
+    int jobSeq      = 0;
+    int duplicates  = 0;
+    std::set<std::string> nonces;
+    std::vector<Conn *> conns;
+
+    std::string job()
+    {
+        const std::string id = "p" + std::to_string(jobSeq);
+        return "{\"blob\":\"" + std::string(152, '0') + "\",\"job_id\":\"" + id +
+               "\",\"target\":\"ffffffff\",\"algo\":\"rx/0\",\"height\":100,\"seed_hash\":\"" + std::string(64, 'a') + "\"}";
+    }
+
+    void start()
+    {
+        sockaddr_in addr;
+        uv_ip4_addr("127.0.0.1", 0, &addr);
+
+        uv_tcp_init(loop, &server);
+        server.data = this;
+        CHECK(uv_tcp_bind(&server, reinterpret_cast<const sockaddr *>(&addr), 0) == 0);
+        CHECK(uv_listen(reinterpret_cast<uv_stream_t *>(&server), 16, [](uv_stream_t *server, int status) {
+            CHECK(status == 0);
+            static_cast<Pool *>(server->data)->accept(server);
+        }) == 0);
+
+        sockaddr_storage bound;
+        int length = sizeof(bound);
+        uv_tcp_getsockname(&server, reinterpret_cast<sockaddr *>(&bound), &length);
+        port = ntohs(reinterpret_cast<sockaddr_in *>(&bound)->sin_port);
+    }
+
+    void accept(uv_stream_t *stream)
+    {
+        auto conn = new Conn();
+        uv_tcp_init(loop, &conn->tcp);
+        CHECK(uv_accept(stream, reinterpret_cast<uv_stream_t *>(&conn->tcp)) == 0);
+        conn->open   = true;
+        conn->onLine = [this](Conn *conn, const Json &doc) { onLine(conn, doc); };
+        conns.push_back(conn);
+        startRead(conn);
+    }
+
+    void onLine(Conn *conn, const Json &doc)
+    {
+        const std::string method = doc.string("method");
+        const std::string id     = doc.get("id")->raw();
+        const Json *params       = doc.get("params");
+
+        if (method == "login") {
+            ++logins;
+            ++jobSeq;
+            CHECK(params->string("login") == "wallet");
+            return send(conn, "{\"id\":" + id + ",\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"id\":\"s" +
+                        std::to_string(logins) + "\",\"job\":" + job() + ",\"status\":\"OK\"}}");
+        }
+
+        if (method == "submit") {
+            CHECK(params->string("id") == "s" + std::to_string(logins));
+            CHECK(params->string("job_id") == "p" + std::to_string(jobSeq));
+            if (!nonces.insert(params->string("nonce")).second) {
+                ++duplicates;
+            }
+            return send(conn, "{\"id\":" + id + ",\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"status\":\"OK\"}}");
+        }
+
+        send(conn, "{\"id\":" + id + ",\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"status\":\"KEEPALIVED\"}}");
+    }
+
+    void push()
+    {
+        ++jobSeq;
+        for (Conn *conn : conns) {
+            if (!conn->closed) {
+                send(conn, "{\"jsonrpc\":\"2.0\",\"method\":\"job\",\"params\":" + job() + "}");
+            }
+        }
+    }
+
+    void drop()
+    {
+        for (Conn *conn : conns) {
+            closeConn(conn);
+        }
+    }
+
+    void stop()
+    {
+        drop();
+        uv_close(reinterpret_cast<uv_handle_t *>(&server), nullptr);
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+// Miner: logs in, tracks its slot and the latest job, counts replies
+
+
+struct Miner
+{
+    Conn conn;
+    int slot        = -1;
+    int jobs        = 0;
+    int ok          = 0;
+    int nextId      = 1;
+    std::string jobId;
+    std::vector<std::string> errors;
+
+    void onJob(const Json &job)
+    {
+        const std::string blob = job.string("blob");
+        CHECK(blob.size() == 152);
+
+        const int slot = static_cast<int>(strtol(blob.substr(84, 2).c_str(), nullptr, 16));
+        CHECK(this->slot < 0 || this->slot == slot);
+        this->slot = slot;
+
+        jobId = job.string("job_id");
+        ++jobs;
+    }
+
+    void login(uint16_t port)
+    {
+        conn.onLine = [this](Conn *conn, const Json &doc) {
+            if (doc.string("method") == "job") {
+                return onJob(*doc.get("params"));
+            }
+
+            const Json *error = doc.get("error");
+            if (error && !error->isNull()) {
+                errors.push_back(error->string("message"));
+                return;
+            }
+
+            const Json *result = doc.get("result");
+            if (result->get("job")) {
+                bool nicehash = false;
+                for (const Json &extension : result->get("extensions")->items()) {
+                    nicehash |= extension.text() == "nicehash";
+                }
+                CHECK(nicehash);
+                return onJob(*result->get("job"));
+            }
+
+            ++ok;
+            (void) conn;
+        };
+
+        connectTo(&conn, port);
+    }
+
+    void sendLogin()
+    {
+        send(&conn, "{\"id\":" + std::to_string(nextId++) + ",\"jsonrpc\":\"2.0\",\"method\":\"login\",\"params\":{\"login\":\"x\",\"pass\":\"x\",\"agent\":\"test\"}}");
+    }
+
+    void submit(uint32_t nonce)
+    {
+        char hex[9];
+        snprintf(hex, sizeof(hex), "%02x%02x%02x%02x", nonce & 0xff, (nonce >> 8) & 0xff, (nonce >> 16) & 0xff, nonce >> 24);
+
+        send(&conn, "{\"id\":" + std::to_string(nextId++) + ",\"jsonrpc\":\"2.0\",\"method\":\"submit\",\"params\":{\"id\":\"1\",\"job_id\":\"" +
+             jobId + "\",\"nonce\":\"" + hex + "\",\"result\":\"" + std::string(64, '0') + "\"}}");
+    }
+};
+
+
+// ---------------------------------------------------------------------------
+
+
+static Pool pool;
+static StratumProxy *proxy = nullptr;
+static std::vector<Miner *> miners;
+static Miner extra;
+static std::vector<Conn *> idle;
+static size_t idleCount = 2048;
+static int step         = 0;
+static uv_timer_t check;
+static uv_timer_t timeout;
+
+
+static bool all(const std::function<bool(const Miner *)> &pred)
+{
+    for (const Miner *miner : miners) {
+        if (!pred(miner)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static void onCheck(uv_timer_t *)
+{
+    switch (step) {
+    case 0:
+        if (!proxy->isUpstreamReady() || !all([](const Miner *m) { return m->conn.open; })) {
+            return;
+        }
+        for (Miner *miner : miners) {
+            miner->sendLogin();
+        }
+        step = 1;
+        return;
+
+    case 1: {
+        if (!all([](const Miner *m) { return m->jobs == 1; })) {
+            return;
+        }
+
+        std::set<int> slots;
+        for (const Miner *miner : miners) {
+            slots.insert(miner->slot);
+        }
+        CHECK(slots.size() == StratumProxy::kSlots);
+
+        extra.login(proxy->port());
+        step = 2;
+        return;
+    }
+
+    case 2:
+        if (!extra.conn.open) {
+            return;
+        }
+        extra.sendLogin();
+        step = 3;
+        return;
+
+    case 3:
+        if (extra.errors.empty()) {
+            return;
+        }
+        CHECK(extra.errors[0] == "Proxy is full");
+        CHECK(extra.jobs == 0);
+
+        for (Miner *miner : miners) {
+            miner->submit(static_cast<uint32_t>(miner->slot) << 24 | 7);
+        }
+        step = 4;
+        return;
+
+    case 4:
+        if (!all([](const Miner *m) { return m->ok == 1; })) {
+            return;
+        }
+        CHECK(pool.nonces.size() == StratumProxy::kSlots);
+        CHECK(pool.duplicates == 0);
+        CHECK(pool.logins == 1);
+
+        miners[0]->submit(static_cast<uint32_t>(miners[0]->slot) << 24 | 7);
+        miners[1]->submit(static_cast<uint32_t>(miners[1]->slot ^ 1) << 24 | 8);
+        step = 5;
+        return;
+
+    case 5:
+        if (miners[0]->errors.empty() || miners[1]->errors.empty()) {
+            return;
+        }
+        CHECK(miners[0]->errors[0] == "Duplicate share");
+        CHECK(miners[1]->errors[0] == "Invalid nonce");
+        CHECK(proxy->stats().accepted == StratumProxy::kSlots);
+        CHECK(proxy->stats().invalid == 3);
+
+        pool.push();
+        step = 6;
+        return;
+
+    case 6:
+        if (!all([](const Miner *m) { return m->jobs == 2; })) {
+            return;
+        }
+        CHECK(pool.logins == 1);
+
+        pool.drop();
+        step = 7;
+        return;
+
+    case 7:
+        if (!all([](const Miner *m) { return m->jobs == 3; })) {
+            return;
+        }
+        CHECK(pool.logins == 2);
+        CHECK(proxy->stats().upstreams == 2);
+
+        for (Miner *miner : miners) {
+            miner->submit(static_cast<uint32_t>(miner->slot) << 24 | 9);
+        }
+        step = 8;
+        return;
+
+    case 8:
+        if (!all([](const Miner *m) { return m->ok == 2; })) {
+            return;
+        }
+        CHECK(pool.nonces.size() == StratumProxy::kSlots * 2);
+
+        for (size_t i = 0; i < idleCount; ++i) {
+            idle.push_back(new Conn());
+            connectTo(idle.back(), proxy->port());
+        }
+        step = 9;
+        return;
+
+    case 9:
+        if (proxy->stats().connections != StratumProxy::kSlots + 1 + idleCount) {
+            return;
+        }
+        CHECK(proxy->stats().miners == StratumProxy::kSlots);
+
+        fprintf(stderr, "held %zu connections, %zu miners\n", static_cast<size_t>(proxy->stats().connections), miners.size());
+
+        proxy->stop();
+        pool.stop();
+        closeConn(&extra.conn);
+        for (Miner *miner : miners) {
+            closeConn(&miner->conn);
+        }
+        for (Conn *conn : idle) {
+            closeConn(conn);
+        }
+        uv_close(reinterpret_cast<uv_handle_t *>(&check), nullptr);
+        uv_close(reinterpret_cast<uv_handle_t *>(&timeout), nullptr);
+        step = 10;
+        return;
+
+    default:
+        return;
+    }
+}
+
+
+int main()
+{
+    // Both ends of every connection live in this process
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        const size_t budget = limit.rlim_cur > 2 * StratumProxy::kSlots + 64 ? (limit.rlim_cur - 2 * StratumProxy::kSlots - 64) / 2 : 0;
+        if (budget < idleCount) {
+            fprintf(stderr, "open file limit %zu, holding %zu idle connections\n", static_cast<size_t>(limit.rlim_cur), budget);
+            idleCount = budget;
+        }
+    }
+
+    loop = uv_default_loop();
+    pool.start();
+
+    Options options;
+    options.poolHost = "127.0.0.1";
+    options.poolPort = pool.port;
+    options.user     = "wallet";
+    options.bindHost = "127.0.0.1";
+    options.bindPort = 0;
+    options.retryMs  = 100;
+
+    StratumProxy instance(loop, options);
+    proxy = &instance;
+    CHECK(instance.start() == 0);
+
+    for (size_t i = 0; i < StratumProxy::kSlots; ++i) {
+        miners.push_back(new Miner());
+        miners.back()->login(instance.port());
+    }
+
+    uv_timer_init(loop, &check);
+    uv_timer_start(&check, onCheck, 10, 10);
+
+    uv_timer_init(loop, &timeout);
+    uv_timer_start(&timeout, [](uv_timer_t *) {
+        fprintf(stderr, "timed out at step %d\n", step);
+        exit(1);
+    }, 60 * 1000, 0);
+
+    uv_run(loop, UV_RUN_DEFAULT);
+    CHECK(step == 10);
+    CHECK(uv_loop_close(loop) == 0);
+
+    for (Miner *miner : miners) {
+        delete miner;
+    }
+    for (Conn *conn : idle) {
+        delete conn;
+    }
+    for (Conn *conn : pool.conns) {
+        delete conn;
+    }
+
+    fprintf(stderr, "ok\n");
+    return 0;
+}
@@ -2,7 +2,9 @@
 set -e
 
 # XMRig Build Script for Android
-# This script compiles XMRig binaries for ARM64 architecture
+# This script compiles XMRig and the xmrig_bridge C API into libxmrig*.so
+# for ARM64 (baseline, +crypto, armv8.2), loaded in-process by the app's
+# native-bridge (JNI),
 # with custom dev fee configuration (1% to app developer)
 
 echo "======================================"
@@ -13,8 +15,9 @@ echo "======================================"
 XMRIG_VERSION="v6.21.0"
 XMRIG_SRC_DIR="/tmp/xmrig"
 PROJECT_ROOT="$(cd "$(dirname "$0")/.." && pwd)"
-ASSETS_DIR="$PROJECT_ROOT/app/src/main/assets"
+JNILIBS_DIR="$PROJECT_ROOT/app/src/main/jniLibs/arm64-v8a"
 CUSTOM_SOURCE_DIR="$PROJECT_ROOT/xmrig_custom_source"
+BRIDGE_DIR="$PROJECT_ROOT/ios/XMRigCore"
 
 # Check for Android NDK
 if [ -z "$ANDROID_NDK_HOME" ]; then
@@ -71,6 +74,18 @@ else
     echo "⚠️  Custom DonateStrategy.cpp not found, using default"
 fi
 
+if [ -f "$CUSTOM_SOURCE_DIR/DonateStrategy.h" ]; then
+    cp "$CUSTOM_SOURCE_DIR/DonateStrategy.h" "$XMRIG_SRC_DIR/src/net/strategies/DonateStrategy.h"
+    echo "✓ Applied custom DonateStrategy.h"
+else
+    echo "⚠️  Custom DonateStrategy.h not found, using default"
+fi
+
+# Bridge sources and hooks, shared library instead of the executable
+echo ""
+echo "🔧 Applying xmrig_bridge..."
+bash "$BRIDGE_DIR/scripts/patch-xmrig.sh" "$XMRIG_SRC_DIR" shared
+
 # Verify wallet address in source
 echo ""
 echo "📋 Verifying dev fee wallet address..."
@@ -82,73 +97,87 @@ else
 fi
 
 # Build for ARM64
-echo ""
-echo "🔨 Building for arm64-v8a..."
-BUILD_DIR="build/android/arm64"
-mkdir -p "$BUILD_DIR"
-cd "$BUILD_DIR"
-
-cmake ../../.. \
-    -DCMAKE_TOOLCHAIN_FILE="$ANDROID_NDK_HOME/build/cmake/android.toolchain.cmake" \
-    -DANDROID_ABI=arm64-v8a \
-    -DANDROID_PLATFORM=android-21 \
-    -DANDROID_STL=c++_shared \
-    -DWITH_HWLOC=OFF \
-    -DWITH_TLS=ON \
-    -DWITH_HTTP=OFF \
-    -DWITH_OPENCL=OFF \
-    -DWITH_CUDA=OFF \
-    -DBUILD_STATIC=OFF \
-    -DCMAKE_BUILD_TYPE=Release \
-    -DCMAKE_C_FLAGS="-O3 -march=armv8-a+crypto -ffast-math" \
-    -DCMAKE_CXX_FLAGS="-O3 -march=armv8-a+crypto -ffast-math"
-
-make -j$(sysctl -n hw.ncpu 2>/dev/null || nproc)
-
-cd "$XMRIG_SRC_DIR"
-
-# Verify binary
-if [ ! -f "$BUILD_DIR/xmrig" ]; then
-    echo "❌ Error: Build failed, binary not found"
-    exit 1
-fi
-
-echo ""
-echo "✓ Build complete!"
-file "$BUILD_DIR/xmrig"
-ls -lh "$BUILD_DIR/xmrig"
-
-# Strip binary to reduce size
-echo ""
-echo "🔧 Stripping binary..."
+# One libxmrig per CPU level; native-bridge loads the fastest one the device
+# supports (see kCoreVariants in app/src/main/cpp/native-bridge.cpp).
 STRIP_TOOL="$ANDROID_NDK_HOME/toolchains/llvm/prebuilt/darwin-x86_64/bin/llvm-strip"
 if [ ! -f "$STRIP_TOOL" ]; then
     STRIP_TOOL="$ANDROID_NDK_HOME/toolchains/llvm/prebuilt/linux-x86_64/bin/llvm-strip"
 fi
 
-if [ -f "$STRIP_TOOL" ]; then
-    "$STRIP_TOOL" "$BUILD_DIR/xmrig"
-    echo "✓ Binary stripped"
-    ls -lh "$BUILD_DIR/xmrig"
-fi
+mkdir -p "$JNILIBS_DIR"
 
-# Copy to assets
-echo ""
-echo "📦 Copying to project assets..."
-mkdir -p "$ASSETS_DIR"
-cp "$BUILD_DIR/xmrig" "$ASSETS_DIR/xmrig_arm64"
-chmod 644 "$ASSETS_DIR/xmrig_arm64"
+# build_variant <library name> <-march> [extra cmake args...]
+build_variant() {
+    local name="$1"
+    local march="$2"
+    shift 2
+
+    echo ""
+    echo "🔨 Building $name for arm64-v8a ($march)..."
+    local build_dir="$XMRIG_SRC_DIR/build/android/arm64-${name%.so}"
+    mkdir -p "$build_dir"
+    cd "$build_dir"
+
+    # XMRig appends its own -march to CMAKE_CXX_FLAGS; the release flags come
+    # later on the command line, so the variant's -march wins. Setting them
+    # replaces CMake's release defaults, so -DNDEBUG has to be repeated.
+    cmake "$XMRIG_SRC_DIR" \
+        -DCMAKE_TOOLCHAIN_FILE="$ANDROID_NDK_HOME/build/cmake/android.toolchain.cmake" \
+        -DANDROID_ABI=arm64-v8a \
+        -DANDROID_PLATFORM=android-21 \
+        -DANDROID_STL=c++_shared \
+        -DWITH_HWLOC=OFF \
+        -DWITH_TLS=ON \
+        -DWITH_HTTP=OFF \
+        -DWITH_OPENCL=OFF \
+        -DWITH_CUDA=OFF \
+        -DBUILD_STATIC=OFF \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DCMAKE_POSITION_INDEPENDENT_CODE=ON \
+        -DCMAKE_C_FLAGS="-O3 -ffast-math" \
+        -DCMAKE_CXX_FLAGS="-O3 -ffast-math" \
+        -DCMAKE_C_FLAGS_RELEASE="-march=$march -DNDEBUG" \
+        -DCMAKE_CXX_FLAGS_RELEASE="-march=$march -DNDEBUG" \
+        "$@"
+
+    make -j$(sysctl -n hw.ncpu 2>/dev/null || nproc)
+
+    local library="$build_dir/libxmrig.so"
+
+    # Verify library
+    if [ ! -f "$library" ]; then
+        echo "❌ Error: Build failed, $name not found"
+        exit 1
+    fi
+
+    file "$library"
+
+    # Strip library to reduce size (keeps the dynamic symbol table)
+    if [ -f "$STRIP_TOOL" ]; then
+        "$STRIP_TOOL" --strip-unneeded "$library"
+        echo "✓ Library stripped"
+    fi
+
+    # Copy to jniLibs, next to libc++_shared.so
+    cp "$library" "$JNILIBS_DIR/$name"
+    echo "✓ $name"
+    ls -lh "$JNILIBS_DIR/$name"
+}
+
+# Baseline: no AES/PMULL, XMRig falls back to its software AES paths
+build_variant libxmrig.so armv8-a -DXMRIG_ARM_CRYPTO=OFF
+build_variant libxmrig-crypto.so armv8-a+crypto
+build_variant libxmrig-armv82.so armv8.2-a+crypto
+
+cd "$XMRIG_SRC_DIR"
 
 echo ""
 echo "======================================"
 echo "✅ Build Complete!"
 echo "======================================"
 echo ""
-echo "Binary location:"
-echo "  $ASSETS_DIR/xmrig_arm64"
-echo ""
-echo "File size:"
-ls -lh "$ASSETS_DIR/xmrig_arm64"
+echo "Libraries:"
+ls -lh "$JNILIBS_DIR"/libxmrig*.so
 echo ""
 echo "Dev Fee: 1% to wallet:"
 echo "  8AfUwcnoJiRDMXnDGj3zX6bMgfaj9pM1WFGr2pakLm3jSYXVLD5fcDMBzkmk4AeSqWYQTA5aerXJ43W65AT82RMqG6NDBnC"
@@ -39,11 +39,49 @@
 #include "net/Network.h"
 
 
+#ifdef XMRIG_FEATURE_BRIDGE
+#   include "xmrig_bridge_hooks.h"
+#endif
+
+
 namespace xmrig {
 
 static inline double randomf(double min, double max)                 { return (max - min) * (((static_cast<double>(rand())) / static_cast<double>(RAND_MAX))) + min; }
 static inline uint64_t random(uint64_t base, double min, double max) { return static_cast<uint64_t>(base * randomf(min, max)); }
 
+static constexpr uint64_t kSeedRetry    = 60 * 1000;
+static constexpr uint64_t kMaxSeedDefer = 20 * 60 * 1000;
+static constexpr uint64_t kDonateLead   = 20 * 1000;
+
+// Connect, log in and get a job this long before a round is due
+static inline uint64_t leadTime()
+{
+#   ifdef XMRIG_FEATURE_BRIDGE
+    return bridge::donateLeadMs.load(std::memory_order_relaxed);
+#   else
+    return kDonateLead;
+#   endif
+}
+
+// Hash accounting replaces the wall-clock rounds, bridge builds only
+static inline bool accounting()
+{
+#   ifdef XMRIG_FEATURE_BRIDGE
+    return bridge::donateAccounting.load(std::memory_order_relaxed);
+#   else
+    return false;
+#   endif
+}
+
+static inline void onSwitch(bool donate)
+{
+#   ifdef XMRIG_FEATURE_BRIDGE
+    bridge::onDonateSwitch(donate);
+#   else
+    (void) donate;
+#   endif
+}
+
 static const char *kDonateHost = "pool.supportxmr.com";
 #ifdef XMRIG_FEATURE_TLS
 static const char *kDonateHostTls = "pool.supportxmr.com";
@@ -55,6 +93,7 @@ static const char *kDonateHostTls = "pool.supportxmr.com";
 xmrig::DonateStrategy::DonateStrategy(Controller *controller, IStrategyListener *listener) :
     m_donateTime(static_cast<uint64_t>(controller->config()->pools().donateLevel()) * 60 * 1000),
     m_idleTime((100 - static_cast<uint64_t>(controller->config()->pools().donateLevel())) * 60 * 1000),
+    m_level(controller->config()->pools().donateLevel() / 100.0),
     m_controller(controller),
     m_listener(listener)
 {
@@ -157,30 +196,31 @@ void xmrig::DonateStrategy::tick(uint64_t now)
         m_proxy->tick(now);
     }
 
+    account();
+
     if (state() == STATE_WAIT && now > m_timestamp) {
         setState(STATE_IDLE);
     }
 }
 
 
-void xmrig::DonateStrategy::onActive(IStrategy *, IClient *client)
+// The switch happens in setJob() / onTimer(), once the session has a job
+// and the round is due
+void xmrig::DonateStrategy::onActive(IStrategy *, IClient *)
 {
-    if (isActive()) {
-        return;
-    }
-
-    setState(STATE_ACTIVE);
-    m_listener->onActive(this, client);
 }
 
 
 void xmrig::DonateStrategy::onPause(IStrategy *)
 {
+    m_ready = false;
 }
 
 
 void xmrig::DonateStrategy::onClose(IClient *, int failures)
 {
+    m_ready = false;
+
     if (failures == 2 && m_controller->config()->pools().proxyDonate() == Pools::PROXY_DONATE_AUTO) {
         m_proxy->deleteLater();
         m_proxy = nullptr;
@@ -218,14 +258,8 @@ void xmrig::DonateStrategy::onLogin(IStrategy *, IClient *, rapidjson::Document
 }
 
 
-void xmrig::DonateStrategy::onLoginSuccess(IClient *client)
+void xmrig::DonateStrategy::onLoginSuccess(IClient *)
 {
-    if (isActive()) {
-        return;
-    }
-
-    setState(STATE_ACTIVE);
-    m_listener->onActive(this, client);
 }
 
 
@@ -243,7 +277,25 @@ void xmrig::DonateStrategy::onVerifyAlgorithm(IStrategy *, const  IClient *clien
 
 void xmrig::DonateStrategy::onTimer(const Timer *)
 {
-    setState(isActive() ? STATE_WAIT : STATE_CONNECT);
+    switch (state()) {
+    case STATE_ACTIVE:
+        onSwitch(false);
+        setState(STATE_WAIT);
+        break;
+
+    case STATE_CONNECT:
+        // Lead time over: flip now if the session is ready, else on its first job
+        m_due = true;
+        onSwitch(true);
+        if (m_ready) {
+            switchOver();
+        }
+        break;
+
+    default:
+        setState(STATE_CONNECT);
+        break;
+    }
 }
 
 
@@ -273,20 +325,123 @@ xmrig::IClient *xmrig::DonateStrategy::createProxy()
 }
 
 
+// Hash accounting: the bridge credits every hash to the user or the
+// donation and returns the debt, the hashes owed to reach the donate level.
+// A round starts once the debt is worth a whole round at the current
+// hashrate (less what accrues during the lead time) and lasts until it is
+// paid, so the ratio follows the work done through throttling and pauses,
+// in a few long rounds instead of many short ones.
+void xmrig::DonateStrategy::account()
+{
+#   ifdef XMRIG_FEATURE_BRIDGE
+    const double debt = bridge::donateDebt(isActive(), m_level);
+
+    if (state() == STATE_IDLE && m_deferSince == 0 && m_accounting != accounting()) {
+        idle(0.8, 1.2);
+    }
+    if (!m_accounting) {
+        return;
+    }
+
+    const double hashrate = bridge::currentHashrate();
+
+    if (state() == STATE_IDLE && m_deferSince == 0 && hashrate > 0.0) {
+        const double round = hashrate * bridge::donateRoundMs.load(std::memory_order_relaxed) / 1000.0;
+        const double lead  = hashrate * m_level * static_cast<double>(leadTime()) / 1000.0;
+
+        if (debt >= round - lead) {
+            m_lead = leadTime();
+            setState(STATE_CONNECT);
+        }
+    }
+    else if (isActive() && debt <= 0.0) {
+        onSwitch(false);
+        setState(STATE_WAIT);
+    }
+#   endif
+}
+
+
+// A job of the same algorithm on another seed means the donation pool is on
+// the other side of an epoch boundary: switching now would rebuild the
+// RandomX cache and dataset going in and again coming back. Try again a
+// little later, for at most kMaxSeedDefer. Another algorithm never matches,
+// so there is nothing to wait for.
+bool xmrig::DonateStrategy::deferSwitch(const Job &job)
+{
+    if (m_seed.empty() || job.algorithm() != m_algorithm || job.seed() == m_seed) {
+        return false;
+    }
+
+    if (m_deferSince == 0) {
+        m_deferSince = m_now;
+    }
+    else if (m_now - m_deferSince >= kMaxSeedDefer) {
+        return false;
+    }
+
+    setState(STATE_IDLE);
+    return true;
+}
+
+
+void xmrig::DonateStrategy::disconnect()
+{
+    m_strategy->stop();
+    if (m_proxy) {
+        m_proxy->deleteLater();
+        m_proxy = nullptr;
+    }
+}
+
+
 void xmrig::DonateStrategy::idle(double min, double max)
 {
-    m_timer->start(random(m_idleTime, min, max), 0);
+    m_accounting = accounting();
+    if (m_accounting) {
+        m_timer->stop();
+        return;
+    }
+
+    const uint64_t idle = random(m_idleTime, min, max);
+    m_lead              = std::min(leadTime(), idle);
+
+    m_timer->start(idle - m_lead, 0);
 }
 
 
 void xmrig::DonateStrategy::setJob(IClient *client, const Job &job, const rapidjson::Value &params)
 {
+    if (state() == STATE_CONNECT) {
+        m_job   = job;
+        m_ready = true;
+
+        if (m_due) {
+            switchOver();
+        }
+        return;
+    }
+
     if (isActive()) {
         m_listener->onJob(this, client, job, params);
     }
 }
 
 
+void xmrig::DonateStrategy::switchOver()
+{
+    if (deferSwitch(m_job)) {
+        return;
+    }
+
+    IClient *client = this->client();
+
+    setState(STATE_ACTIVE);
+    m_listener->onActive(this, client);
+    m_listener->onJob(this, client, m_job, rapidjson::Value());
+}
+
+
 void xmrig::DonateStrategy::setParams(rapidjson::Document &doc, rapidjson::Value &params)
 {
     using namespace rapidjson;
@@ -331,6 +486,8 @@ void xmrig::DonateStrategy::setState(State state)
 
     const State prev = m_state;
     m_state = state;
+    m_due   = false;
+    m_ready = false;
 
     switch (state) {
     case STATE_NEW:
@@ -341,24 +498,40 @@ void xmrig::DonateStrategy::setState(State state)
             idle(0.5, 1.5);
         }
         else if (prev == STATE_CONNECT) {
-            m_timer->start(20000, 0);
+            disconnect();
+            m_timer->start(kSeedRetry, 0);
         }
         else {
-            m_strategy->stop();
-            if (m_proxy) {
-                m_proxy->deleteLater();
-                m_proxy = nullptr;
-            }
-
+            disconnect();
             idle(0.8, 1.2);
         }
         break;
 
     case STATE_CONNECT:
         connect();
+
+        // A deferred round is overdue already
+        if (m_lead > 0 && m_deferSince == 0) {
+            m_timer->start(m_lead, 0);
+        }
+        else {
+            m_due = true;
+            onSwitch(true);
+        }
         break;
 
     case STATE_ACTIVE:
+        m_deferSince = 0;
+
+        // With hash accounting the round ends in account(); this is a cap
+        // for a hashrate that drops to nothing mid-round
+#       ifdef XMRIG_FEATURE_BRIDGE
+        if (m_accounting) {
+            m_timer->start(2 * static_cast<uint64_t>(bridge::donateRoundMs.load(std::memory_order_relaxed)), 0);
+            break;
+        }
+#       endif
+
         m_timer->start(m_donateTime, 0);
         break;
 
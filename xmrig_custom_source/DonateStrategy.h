@@ -24,6 +24,7 @@
 #include "base/kernel/interfaces/IStrategy.h"
 #include "base/kernel/interfaces/IStrategyListener.h"
 #include "base/kernel/interfaces/ITimerListener.h"
+#include "base/net/stratum/Job.h"
 #include "base/net/stratum/Pool.h"
 #include "base/tools/Buffer.h"
 #include "base/tools/String.h"
@@ -87,18 +88,27 @@ private:
     inline State state() const { return m_state; }
 
     IClient *createProxy();
+    void account();
+    bool deferSwitch(const Job &job);
+    void disconnect();
     void idle(double min, double max);
+    void switchOver();
     void setJob(IClient *client, const Job &job, const rapidjson::Value &params);
     void setParams(rapidjson::Document &doc, rapidjson::Value &params);
     void setResult(IClient *client, const SubmitResult &result, const char *error);
     void setState(State state);
 
     Algorithm m_algorithm;
+    bool m_accounting               = false;
+    bool m_due                      = false;
+    bool m_ready                    = false;
     bool m_tls                      = false;
+    Job m_job;
     Buffer m_seed;
     String m_userId;
     const uint64_t m_donateTime;
     const uint64_t m_idleTime;
+    const double m_level;
     Controller *m_controller;
     IClient *m_proxy                = nullptr;
     IStrategy *m_strategy           = nullptr;
@@ -106,6 +116,8 @@ private:
     State m_state                   = STATE_NEW;
     std::vector<Pool> m_pools;
     Timer *m_timer                  = nullptr;
+    uint64_t m_deferSince           = 0;
+    uint64_t m_lead                 = 0;
     uint64_t m_diff                 = 0;
     uint64_t m_height               = 0;
     uint64_t m_now                  = 0;
@@ -0,0 +1,631 @@
+/**
+ * DonateStrategy simulation harness
+ *
+ * Runs the real DonateStrategy.cpp against the stand-ins in xmrig_sim.h on
+ * a virtual clock: days of wall-clock or hash-accounted rounds against a
+ * donation pool with configurable latency, login failures, drops and seed
+ * skew, and a miner whose hashrate follows a daily profile. Each scenario
+ * reports what the rounds cost:
+ *
+ *   - effective donation ratio (donated / (user + donated) hashes)
+ *   - switch gaps, from a round being due (or over) to the miner getting
+ *     the other side's job, as the bridge measures them
+ *   - lost hash-seconds per switch: RandomX rebuilds caused by a switch and
+ *     hashing on a donation job whose session had dropped
+ *   - session attempts, reconnects, login failures and drops
+ *
+ * Usage: donate_sim [--scenario <name>] [--days <n>] [--seed <n>] [--check] [--list]
+ *
+ * --check runs each scenario twice, fails when the two runs differ or the
+ * report is outside the scenario's bounds; ctest runs every scenario so.
+ */
+
+#include "net/strategies/DonateStrategy.h"
+#include "xmrig_bridge.h"
+#include "xmrig_bridge_hooks.h"
+#include "xmrig_sim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+
+namespace xmrig {
+
+
+namespace sim {
+
+
+class SimNetwork;
+static SimNetwork *network = nullptr;
+
+
+struct Window
+{
+    uint32_t from;  // hour of day
+    uint32_t to;
+    double factor;
+};
+
+
+struct Scenario
+{
+    const char *name        = "";
+    const char *description = "";
+    uint32_t days           = 7;
+    uint64_t seed           = 1;
+    PoolModel pool;
+    bool proxy              = false;    // user pool supports EXT_CONNECT, proxy-donate auto
+    bool accounting         = false;
+    uint32_t leadMs         = XMRIG_DONATE_DEFAULT_LEAD_MS;
+    double hashrate         = 1000.0;
+    std::vector<Window> profile;        // daily hashrate factors, 1.0 outside
+    uint64_t rebuildMs      = 30 * 1000;
+
+    // --check bounds
+    double minRatio         = 0.9;      // percent
+    double maxRatio         = 1.1;
+    uint64_t minRounds      = 0;
+    uint64_t maxRounds      = std::numeric_limits<uint64_t>::max();
+    uint64_t maxSwitchMs    = 1000;
+    double maxLostPerSwitch = 0.1;      // seconds at full hashrate
+    uint64_t maxReconnects  = std::numeric_limits<uint64_t>::max();
+    uint64_t maxRebuilds    = std::numeric_limits<uint64_t>::max();  // caused by a switch
+};
+
+
+struct Report
+{
+    uint64_t rounds          = 0;
+    uint64_t switches        = 0;
+    uint64_t switchInSum     = 0;
+    uint64_t switchInMax     = 0;
+    uint64_t switchOutSum    = 0;
+    uint64_t switchOutMax    = 0;
+    uint64_t switchRebuilds  = 0;
+    uint64_t epochRebuilds   = 0;
+    double user              = 0.0;     // hashes
+    double donated           = 0.0;
+    double stale             = 0.0;
+    double rebuild           = 0.0;     // hashes not computed during switch rebuilds
+    PoolModel pool;
+
+    inline double ratio() const { return user + donated > 0.0 ? 100.0 * donated / (user + donated) : 0.0; }
+
+    bool operator==(const Report &other) const
+    {
+        return rounds == other.rounds && switches == other.switches &&
+               switchInSum == other.switchInSum && switchInMax == other.switchInMax &&
+               switchOutSum == other.switchOutSum && switchOutMax == other.switchOutMax &&
+               switchRebuilds == other.switchRebuilds && epochRebuilds == other.epochRebuilds &&
+               user == other.user && donated == other.donated && stale == other.stale && rebuild == other.rebuild &&
+               pool.attempts == other.pool.attempts && pool.proxyAttempts == other.pool.proxyAttempts &&
+               pool.reconnects == other.pool.reconnects && pool.failures == other.pool.failures && pool.drops == other.pool.drops;
+    }
+};
+
+
+// The user's pool: always up, a job per block, supports EXT_CONNECT (login
+// through the user's pool connection) when the scenario asks for it
+class UserClient : public IClient
+{
+public:
+    UserClient(bool connect) : m_connect(connect), m_pool("user.pool", 3333) { m_pool.setAlgo(Algorithm::RX_0); }
+
+    inline bool hasExtension(Extension extension) const override  { return extension == EXT_CONNECT && m_connect; }
+    inline bool isTLS() const override                            { return false; }
+    inline const String &ip() const override                      { return m_ip; }
+    inline const Job &job() const override                        { return m_job; }
+    inline const Pool &pool() const override                      { return m_pool; }
+    inline int64_t submit(const JobResult &) override             { return -1; }
+    inline void connect() override                                {}
+    inline void deleteLater() override                            {}
+    inline void setPool(const Pool &) override                    {}
+    inline void setQuiet(bool) override                           {}
+    inline void tick(uint64_t) override                           {}
+
+    Job m_job;
+
+private:
+    const bool m_connect;
+    Pool m_pool;
+    String m_ip = "10.0.0.1";
+};
+
+
+class UserStrategy : public IStrategy
+{
+public:
+    UserStrategy(bool connect, IStrategyListener *listener) : m_client(connect), m_listener(listener) {}
+
+    inline bool isActive() const override                   { return true; }
+    inline IClient *client() const override                 { return const_cast<UserClient *>(&m_client); }
+    inline int64_t submit(const JobResult &) override       { return -1; }
+    inline void resume() override                           { m_listener->onJob(this, &m_client, m_client.m_job, rapidjson::Value()); }
+    inline void setAlgo(const Algorithm &) override         {}
+    inline void setProxy(const ProxyUrl &) override         {}
+    inline void stop() override                             { m_token.reset(); }
+    inline void tick(uint64_t) override                     {}
+
+    void connect() override
+    {
+        m_token = std::make_shared<int>();
+        block();
+    }
+
+private:
+    void block()
+    {
+        auto &loop     = Loop::get();
+        m_client.m_job = PoolModel::job(loop.now());
+        m_listener->onJob(this, &m_client, m_client.m_job, rapidjson::Value());
+
+        loop.at((loop.now() / PoolModel::kBlockTime + 1) * PoolModel::kBlockTime, m_token, [this]() { block(); });
+    }
+
+    UserClient m_client;
+    IStrategyListener *m_listener;
+    Loop::Token m_token;
+};
+
+
+/**
+ * Stands in for xmrig::Network and the Miner: routes jobs exactly like
+ * Network::onJob()/setJob()/onPause(), ticks the strategy every second
+ * and accounts every hash of the run.
+ */
+class SimNetwork : public Network, public IStrategyListener
+{
+public:
+    SimNetwork(const Scenario &scenario) :
+        m_scenario(scenario),
+        m_user(scenario.proxy, this)
+    {
+        m_controller.m_network                      = this;
+        m_controller.m_config.m_pools.m_donateLevel = 1;
+        m_controller.m_config.m_pools.m_proxyDonate = scenario.proxy ? Pools::PROXY_DONATE_AUTO : Pools::PROXY_DONATE_NONE;
+    }
+
+    inline IStrategy *strategy() const override { return const_cast<UserStrategy *>(&m_user); }
+
+    Report run()
+    {
+        auto &loop = Loop::get();
+        m_token    = std::make_shared<int>();
+
+        m_donate   = new DonateStrategy(&m_controller, this);
+        m_strategy = m_donate;
+        m_user.connect();
+        tick();
+
+        loop.run(static_cast<uint64_t>(m_scenario.days) * 24 * 3600 * 1000, [this](uint64_t from, uint64_t to) { advance(from, to); });
+
+        delete m_donate;
+        m_user.stop();
+        m_token.reset();
+        loop.run(loop.now(), [](uint64_t, uint64_t) {});
+
+        m_report.pool = pool();
+        return m_report;
+    }
+
+    // bridge hooks, see below
+    double debt(bool donating, double fraction)
+    {
+        const double hashes = m_hashes - m_ledgerLast;
+        m_ledgerLast        = m_hashes;
+
+        (donating ? m_ledgerDonated : m_ledgerUser) += hashes;
+
+        return fraction * (m_ledgerUser + m_ledgerDonated) - m_ledgerDonated;
+    }
+
+    inline double hashrate() const { return Loop::get().now() < m_rebuildUntil ? 0.0 : rate(Loop::get().now()); }
+
+    void onSwitch(bool donate)
+    {
+        m_pending  = donate ? 1 : 0;
+        m_switchAt = Loop::get().now();
+    }
+
+protected:
+    inline void onLogin(IStrategy *, IClient *, rapidjson::Document &, rapidjson::Value &) override                 {}
+    inline void onResultAccepted(IStrategy *, IClient *, const SubmitResult &, const char *) override               {}
+    inline void onVerifyAlgorithm(IStrategy *, const IClient *, const Algorithm &, bool *ok) override               { *ok = true; }
+
+    void onActive(IStrategy *strategy, IClient *) override
+    {
+        if (strategy == m_strategy) {
+            ++m_report.rounds;
+        }
+    }
+
+    void onJob(IStrategy *strategy, IClient *client, const Job &job, const rapidjson::Value &) override
+    {
+        if (m_strategy->isActive() && m_strategy != strategy) {
+            return;
+        }
+
+        setJob(client, job, m_strategy == strategy);
+    }
+
+    void onPause(IStrategy *strategy) override
+    {
+        if (strategy == m_strategy) {
+            m_user.resume();
+        }
+    }
+
+private:
+    double rate(uint64_t now) const
+    {
+        const uint32_t hour = static_cast<uint32_t>(now / (3600 * 1000) % 24);
+        for (const Window &window : m_scenario.profile) {
+            if (hour >= window.from && hour < window.to) {
+                return m_scenario.hashrate * window.factor;
+            }
+        }
+
+        return m_scenario.hashrate;
+    }
+
+    void tick()
+    {
+        m_strategy->tick(Loop::get().now());
+        Loop::get().after(1000, m_token, [this]() { tick(); });
+    }
+
+    void setJob(IClient *client, const Job &job, bool donate)
+    {
+        const uint64_t now = Loop::get().now();
+
+        if (!donate) {
+            m_donate->update(client, job);
+        }
+
+        if (m_pending == (donate ? 1 : 0)) {
+            const uint64_t gap = now - m_switchAt;
+            uint64_t &sum      = donate ? m_report.switchInSum : m_report.switchOutSum;
+            uint64_t &max      = donate ? m_report.switchInMax : m_report.switchOutMax;
+
+            sum += gap;
+            max  = std::max(max, gap);
+            ++m_report.switches;
+            m_pending = -1;
+        }
+
+        // A new seed costs a RandomX rebuild before the first hash
+        if (!m_seed.empty() && job.seed() != m_seed) {
+            m_rebuildUntil  = now + m_scenario.rebuildMs;
+            m_rebuildSwitch = donate != m_donating;
+            ++(m_rebuildSwitch ? m_report.switchRebuilds : m_report.epochRebuilds);
+        }
+
+        m_seed     = job.seed();
+        m_donating = donate;
+    }
+
+    void advance(uint64_t from, uint64_t to)
+    {
+        const double hashrate = rate(from);
+
+        if (from < m_rebuildUntil) {
+            const uint64_t end = std::min(to, m_rebuildUntil);
+            if (m_rebuildSwitch) {
+                m_report.rebuild += hashrate * static_cast<double>(end - from) / 1000.0;
+            }
+            from = end;
+        }
+
+        const double hashes = hashrate * static_cast<double>(to - from) / 1000.0;
+        m_hashes += hashes;
+
+        if (!m_donating) {
+            m_report.user += hashes;
+        }
+        else if (pool().live > 0) {
+            m_report.donated += hashes;
+        }
+        else {
+            m_report.stale += hashes;
+        }
+    }
+
+    bool m_donating         = false;
+    bool m_rebuildSwitch    = false;
+    Buffer m_seed;
+    const Scenario &m_scenario;
+    Controller m_controller;
+    DonateStrategy *m_donate = nullptr;
+    double m_hashes         = 0.0;
+    double m_ledgerDonated  = 0.0;
+    double m_ledgerLast     = 0.0;
+    double m_ledgerUser     = 0.0;
+    int m_pending           = -1;
+    IStrategy *m_strategy   = nullptr;
+    Loop::Token m_token;
+    Report m_report;
+    uint64_t m_rebuildUntil = 0;
+    uint64_t m_switchAt     = 0;
+    UserStrategy m_user;
+};
+
+
+static Report run(const Scenario &scenario)
+{
+    Loop::get().reset(scenario.seed);
+    srand(static_cast<unsigned>(scenario.seed));
+
+    PoolModel &model = pool();
+    model            = scenario.pool;
+
+    bridge::donateLeadMs     = scenario.leadMs;
+    bridge::donateAccounting = scenario.accounting;
+    bridge::donateRoundMs    = XMRIG_DONATE_DEFAULT_ROUND_MS;
+
+    SimNetwork simNetwork(scenario);
+    network = &simNetwork;
+
+    const Report report = simNetwork.run();
+    network = nullptr;
+
+    return report;
+}
+
+
+static double lostPerSwitch(const Scenario &scenario, const Report &report)
+{
+    return report.switches ? (report.rebuild + report.stale) / scenario.hashrate / static_cast<double>(report.switches) : 0.0;
+}
+
+
+static void print(const Scenario &scenario, const Report &report)
+{
+    const uint64_t in  = report.switches ? report.switchInSum / std::max<uint64_t>(1, report.rounds) : 0;
+    const uint64_t out = report.switches ? report.switchOutSum / std::max<uint64_t>(1, report.rounds) : 0;
+
+    printf("%s: %s\n", scenario.name, scenario.description);
+    printf("  %u days, %" PRIu64 " rounds, donated %.3f%% of %.1f M hashes\n",
+           scenario.days, report.rounds, report.ratio(), (report.user + report.donated) / 1e6);
+    printf("  switch in avg %" PRIu64 " / max %" PRIu64 " ms, out avg %" PRIu64 " / max %" PRIu64 " ms\n",
+           in, report.switchInMax, out, report.switchOutMax);
+    printf("  lost %.2f hash-seconds per switch (%" PRIu64 " rebuilds, %.1f s stale), %" PRIu64 " epoch rebuilds\n",
+           lostPerSwitch(scenario, report), report.switchRebuilds, report.stale / scenario.hashrate, report.epochRebuilds);
+    printf("  %" PRIu64 " session attempts (%" PRIu64 " via proxy), %" PRIu64 " reconnects, %" PRIu64 " login failures, %" PRIu64 " drops\n",
+           report.pool.attempts, report.pool.proxyAttempts, report.pool.reconnects, report.pool.failures, report.pool.drops);
+}
+
+
+static bool check(const Scenario &scenario, const Report &report, const Report &replay)
+{
+    bool ok = true;
+    auto fail = [&ok](const char *what) {
+        printf("  FAIL: %s\n", what);
+        ok = false;
+    };
+
+    if (!(report == replay)) {
+        fail("second run with the same seed differs");
+    }
+    if (report.ratio() < scenario.minRatio || report.ratio() > scenario.maxRatio) {
+        fail("donation ratio out of bounds");
+    }
+    if (report.rounds < scenario.minRounds || report.rounds > scenario.maxRounds) {
+        fail("round count out of bounds");
+    }
+    if (report.switchInMax > scenario.maxSwitchMs || report.switchOutMax > scenario.maxSwitchMs) {
+        fail("switch gap too long");
+    }
+    if (lostPerSwitch(scenario, report) > scenario.maxLostPerSwitch) {
+        fail("too many hash-seconds lost per switch");
+    }
+    if (report.pool.reconnects > scenario.maxReconnects) {
+        fail("too many reconnects");
+    }
+    if (report.switchRebuilds > scenario.maxRebuilds) {
+        fail("switches rebuilt the RandomX dataset");
+    }
+
+    return ok;
+}
+
+
+static std::vector<Scenario> scenarios()
+{
+    std::vector<Scenario> list;
+
+    // Sunday afternoon: fast pool, nothing fails
+    {
+        Scenario s;
+        s.name          = "steady";
+        s.description   = "stable donation pool, wall-clock rounds";
+        s.minRounds     = 85;
+        s.maxRounds     = 115;
+        s.maxSwitchMs   = 0;
+        s.maxReconnects = 0;
+        list.push_back(s);
+    }
+
+    // Mobile network: slow logins, a third of them failing, drops every ~30 min
+    {
+        Scenario s;
+        s.name                  = "flaky";
+        s.description           = "slow donation pool, 30% login failures, drops";
+        s.pool.latencyMin       = 1000;
+        s.pool.latencyMax       = 8000;
+        s.pool.loginFailure     = 0.3;
+        s.pool.dropMean         = 30 * 60 * 1000;
+        s.minRatio              = 0.8;
+        s.maxRatio              = 1.2;
+        s.minRounds             = 80;
+        s.maxSwitchMs           = 60 * 1000;
+        s.maxLostPerSwitch      = 2.0;
+        list.push_back(s);
+    }
+
+    // Proxy-donate auto with a user pool that cannot forward the login:
+    // two failures, then the direct session (the failures == 2 path)
+    {
+        Scenario s;
+        s.name              = "proxy-fallback";
+        s.description       = "login through the user's pool fails, direct fallback";
+        s.proxy             = true;
+        s.pool.proxyFailure = 1.0;
+        s.minRounds         = 85;
+        s.maxRounds         = 115;
+        s.maxSwitchMs       = 0;
+        list.push_back(s);
+    }
+
+    // Donation pool's chain 15 min ahead: rounds near an epoch boundary
+    // wait for the user's seed instead of rebuilding twice
+    {
+        Scenario s;
+        s.name              = "epoch";
+        s.description       = "donation pool 15 min ahead across epoch boundaries";
+        s.days              = 28;
+        s.pool.seedSkew     = 15 * 60 * 1000;
+        s.minRounds         = 360;
+        s.maxRounds         = 440;
+        s.maxRebuilds       = 0;
+        list.push_back(s);
+    }
+
+    // Phone profile: full speed on the charger at night, throttled by day,
+    // paused for two hours
+    const std::vector<Window> phone = { { 8, 22, 0.25 }, { 22, 24, 0.0 } };
+    {
+        Scenario s;
+        s.name          = "throttled";
+        s.description   = "phone profile, wall-clock rounds";
+        s.profile       = phone;
+        s.minRatio      = 0.5;
+        s.maxRatio      = 1.5;
+        s.maxSwitchMs   = 0;
+        list.push_back(s);
+    }
+
+    {
+        Scenario s;
+        s.name          = "accounting";
+        s.description   = "phone profile, hash-accounted rounds";
+        s.profile       = phone;
+        s.accounting    = true;
+        s.minRatio      = 0.95;
+        s.maxRatio      = 1.05;
+        s.maxRounds     = 30;
+        s.maxSwitchMs   = 0;
+        list.push_back(s);
+    }
+
+    return list;
+}
+
+
+} // namespace sim
+
+
+namespace bridge {
+
+
+std::atomic<uint32_t> donateLeadMs{XMRIG_DONATE_DEFAULT_LEAD_MS};
+std::atomic<bool> donateAccounting{false};
+std::atomic<uint32_t> donateRoundMs{XMRIG_DONATE_DEFAULT_ROUND_MS};
+
+
+void onDonateSwitch(bool donate)
+{
+    sim::network->onSwitch(donate);
+}
+
+
+double donateDebt(bool donating, double fraction)
+{
+    return sim::network->debt(donating, fraction);
+}
+
+
+double currentHashrate()
+{
+    return sim::network->hashrate();
+}
+
+
+} // namespace bridge
+
+
+} // namespace xmrig
+
+
+int main(int argc, char **argv)
+{
+    using namespace xmrig::sim;
+
+    const char *only = nullptr;
+    uint32_t days    = 0;
+    uint64_t seed    = 0;
+    bool checks      = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        }
+        else if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--check") == 0) {
+            checks = true;
+        }
+        else if (strcmp(argv[i], "--list") == 0) {
+            for (const Scenario &scenario : scenarios()) {
+                printf("%-16s %s\n", scenario.name, scenario.description);
+            }
+            return 0;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--scenario <name>] [--days <n>] [--seed <n>] [--check] [--list]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok    = true;
+    bool found = false;
+
+    for (Scenario scenario : scenarios()) {
+        if (only && strcmp(only, scenario.name) != 0) {
+            continue;
+        }
+        found = true;
+
+        // Bounds are tuned to the default length and seed
+        if (days) {
+            scenario.days = days;
+        }
+        if (seed) {
+            scenario.seed = seed;
+        }
+
+        const Report report = run(scenario);
+        print(scenario, report);
+
+        if (checks) {
+            ok = check(scenario, report, run(scenario)) && ok;
+        }
+    }
+
+    if (!found) {
+        fprintf(stderr, "unknown scenario '%s'\n", only);
+        return 2;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+#include "xmrig_sim.h"
+
+#include <cmath>
+#include <string>
+
+namespace xmrig {
+
+
+sim::Loop &sim::Loop::get()
+{
+    static Loop loop;
+    return loop;
+}
+
+
+void sim::Loop::reset(uint64_t seed)
+{
+    m_queue = {};
+    m_now   = 0;
+    m_order = 0;
+    m_rng.seed(seed);
+}
+
+
+void sim::Loop::at(uint64_t time, const Token &token, std::function<void()> fn)
+{
+    m_queue.push({ time < m_now ? m_now : time, m_order++, token, std::move(fn) });
+}
+
+
+void sim::Loop::run(uint64_t until, const std::function<void(uint64_t, uint64_t)> &onAdvance)
+{
+    while (!m_queue.empty() && m_queue.top().time <= until) {
+        Event event = m_queue.top();
+        m_queue.pop();
+
+        if (event.token.expired()) {
+            continue;
+        }
+
+        if (event.time > m_now) {
+            onAdvance(m_now, event.time);
+            m_now = event.time;
+        }
+
+        event.fn();
+    }
+
+    if (until > m_now) {
+        onAdvance(m_now, until);
+        m_now = until;
+    }
+}
+
+
+// Own conversions rather than <random> distributions, whose output differs
+// between standard libraries: a seed replays the same run everywhere
+double sim::Loop::uniform(double min, double max)
+{
+    return min + (max - min) * (static_cast<double>(m_rng() >> 11) * 0x1.0p-53);
+}
+
+
+bool sim::Loop::chance(double p)
+{
+    return p > 0.0 && uniform(0.0, 1.0) < p;
+}
+
+
+uint64_t sim::Loop::exponential(double mean)
+{
+    return static_cast<uint64_t>(-mean * std::log(1.0 - uniform(0.0, 1.0)));
+}
+
+
+sim::PoolModel &sim::pool()
+{
+    static PoolModel model;
+    return model;
+}
+
+
+Job sim::PoolModel::job(uint64_t now, uint64_t skew)
+{
+    const uint64_t epoch = (now + skew) / kEpoch;
+
+    char seed[32] = {};
+    for (size_t i = 0; i < sizeof(epoch); ++i) {
+        seed[i] = static_cast<char>((epoch + 1) >> (i * 8));
+    }
+
+    return { Algorithm::RX_0, Buffer(seed, sizeof(seed)), 3000000 + (now + skew) / kBlockTime, 300000 };
+}
+
+
+Pool::Pool(const char *host, uint16_t port, const char *, const char *password, const char *spendSecretKey, int, bool, bool, Mode) :
+    m_host(host),
+    m_password(password),
+    m_spendSecretKey(spendSecretKey),
+    m_url((std::string(host) + ":" + std::to_string(port)).c_str()),
+    m_port(port)
+{
+}
+
+
+void Timer::start(uint64_t timeout, uint64_t repeat)
+{
+    m_token = std::make_shared<int>();
+
+    // Weak, the lambda must not keep its own token alive
+    const std::weak_ptr<int> token = m_token;
+    sim::Loop::get().after(timeout, m_token, [this, token, repeat]() {
+        m_listener->onTimer(this);
+
+        if (repeat && m_token == token.lock()) {
+            start(repeat, repeat);
+        }
+    });
+}
+
+
+void Timer::stop()
+{
+    m_token.reset();
+}
+
+
+Client::Client(int id, const char *, IClientListener *listener) :
+    m_id(id),
+    m_listener(listener)
+{
+}
+
+
+Client::~Client()
+{
+    if (m_connected) {
+        --sim::pool().live;
+    }
+}
+
+
+void Client::connect()
+{
+    if (m_connected || m_connecting) {
+        return;
+    }
+
+    auto &pool   = sim::pool();
+    auto &loop   = sim::Loop::get();
+    m_connecting = true;
+    m_token      = std::make_shared<int>();
+
+    ++pool.attempts;
+    if (m_id < 0) {
+        ++pool.proxyAttempts;
+    }
+
+    loop.after(static_cast<uint64_t>(loop.uniform(static_cast<double>(pool.latencyMin), static_cast<double>(pool.latencyMax))), m_token, [this]() {
+        auto &pool   = sim::pool();
+        m_connecting = false;
+
+        rapidjson::Document doc;
+        rapidjson::Value params;
+        m_listener->onLogin(this, doc, params);
+
+        if (sim::Loop::get().chance(m_id < 0 ? pool.proxyFailure : pool.loginFailure)) {
+            ++pool.failures;
+            return close();
+        }
+
+        login();
+    });
+}
+
+
+void Client::deleteLater()
+{
+    if (m_connected) {
+        m_connected = false;
+        --sim::pool().live;
+    }
+
+    m_token.reset();
+    m_listener = nullptr;
+
+    auto token = std::make_shared<int>();
+    sim::Loop::get().after(0, token, [this, token]() { delete this; });
+}
+
+
+void Client::disconnect()
+{
+    const bool connected = m_connected;
+
+    m_token.reset();
+    m_connecting = false;
+    m_failures   = 0;
+
+    if (connected) {
+        m_connected = false;
+        --sim::pool().live;
+        m_listener->onClose(this, -1);
+    }
+}
+
+
+void Client::close()
+{
+    if (m_connected) {
+        m_connected = false;
+        --sim::pool().live;
+    }
+
+    m_listener->onClose(this, ++m_failures);
+
+    // Still wanted (not deleted or stopped from onClose): drop the session's
+    // events and retry like Client
+    if (m_token) {
+        m_token = std::make_shared<int>();
+        ++sim::pool().reconnects;
+        sim::Loop::get().after(m_retryPause, m_token, [this]() {
+            m_token.reset();
+            connect();
+        });
+    }
+}
+
+
+void Client::login()
+{
+    auto &pool  = sim::pool();
+    auto &loop  = sim::Loop::get();
+    m_connected = true;
+    m_failures  = 0;
+    m_job       = sim::PoolModel::job(loop.now(), pool.seedSkew);
+    ++pool.live;
+
+    m_listener->onLoginSuccess(this);
+    if (!m_token) {
+        return;
+    }
+    m_listener->onJobReceived(this, m_job, rapidjson::Value());
+
+    // A job per block, a drop after an exponentially distributed lifetime
+    nextBlock(m_token);
+
+    if (pool.dropMean > 0) {
+        loop.after(loop.exponential(static_cast<double>(pool.dropMean)), m_token, [this]() {
+            ++sim::pool().drops;
+            close();
+        });
+    }
+}
+
+
+void Client::nextBlock(const sim::Loop::Token &token)
+{
+    auto &loop          = sim::Loop::get();
+    const uint64_t skew = sim::pool().seedSkew;
+    const uint64_t next = ((loop.now() + skew) / sim::PoolModel::kBlockTime + 1) * sim::PoolModel::kBlockTime - skew;
+
+    loop.at(next, token, [this, weak = std::weak_ptr<int>(token)]() {
+        m_job = sim::PoolModel::job(sim::Loop::get().now(), sim::pool().seedSkew);
+        m_listener->onJobReceived(this, m_job, rapidjson::Value());
+
+        const sim::Loop::Token token = weak.lock();
+        if (token && m_token == token) {
+            nextBlock(token);
+        }
+    });
+}
+
+
+SinglePoolStrategy::SinglePoolStrategy(const Pool &pool, int retryPause, int, IStrategyListener *listener, bool) :
+    m_client(new Client(0, Platform::userAgent(), this)),
+    m_listener(listener)
+{
+    m_client->setPool(pool);
+    m_client->setRetryPause(static_cast<uint64_t>(retryPause) * 1000);
+}
+
+
+SinglePoolStrategy::~SinglePoolStrategy()
+{
+    delete m_client;
+}
+
+
+void SinglePoolStrategy::connect()
+{
+    m_client->connect();
+}
+
+
+void SinglePoolStrategy::resume()
+{
+    if (!isActive()) {
+        return;
+    }
+
+    m_listener->onJob(this, m_client, m_client->job(), rapidjson::Value());
+}
+
+
+void SinglePoolStrategy::stop()
+{
+    m_client->disconnect();
+}
+
+
+void SinglePoolStrategy::onClose(IClient *, int)
+{
+    if (!isActive()) {
+        return;
+    }
+
+    m_active = false;
+    m_listener->onPause(this);
+}
+
+
+void SinglePoolStrategy::onJobReceived(IClient *client, const Job &job, const rapidjson::Value &params)
+{
+    m_listener->onJob(this, client, job, params);
+}
+
+
+void SinglePoolStrategy::onLogin(IClient *client, rapidjson::Document &doc, rapidjson::Value &params)
+{
+    m_listener->onLogin(this, client, doc, params);
+}
+
+
+void SinglePoolStrategy::onLoginSuccess(IClient *client)
+{
+    m_active = true;
+    m_listener->onActive(this, client);
+}
+
+
+void SinglePoolStrategy::onVerifyAlgorithm(const IClient *client, const Algorithm &algorithm, bool *ok)
+{
+    m_listener->onVerifyAlgorithm(this, client, algorithm, ok);
+}
+
+
+} // namespace xmrig
@@ -0,0 +1,531 @@
+/**
+ * DonateStrategy simulation - stand-ins for the XMRig API
+ *
+ * Just enough of XMRig for DonateStrategy.cpp to compile unchanged: the
+ * CMakeLists generates a forwarding header at every XMRig include path the
+ * strategy uses, all of them pointing here.
+ *
+ * Everything runs on one virtual clock (sim::Loop). Timers, pool sessions
+ * and the miner are events on that clock, so a simulated week takes well
+ * under a second and a given RNG seed always replays the same run.
+ */
+
+#ifndef XMRIG_SIM_H
+#define XMRIG_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+#define XMRIG_DISABLE_COPY_MOVE(X) \
+    X(const X &other) = delete; \
+    X(X &&other) = delete; \
+    X &operator=(const X &other) = delete; \
+    X &operator=(X &&other) = delete;
+
+#define XMRIG_DISABLE_COPY_MOVE_DEFAULT(X) \
+    X() = delete; \
+    XMRIG_DISABLE_COPY_MOVE(X)
+
+
+// rapidjson: DonateStrategy only builds login params, which the stand-in
+// pool does not read. Same signatures, no storage.
+namespace rapidjson {
+
+
+enum Type { kNullType, kObjectType, kArrayType };
+
+class MemoryPoolAllocator {};
+
+struct GenericStringRef
+{
+    const char *s;
+};
+
+inline GenericStringRef StringRef(const char *s) { return { s }; }
+
+
+class Value
+{
+public:
+    Value() = default;
+    explicit Value(Type) {}
+    Value(const char *, MemoryPoolAllocator &) {}
+
+    template<typename T> Value &AddMember(const char *, T &&, MemoryPoolAllocator &) { return *this; }
+    template<typename T> Value &PushBack(T &&, MemoryPoolAllocator &)                { return *this; }
+};
+
+
+class Document : public Value
+{
+public:
+    inline MemoryPoolAllocator &GetAllocator() { return m_allocator; }
+
+private:
+    MemoryPoolAllocator m_allocator;
+};
+
+
+} // namespace rapidjson
+
+
+namespace xmrig {
+
+
+class IClient;
+class IStrategy;
+class ITimerListener;
+
+
+namespace sim {
+
+
+/**
+ * Virtual clock and event queue. Events carry a weak token; an object
+ * cancels everything it scheduled by dropping its token.
+ */
+class Loop
+{
+public:
+    using Token = std::shared_ptr<int>;
+
+    static Loop &get();
+
+    inline uint64_t now() const { return m_now; }
+    inline std::mt19937_64 &rng() { return m_rng; }
+
+    void reset(uint64_t seed);
+    void at(uint64_t time, const Token &token, std::function<void()> fn);
+    inline void after(uint64_t delay, const Token &token, std::function<void()> fn) { at(m_now + delay, token, std::move(fn)); }
+
+    // Runs events up to and including `until`; onAdvance(from, to) sees every
+    // stretch of time between two events, before the later one runs
+    void run(uint64_t until, const std::function<void(uint64_t, uint64_t)> &onAdvance);
+
+    double uniform(double min, double max);
+    bool chance(double p);
+    uint64_t exponential(double mean);
+
+private:
+    struct Event
+    {
+        uint64_t time;
+        uint64_t order;
+        std::weak_ptr<int> token;
+        std::function<void()> fn;
+
+        inline bool operator>(const Event &other) const { return time != other.time ? time > other.time : order > other.order; }
+    };
+
+    std::mt19937_64 m_rng;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_queue;
+    uint64_t m_now   = 0;
+    uint64_t m_order = 0;
+};
+
+
+} // namespace sim
+
+
+class String
+{
+public:
+    String() = default;
+    String(const char *str) : m_data(str ? str : "") {}
+
+    inline bool isEmpty() const                 { return m_data.empty(); }
+    inline const char *data() const             { return m_data.c_str(); }
+    inline operator const char *() const        { return m_data.c_str(); }
+    inline rapidjson::Value toJSON() const      { return {}; }
+
+private:
+    std::string m_data;
+};
+
+
+class Buffer
+{
+public:
+    Buffer() = default;
+    Buffer(const char *data, size_t size) : m_data(data, data + size) {}
+
+    inline bool empty() const                           { return m_data.empty(); }
+    inline const char *data() const                     { return m_data.data(); }
+    inline size_t size() const                          { return m_data.size(); }
+    inline bool operator==(const Buffer &other) const   { return m_data == other.m_data; }
+    inline bool operator!=(const Buffer &other) const   { return m_data != other.m_data; }
+
+private:
+    std::vector<char> m_data;
+};
+
+
+class Algorithm
+{
+public:
+    enum Id { INVALID, RX_0, RX_WOW };
+
+    Algorithm(Id id = INVALID) : m_id(id) {}
+
+    inline const char *name() const                         { return m_id == RX_0 ? "rx/0" : m_id == RX_WOW ? "rx/wow" : "invalid"; }
+    inline bool operator==(const Algorithm &other) const    { return m_id == other.m_id; }
+    inline bool operator!=(const Algorithm &other) const    { return m_id != other.m_id; }
+
+private:
+    Id m_id;
+};
+
+
+class ProxyUrl
+{
+public:
+    inline bool isValid() const { return false; }
+};
+
+
+class Pool
+{
+public:
+    enum Mode { MODE_POOL, MODE_DAEMON, MODE_SELF_SELECT, MODE_AUTO_ETH, MODE_BENCHMARK };
+
+    Pool() = default;
+    Pool(const char *host, uint16_t port, const char *user = nullptr, const char *password = nullptr, const char *spendSecretKey = nullptr,
+         int keepAlive = 0, bool nicehash = false, bool tls = false, Mode mode = MODE_POOL);
+
+    inline const Algorithm &algorithm() const   { return m_algorithm; }
+    inline const ProxyUrl &proxy() const        { return m_proxy; }
+    inline const String &host() const           { return m_host; }
+    inline const String &password() const       { return m_password; }
+    inline const String &spendSecretKey() const { return m_spendSecretKey; }
+    inline const String &url() const            { return m_url; }
+    inline uint16_t port() const                { return m_port; }
+    inline void setAlgo(const Algorithm &algo)  { m_algorithm = algo; }
+    inline void setProxy(const ProxyUrl &proxy) { m_proxy = proxy; }
+
+private:
+    Algorithm m_algorithm;
+    ProxyUrl m_proxy;
+    String m_host;
+    String m_password;
+    String m_spendSecretKey;
+    String m_url;
+    uint16_t m_port = 0;
+};
+
+
+class Job
+{
+public:
+    Job() = default;
+    Job(const Algorithm &algorithm, const Buffer &seed, uint64_t height, uint64_t diff) :
+        m_algorithm(algorithm), m_seed(seed), m_diff(diff), m_height(height) {}
+
+    inline const Algorithm &algorithm() const   { return m_algorithm; }
+    inline const Buffer &seed() const           { return m_seed; }
+    inline uint64_t diff() const                { return m_diff; }
+    inline uint64_t height() const              { return m_height; }
+
+private:
+    Algorithm m_algorithm;
+    Buffer m_seed;
+    uint64_t m_diff   = 0;
+    uint64_t m_height = 0;
+};
+
+
+class JobResult {};
+class SubmitResult {};
+
+
+class IClient
+{
+public:
+    enum Extension { EXT_ALGO, EXT_NICEHASH, EXT_CONNECT, EXT_TLS, EXT_KEEPALIVE, EXT_MAX };
+
+    virtual ~IClient() = default;
+
+    virtual bool hasExtension(Extension extension) const = 0;
+    virtual bool isTLS() const                           = 0;
+    virtual const String &ip() const                     = 0;
+    virtual const Job &job() const                       = 0;
+    virtual const Pool &pool() const                     = 0;
+    virtual int64_t submit(const JobResult &result)      = 0;
+    virtual void connect()                               = 0;
+    virtual void deleteLater()                           = 0;
+    virtual void setPool(const Pool &pool)               = 0;
+    virtual void setQuiet(bool quiet)                    = 0;
+    virtual void tick(uint64_t now)                      = 0;
+};
+
+
+class IClientListener
+{
+public:
+    virtual ~IClientListener() = default;
+
+    virtual void onClose(IClient *client, int failures)                                                            = 0;
+    virtual void onJobReceived(IClient *client, const Job &job, const rapidjson::Value &params)                    = 0;
+    virtual void onLogin(IClient *client, rapidjson::Document &doc, rapidjson::Value &params)                      = 0;
+    virtual void onLoginSuccess(IClient *client)                                                                   = 0;
+    virtual void onResultAccepted(IClient *client, const SubmitResult &result, const char *error)                  = 0;
+    virtual void onVerifyAlgorithm(const IClient *client, const Algorithm &algorithm, bool *ok)                    = 0;
+};
+
+
+class IStrategy
+{
+public:
+    virtual ~IStrategy() = default;
+
+    virtual bool isActive() const                   = 0;
+    virtual IClient *client() const                 = 0;
+    virtual int64_t submit(const JobResult &result) = 0;
+    virtual void connect()                          = 0;
+    virtual void resume()                           = 0;
+    virtual void setAlgo(const Algorithm &algo)     = 0;
+    virtual void setProxy(const ProxyUrl &proxy)    = 0;
+    virtual void stop()                             = 0;
+    virtual void tick(uint64_t now)                 = 0;
+};
+
+
+class IStrategyListener
+{
+public:
+    virtual ~IStrategyListener() = default;
+
+    virtual void onActive(IStrategy *strategy, IClient *client)                                                        = 0;
+    virtual void onJob(IStrategy *strategy, IClient *client, const Job &job, const rapidjson::Value &params)           = 0;
+    virtual void onLogin(IStrategy *strategy, IClient *client, rapidjson::Document &doc, rapidjson::Value &params)     = 0;
+    virtual void onPause(IStrategy *strategy)                                                                          = 0;
+    virtual void onResultAccepted(IStrategy *strategy, IClient *client, const SubmitResult &result, const char *error) = 0;
+    virtual void onVerifyAlgorithm(IStrategy *strategy, const IClient *client, const Algorithm &algorithm, bool *ok)   = 0;
+};
+
+
+class Timer;
+
+class ITimerListener
+{
+public:
+    virtual ~ITimerListener() = default;
+
+    virtual void onTimer(const Timer *timer) = 0;
+};
+
+
+class Timer
+{
+public:
+    explicit Timer(ITimerListener *listener) : m_listener(listener) {}
+
+    void start(uint64_t timeout, uint64_t repeat);
+    void stop();
+
+private:
+    ITimerListener *m_listener;
+    sim::Loop::Token m_token;
+};
+
+
+/**
+ * Pool session on the stand-in pool (see sim::PoolModel): connect latency,
+ * login failures, disconnects and reconnects after a retry pause, like
+ * XMRig's Client. The failure count handed to onClose() follows Client.
+ */
+class Client : public IClient
+{
+public:
+    Client(int id, const char *agent, IClientListener *listener);
+    ~Client() override;
+
+    inline bool hasExtension(Extension) const override  { return false; }
+    inline bool isTLS() const override                  { return false; }
+    inline const String &ip() const override            { return m_ip; }
+    inline const Job &job() const override              { return m_job; }
+    inline const Pool &pool() const override            { return m_pool; }
+    inline int64_t submit(const JobResult &) override   { return -1; }
+    inline void setPool(const Pool &pool) override      { m_pool = pool; }
+    inline void setQuiet(bool) override                 {}
+    inline void setRetryPause(uint64_t ms)              { m_retryPause = ms; }
+    inline void tick(uint64_t) override                 {}
+    inline bool isConnected() const                     { return m_connected; }
+
+    void connect() override;
+    void deleteLater() override;
+    void disconnect();
+
+private:
+    void close();
+    void login();
+    void nextBlock(const sim::Loop::Token &token);
+
+    bool m_connected     = false;
+    bool m_connecting    = false;
+    const int m_id;
+    int m_failures       = 0;
+    IClientListener *m_listener;
+    Job m_job;
+    Pool m_pool;
+    sim::Loop::Token m_token;
+    String m_ip          = "127.0.0.1";
+    uint64_t m_retryPause = 5000;
+};
+
+
+class SinglePoolStrategy : public IStrategy, public IClientListener
+{
+public:
+    SinglePoolStrategy(const Pool &pool, int retryPause, int retries, IStrategyListener *listener, bool quiet = false);
+    ~SinglePoolStrategy() override;
+
+    inline bool isActive() const override                                                   { return m_active; }
+    inline IClient *client() const override                                                 { return m_client; }
+    inline int64_t submit(const JobResult &result) override                                 { return m_client->submit(result); }
+    inline void setAlgo(const Algorithm &) override                                         {}
+    inline void setProxy(const ProxyUrl &) override                                         {}
+    inline void tick(uint64_t now) override                                                 { m_client->tick(now); }
+    inline void onResultAccepted(IClient *, const SubmitResult &, const char *) override    {}
+
+    void connect() override;
+    void resume() override;
+    void stop() override;
+
+    void onClose(IClient *client, int failures) override;
+    void onJobReceived(IClient *client, const Job &job, const rapidjson::Value &params) override;
+    void onLogin(IClient *client, rapidjson::Document &doc, rapidjson::Value &params) override;
+    void onLoginSuccess(IClient *client) override;
+    void onVerifyAlgorithm(const IClient *client, const Algorithm &algorithm, bool *ok) override;
+
+private:
+    bool m_active = false;
+    Client *m_client;
+    IStrategyListener *m_listener;
+};
+
+
+// DonateStrategy only builds one without TLS; first pool only
+class FailoverStrategy : public SinglePoolStrategy
+{
+public:
+    FailoverStrategy(const std::vector<Pool> &pools, int retryPause, int retries, IStrategyListener *listener, bool quiet = false) :
+        SinglePoolStrategy(pools.front(), retryPause, retries, listener, quiet) {}
+};
+
+
+class Pools
+{
+public:
+    enum ProxyDonate { PROXY_DONATE_NONE, PROXY_DONATE_AUTO, PROXY_DONATE_ALWAYS };
+
+    inline int donateLevel() const          { return m_donateLevel; }
+    inline ProxyDonate proxyDonate() const  { return m_proxyDonate; }
+
+    int m_donateLevel           = 1;
+    ProxyDonate m_proxyDonate   = PROXY_DONATE_AUTO;
+};
+
+
+class Config
+{
+public:
+    inline const Pools &pools() const { return m_pools; }
+
+    Pools m_pools;
+};
+
+
+class Miner
+{
+public:
+    inline const std::vector<Algorithm> &algorithms() const { return m_algorithms; }
+
+    std::vector<Algorithm> m_algorithms = { Algorithm::RX_0, Algorithm::RX_WOW };
+};
+
+
+class Network
+{
+public:
+    virtual ~Network() = default;
+
+    virtual IStrategy *strategy() const = 0;
+};
+
+
+class Controller
+{
+public:
+    inline Config *config()     { return &m_config; }
+    inline Miner *miner()       { return &m_miner; }
+    inline Network *network()   { return m_network; }
+
+    Config m_config;
+    Miner m_miner;
+    Network *m_network = nullptr;
+};
+
+
+namespace Cvt {
+
+inline rapidjson::Value toHex(const Buffer &, rapidjson::Document &) { return {}; }
+
+} // namespace Cvt
+
+
+namespace Platform {
+
+inline const char *userAgent() { return "xmrig-sim"; }
+
+} // namespace Platform
+
+
+namespace sim {
+
+
+/**
+ * The stand-in pool both the donation sessions and the proxy talk to.
+ * Seeds follow the RandomX epoch (2048 blocks of 2 minutes) on the user's
+ * clock; the donation pool's chain runs seedSkew ms ahead of it.
+ */
+struct PoolModel
+{
+    static constexpr uint64_t kBlockTime = 120 * 1000;
+    static constexpr uint64_t kEpoch     = 2048 * kBlockTime;
+
+    uint64_t latencyMin  = 200;     // connect + login round trip
+    uint64_t latencyMax  = 600;
+    double loginFailure  = 0.0;     // per attempt
+    double proxyFailure  = 0.0;     // per attempt through the user's proxy
+    uint64_t dropMean    = 0;       // mean session lifetime, 0 = never drops
+    uint64_t seedSkew    = 0;
+
+    // State and counters, reset with the scenario
+    uint32_t live           = 0;    // sessions logged in
+    uint64_t attempts       = 0;
+    uint64_t proxyAttempts  = 0;
+    uint64_t reconnects     = 0;    // retries after a failed login or a drop
+    uint64_t failures       = 0;
+    uint64_t drops          = 0;
+
+    static Job job(uint64_t now, uint64_t skew = 0);
+};
+
+PoolModel &pool();
+
+
+} // namespace sim
+
+
+} // namespace xmrig
+
+
+#endif /* XMRIG_SIM_H */